@@ -0,0 +1,345 @@
+/** @file *//********************************************************************************************************
+
+                                                 ActivationCache.cpp
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/ActivationCache.cpp#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#include "ActivationCache.h"
+
+#include "CacheFile.h"
+#include "Fnv1a.h"
+#include "MultilayerFeedForward.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#if !defined( _WIN32 )
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//! The signature at the start of a cache file.
+static char const	CACHE_SIGNATURE[]	= "NeuralNet activation cache 1";
+
+//! The number of samples computed and written together by Build().
+static int const	BLOCK_SIZE			= 4096;
+
+//! The number of samples in a tile processed by one thread.
+static int const	TILE_SIZE			= 16;
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+ActivationCache::ActivationCache()
+	: m_pMapping( 0 ),
+	m_mappingSize( 0 ),
+	m_paValues( 0 ),
+	m_nSamples( 0 ),
+	m_width( 0 )
+{
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+ActivationCache::~ActivationCache()
+{
+	Close();
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The samples are evaluated in parallel if there is a thread pool. If a file is given, the outputs are written to it
+//! a block at a time, so a data set whose outputs do not fit in memory can be cached. The file is written under a
+//! temporary name and renamed when it is complete.
+//!
+//! @param	net		The net. Only its hidden layer is used.
+//! @param	aInputs	The inputs of the data set.
+//! @param	path	The path of the file to write, or an empty string to keep the outputs in memory.
+//! @param	pPool	The thread pool used to evaluate the samples (or 0 if none).
+//!
+//! @return		True if the outputs were computed (and written). If the file could not be written, the cache is empty.
+
+bool ActivationCache::Build( MultilayerFeedForward const & net,
+							 NeuralNet::InputBatch const & aInputs,
+							 std::string const & path /* = std::string()*/,
+							 ThreadPool * pPool /* = 0*/ )
+{
+	Close();
+
+	if ( !path.empty() )
+	{
+		return Write( net, aInputs, path, pPool ) && Open( net, aInputs, path );
+	}
+
+	m_nSamples	= (int)aInputs.size();
+	m_width		= net.GetHiddenCount();
+
+	m_aValues.resize( (size_t)m_nSamples * m_width );
+	Compute( net, aInputs, 0, m_nSamples, m_aValues.data(), pPool );
+
+	m_paValues = m_aValues.data();
+
+	return true;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The file is mapped into memory, so only the parts that are used are read, and they are shared with other processes
+//! using the same file.
+//!
+//! @param	net		The net. The file must have been built for a net with the same hidden layer.
+//! @param	aInputs	The inputs of the data set. The file must have been built for the same inputs.
+//! @param	path	The path of the file.
+//!
+//! @return		True if the file was opened. If not (for example, if it does not exist, is incomplete, or was built for
+//!				a different hidden layer or data set), the cache is empty.
+
+bool ActivationCache::Open( MultilayerFeedForward const & net,
+							NeuralNet::InputBatch const & aInputs,
+							std::string const & path )
+{
+	Close();
+
+	uint64_t const		fingerprint	= Fingerprint( net, aInputs );
+	int const			width		= net.GetHiddenCount();
+	CacheFile::Header	header;
+
+#if defined( _WIN32 )
+
+	// Memory-mapped files are not supported on this platform, so the file is read into memory.
+
+	std::ifstream	in( path, std::ios::binary | std::ios::ate );
+
+	if ( !in )
+	{
+		return false;
+	}
+
+	uint64_t const	size	= (uint64_t)in.tellg();
+
+	in.seekg( 0 );
+	if ( size < sizeof( header ) ||
+		 !in.read( reinterpret_cast< char * >( &header ), sizeof( header ) ) ||
+		 !CacheFile::IsValid( header, CACHE_SIGNATURE, fingerprint, width, size ) )
+	{
+		return false;
+	}
+
+	m_aValues.resize( (size_t)( header.nSamples * header.width ) );
+	if ( !in.read( reinterpret_cast< char * >( m_aValues.data() ), m_aValues.size() * sizeof( float ) ) )
+	{
+		m_aValues.clear();
+		return false;
+	}
+
+	m_paValues = m_aValues.data();
+
+#else // defined( _WIN32 )
+
+	int const	fd	= open( path.c_str(), O_RDONLY );
+
+	if ( fd < 0 )
+	{
+		return false;
+	}
+
+	struct stat	status;
+	void *		pMapping	= MAP_FAILED;
+
+	if ( fstat( fd, &status ) == 0 && (uint64_t)status.st_size >= sizeof( header ) )
+	{
+		pMapping = mmap( 0, (size_t)status.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+	}
+
+	close( fd );	// The mapping remains valid after the file is closed
+
+	if ( pMapping == MAP_FAILED )
+	{
+		return false;
+	}
+
+	std::memcpy( &header, pMapping, sizeof( header ) );
+
+	if ( !CacheFile::IsValid( header, CACHE_SIGNATURE, fingerprint, width, (uint64_t)status.st_size ) )
+	{
+		munmap( pMapping, (size_t)status.st_size );
+		return false;
+	}
+
+	m_pMapping		= pMapping;
+	m_mappingSize	= (size_t)status.st_size;
+	m_paValues		= reinterpret_cast< float const * >( static_cast< char const * >( pMapping ) + sizeof( header ) );
+
+#endif // defined( _WIN32 )
+
+	m_nSamples	= (int)header.nSamples;
+	m_width		= width;
+
+	return true;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+void ActivationCache::Close()
+{
+#if !defined( _WIN32 )
+	if ( m_pMapping != 0 )
+	{
+		munmap( m_pMapping, m_mappingSize );
+	}
+#endif
+
+	std::vector< float >().swap( m_aValues );
+	m_pMapping		= 0;
+	m_mappingSize	= 0;
+	m_paValues		= 0;
+	m_nSamples		= 0;
+	m_width			= 0;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	net		The net.
+//! @param	aInputs	The inputs of the data set.
+//!
+//! @return		The 64-bit FNV-1a hash of the number of inputs, the number of hidden units, the hidden weights, the
+//!				number of samples and the inputs.
+
+uint64_t ActivationCache::Fingerprint( MultilayerFeedForward const & net, NeuralNet::InputBatch const & aInputs )
+{
+	int const				nInputs		= net.GetInputCount();
+	int const				nHidden		= net.GetHiddenCount();
+	uint64_t const			nSamples	= aInputs.size();
+	Neuron::WeightVector	aWeights	= net.GetWeights();		// The hidden units come first
+	Fnv1a					hash;
+
+	aWeights.resize( (size_t)nInputs * nHidden );
+
+	hash.Add( &nInputs, sizeof( nInputs ) );
+	hash.Add( &nHidden, sizeof( nHidden ) );
+	hash.Add( aWeights.data(), aWeights.size() * sizeof( float ) );
+	hash.Add( &nSamples, sizeof( nSamples ) );
+
+	for ( size_t i = 0; i < aInputs.size(); i++ )
+	{
+		hash.Add( aInputs[i].data(), aInputs[i].size() * sizeof( float ) );
+	}
+
+	return hash.GetValue();
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	net			The net.
+//! @param	aInputs		The inputs of the data set.
+//! @param	first		The first sample.
+//! @param	last		The sample after the last sample.
+//! @param	paValues	Where to store the outputs. The outputs of sample @a first are stored first.
+//! @param	pPool		The thread pool used to evaluate the samples (or 0 if none).
+
+void ActivationCache::Compute( MultilayerFeedForward const & net,
+							   NeuralNet::InputBatch const & aInputs,
+							   int first,
+							   int last,
+							   float * paValues,
+							   ThreadPool * pPool )
+{
+	int const	width	= net.GetHiddenCount();
+
+	auto const	computeSamples	= [&] ( int begin, int end )
+	{
+		NeuralNet::OutputVector	aHiddenOutputs;
+
+		for ( int i = begin; i < end; i++ )
+		{
+			net.EvaluateHidden( aInputs[first + i], aHiddenOutputs );
+			std::copy( aHiddenOutputs.begin(), aHiddenOutputs.end(), paValues + (size_t)i * width );
+		}
+	};
+
+	if ( pPool != 0 )
+	{
+		pPool->ParallelFor( last - first, TILE_SIZE, computeSamples );
+	}
+	else
+	{
+		computeSamples( 0, last - first );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The file is written with a CacheFile, so an incomplete file is never mistaken for a complete one.
+//!
+//! @param	net			The net.
+//! @param	aInputs		The inputs of the data set.
+//! @param	path		The path of the file.
+//! @param	pPool		The thread pool used to evaluate the samples (or 0 if none).
+//!
+//! @return		True if the file was written.
+
+bool ActivationCache::Write( MultilayerFeedForward const & net,
+							 NeuralNet::InputBatch const & aInputs,
+							 std::string const & path,
+							 ThreadPool * pPool )
+{
+	int const				nSamples	= (int)aInputs.size();
+	int const				width		= net.GetHiddenCount();
+	CacheFile				file;
+	std::vector< float >	aBlock;
+
+	if ( !file.Create( path, CACHE_SIGNATURE, Fingerprint( net, aInputs ), nSamples, width ) )
+	{
+		return false;
+	}
+
+	for ( int first = 0; first < nSamples; first += BLOCK_SIZE )
+	{
+		int const		last	= std::min( first + BLOCK_SIZE, nSamples );
+		size_t const	size	= (size_t)( last - first ) * width;
+
+		aBlock.resize( size );
+		Compute( net, aInputs, first, last, aBlock.data(), pPool );
+
+		if ( !file.Write( aBlock.data(), size ) )
+		{
+			return false;
+		}
+	}
+
+	return file.Commit();
+}
@@ -0,0 +1,428 @@
+/** @file *//********************************************************************************************************
+
+                                                    Autotuner.cpp
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/Autotuner.cpp#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#include "Autotuner.h"
+
+#include "Neuron.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <sstream>
+
+//! The first line of a cache file.
+static char const	CACHE_SIGNATURE[]	= "NeuralNet kernel tuning cache 1";
+
+//! The minimum time in seconds of a timed run of a configuration.
+static double const	MIN_RUN_TIME		= 1.e-3;
+
+//! The number of timed runs of each configuration. The fastest run is used.
+static int const	RUNS				= 3;
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	f	The function to time.
+//!
+//! @return		The time in seconds for one call of @a f in the fastest run.
+
+static double Time( std::function< void () > const & f )
+{
+	typedef std::chrono::steady_clock	Clock;
+
+	f();	// Warm the caches
+
+	double	best	= 0.;
+
+	for ( int r = 0; r < RUNS; r++ )
+	{
+		int		nCalls	= 0;
+		double	elapsed	= 0.;
+
+		Clock::time_point const	start	= Clock::now();
+		do
+		{
+			f();
+			++nCalls;
+			elapsed = std::chrono::duration< double >( Clock::now() - start ).count();
+		} while ( elapsed < MIN_RUN_TIME );
+
+		double const	t	= elapsed / nCalls;
+
+		if ( r == 0 || t < best )
+		{
+			best = t;
+		}
+	}
+
+	return best;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	b	The shape to compare with.
+//!
+//! @return		True if this shape is ordered before @a b.
+
+bool Autotuner::Shape::operator<( Shape const & b ) const
+{
+	if ( nUnits != b.nUnits )
+	{
+		return nUnits < b.nUnits;
+	}
+	else if ( nInputs != b.nInputs )
+	{
+		return nInputs < b.nInputs;
+	}
+	else
+	{
+		return nThreads < b.nThreads;
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	cachePath	The file in which the tuned configurations are stored, or empty if they are not stored. If the
+//!						file exists, the configurations in it are loaded.
+
+Autotuner::Autotuner( std::string const & cachePath /* = std::string()*/ )
+	: m_cachePath( cachePath ),
+	m_bTuning( true )
+{
+	if ( !m_cachePath.empty() )
+	{
+		Load();
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+Autotuner::~Autotuner()
+{
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	enabled		If false, shapes that are not in the cache get the configuration returned by GetDefault()
+//!						instead of being tuned.
+
+void Autotuner::SetTuning( bool enabled )
+{
+	std::lock_guard< std::mutex >	lock( m_mutex );
+
+	m_bTuning = enabled;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+bool Autotuner::IsTuning() const
+{
+	std::lock_guard< std::mutex >	lock( m_mutex );
+
+	return m_bTuning;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! If the shape has not been seen before and tuning is enabled, it is tuned, which takes a few milliseconds per
+//! candidate configuration, and the cache file is updated.
+//!
+//! @param	nUnits		The number of units in the layer.
+//! @param	nInputs		The number of inputs to each unit.
+//! @param	pPool		The thread pool the layer is split across, or 0 if it is processed serially.
+//!
+//! @return		The configuration to use.
+
+KernelConfig Autotuner::Get( int nUnits, int nInputs, ThreadPool * pPool /* = 0*/ )
+{
+	Shape	shape;
+	shape.nUnits	= nUnits;
+	shape.nInputs	= nInputs;
+	shape.nThreads	= ( pPool != 0 ) ? pPool->GetThreadCount() : 1;
+
+	KernelConfig	config;
+
+	{
+		std::lock_guard< std::mutex >	lock( m_mutex );
+
+		ConfigMap::const_iterator const	pEntry	= m_configs.find( shape );
+
+		if ( pEntry != m_configs.end() )
+		{
+			return pEntry->second;
+		}
+
+		if ( !m_bTuning )
+		{
+			return GetDefault( nUnits, nInputs );
+		}
+
+		// Tuning is done while holding the lock so that a shape is only tuned once and so that the timings are not
+		// disturbed by other tuning.
+
+		config = Tune( nUnits, nInputs, pPool );
+		m_configs[shape] = config;
+	}
+
+	if ( !m_cachePath.empty() )
+	{
+		Save();
+	}
+
+	return config;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The file is replaced as a whole, so a concurrent reader never sees a partially written file. Saves by different
+//! threads (for example, after they tune different shapes) are serialized, since they share the temporary file.
+//!
+//! @return		True if the file was written.
+
+bool Autotuner::Save() const
+{
+	if ( m_cachePath.empty() )
+	{
+		return false;
+	}
+
+	std::lock_guard< std::mutex >	saveLock( m_saveMutex );
+	std::string const				tempPath	= m_cachePath + ".tmp";
+
+	{
+		std::ofstream	out( tempPath.c_str() );
+
+		out << CACHE_SIGNATURE << std::endl;
+
+		std::lock_guard< std::mutex >	lock( m_mutex );
+
+		for ( ConfigMap::const_iterator p = m_configs.begin(); p != m_configs.end(); ++p )
+		{
+			out << p->first.nUnits << ' ' << p->first.nInputs << ' ' << p->first.nThreads << ' '
+				<< p->second.unroll << ' ' << p->second.unitBlock << ' ' << p->second.tileSize << std::endl;
+		}
+
+		if ( !out )
+		{
+			std::remove( tempPath.c_str() );
+			return false;
+		}
+	}
+
+	// Some platforms do not allow renaming over an existing file.
+
+	if ( std::rename( tempPath.c_str(), m_cachePath.c_str() ) != 0 )
+	{
+		std::remove( m_cachePath.c_str() );
+		if ( std::rename( tempPath.c_str(), m_cachePath.c_str() ) != 0 )
+		{
+			std::remove( tempPath.c_str() );
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Wide rows are split into several partial sums, and units are computed in blocks of 4 when there are enough of
+//! them.
+//!
+//! @param	nUnits		The number of units in the layer.
+//! @param	nInputs		The number of inputs to each unit.
+//!
+//! @return		The configuration to use.
+
+KernelConfig Autotuner::GetDefault( int nUnits, int nInputs )
+{
+	int const	unroll		= ( nInputs >= 64 ) ? 8 : ( nInputs >= 16 ) ? 4 : 1;
+	int const	unitBlock	= ( nUnits >= 4 ) ? 4 : ( nUnits >= 2 ) ? 2 : 1;
+
+	return KernelConfig( unroll, unitBlock );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Lines that cannot be parsed or that contain an unsupported configuration are ignored.
+//!
+//! @return		True if the file was read.
+
+bool Autotuner::Load()
+{
+	std::ifstream	in( m_cachePath.c_str() );
+	std::string		line;
+
+	if ( !std::getline( in, line ) || line != CACHE_SIGNATURE )
+	{
+		return false;
+	}
+
+	std::lock_guard< std::mutex >	lock( m_mutex );
+
+	while ( std::getline( in, line ) )
+	{
+		std::istringstream	fields( line );
+		Shape				shape;
+		KernelConfig		config;
+
+		fields >> shape.nUnits >> shape.nInputs >> shape.nThreads;
+		fields >> config.unroll >> config.unitBlock >> config.tileSize;
+
+		if ( fields && config.IsValid() )
+		{
+			m_configs[shape] = config;
+		}
+	}
+
+	return true;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Each candidate kernel is timed on a layer of the given shape. Then, if there is a thread pool with more than one
+//! thread, several tile sizes are timed with the fastest kernel. A tile size is only chosen if it beats the serial
+//! time; otherwise the tile size is the number of units, so the layer is not split.
+//!
+//! @param	nUnits		The number of units in the layer.
+//! @param	nInputs		The number of inputs to each unit.
+//! @param	pPool		The thread pool the layer is split across, or 0 if it is processed serially.
+//!
+//! @return		The fastest configuration.
+
+KernelConfig Autotuner::Tune( int nUnits, int nInputs, ThreadPool * pPool )
+{
+	if ( nUnits <= 0 || nInputs <= 0 )
+	{
+		return KernelConfig();
+	}
+
+	// Make a layer of the given shape. The values don't matter, but they should not be denormal.
+
+	std::vector< Neuron >	aUnits;
+	Neuron::InputVector		aInputs( nInputs );
+	std::vector< float >	aSums( nUnits );
+
+	aUnits.reserve( nUnits );
+	for ( int j = 0; j < nUnits; j++ )
+	{
+		Neuron::WeightVector	aWeights( nInputs );
+
+		for ( int i = 0; i < nInputs; i++ )
+		{
+			aWeights[i] = float( ( i + j ) % 7 - 3 ) * .125f;
+		}
+		aUnits.push_back( Neuron( aWeights ) );
+	}
+
+	for ( int i = 0; i < nInputs; i++ )
+	{
+		aInputs[i] = float( i % 5 ) * .25f;
+	}
+
+	// Find the fastest kernel.
+
+	std::vector< KernelConfig > const	aCandidates	= KernelConfig::GetCandidates();
+
+	KernelConfig	best;
+	double			bestTime	= 0.;
+
+	for ( size_t c = 0; c < aCandidates.size(); c++ )
+	{
+		KernelConfig const &	config	= aCandidates[c];
+		double const			t		= Time( [&]
+		{
+			ComputeSums( config, &aUnits[0], nUnits, &aInputs[0], &aSums[0] );
+		} );
+
+		if ( c == 0 || t < bestTime )
+		{
+			best		= config;
+			bestTime	= t;
+		}
+	}
+
+	// Find the fastest tile size with that kernel.
+
+	if ( pPool != 0 && pPool->GetThreadCount() > 1 )
+	{
+		int const	nThreads	= pPool->GetThreadCount();
+		int const	rowBytes	= nInputs * (int)sizeof( float );
+
+		best.tileSize = nUnits;
+
+		std::vector< int >	aTileSizes;
+		aTileSizes.push_back( std::max( 8 * 1024 / rowBytes, 1 ) );
+		aTileSizes.push_back( std::max( 32 * 1024 / rowBytes, 1 ) );
+		aTileSizes.push_back( std::max( 128 * 1024 / rowBytes, 1 ) );
+		aTileSizes.push_back( std::max( ( nUnits + nThreads - 1 ) / nThreads, 1 ) );
+
+		for ( size_t s = 0; s < aTileSizes.size(); s++ )
+		{
+			KernelConfig	config	= best;
+			config.tileSize = aTileSizes[s];
+
+			double const	t	= Time( [&]
+			{
+				pPool->ParallelFor( nUnits, config.tileSize, [&] ( int first, int last )
+				{
+					ComputeSums( config, &aUnits[first], last - first, &aInputs[0], &aSums[first] );
+				} );
+			} );
+
+			if ( t < bestTime )
+			{
+				best.tileSize	= config.tileSize;
+				bestTime		= t;
+			}
+		}
+	}
+
+	return best;
+}
@@ -0,0 +1,277 @@
+/** @file *//********************************************************************************************************
+
+                                                    BinaryNet.cpp
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/BinaryNet.cpp#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#include "BinaryNet.h"
+
+#include "MultilayerFeedForward.h"
+#include "Perceptron.h"
+
+#include <cassert>
+
+#if defined( _MSC_VER )
+#include <intrin.h>
+#endif
+
+//! The number of bits in a word.
+static int const	WORD_BITS	= 64;
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	x	A word.
+//! @return		The number of bits in @a x that are 1.
+
+static inline int Popcount( BinaryNet::Word x )
+{
+#if defined( _MSC_VER ) && defined( _M_X64 )
+	return (int)__popcnt64( x );
+#elif defined( __GNUC__ )
+	return __builtin_popcountll( x );
+#else
+	x = x - ( ( x >> 1 ) & 0x5555555555555555ULL );
+	x = ( x & 0x3333333333333333ULL ) + ( ( x >> 2 ) & 0x3333333333333333ULL );
+	x = ( x + ( x >> 4 ) ) & 0x0f0f0f0f0f0f0f0fULL;
+	return (int)( ( x * 0x0101010101010101ULL ) >> 56 );
+#endif
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	p			The Perceptron to binarize.
+//! @param	encoding	The meaning of the bits.
+
+BinaryNet::BinaryNet( Perceptron const & p, Encoding encoding /* = ZERO_ONE*/ )
+	: m_encoding( encoding )
+{
+	AddLayer( p.GetWeights(), 0, p.GetInputCount(), p.GetOutputCount() );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	mff			The MultilayerFeedForward to binarize.
+//! @param	encoding	The meaning of the bits.
+
+BinaryNet::BinaryNet( MultilayerFeedForward const & mff, Encoding encoding /* = ZERO_ONE*/ )
+	: m_encoding( encoding )
+{
+	Neuron::WeightVector const	aWeights	= mff.GetWeights();
+	int const					nInputs		= mff.GetInputCount();
+	int const					nHidden		= mff.GetHiddenCount();
+	int const					nOutputs	= mff.GetOutputCount();
+
+	AddLayer( aWeights, 0, nInputs, nHidden );
+	AddLayer( aWeights, nInputs * nHidden, nHidden, nOutputs );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+BinaryNet::~BinaryNet()
+{
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! An input is converted to a 1 bit if it is at least .5 (for ZERO_ONE) or at least 0 (for MINUS_ONE_ONE).
+//!
+//! @param	aInputs		The input values.
+//! @param	aBits		Where to store the input bits.
+
+void BinaryNet::Pack( Neuron::InputVector const & aInputs, BitVector & aBits ) const
+{
+	assert( (int)aInputs.size() == GetInputCount() );
+
+	int const	nInputs		= (int)aInputs.size();
+	float const	threshold	= ( m_encoding == ZERO_ONE ) ? .5f : 0.f;
+
+	aBits.assign( ( nInputs + WORD_BITS - 1 ) / WORD_BITS, 0 );
+
+	for ( int i = 0; i < nInputs; i++ )
+	{
+		if ( aInputs[i] >= threshold )
+		{
+			aBits[i / WORD_BITS] |= Word( 1 ) << ( i % WORD_BITS );
+		}
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	aInputs		The input bits, as packed by Pack().
+//! @param	aOutputs	Where to store the output bits.
+
+void BinaryNet::Evaluate( BitVector const & aInputs, BitVector & aOutputs ) const
+{
+	static thread_local BitVector	aHidden;
+
+	assert( (int)aInputs.size() == m_aLayers.front().nWords );
+
+	BitVector const *	paLayerInputs	= &aInputs;
+
+	for ( size_t l = 0; l < m_aLayers.size(); l++ )
+	{
+		Layer const &	layer	= m_aLayers[l];
+		BitVector &		outputs	= ( l + 1 < m_aLayers.size() ) ? aHidden : aOutputs;
+
+		outputs.assign( ( layer.nUnits + WORD_BITS - 1 ) / WORD_BITS, 0 );
+		EvaluateLayer( layer, &( *paLayerInputs )[0], &outputs[0] );
+
+		paLayerInputs = &outputs;
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	aInputs		The input values. They are converted to bits by Pack().
+//! @param	aOutputs	Where to store the outputs. Each output is 0 or 1 (for ZERO_ONE) or -1 or 1 (for
+//!						MINUS_ONE_ONE).
+
+void BinaryNet::Evaluate( Neuron::InputVector const & aInputs, NeuralNet::OutputVector & aOutputs ) const
+{
+	static thread_local BitVector	aInputBits;
+	static thread_local BitVector	aOutputBits;
+
+	Pack( aInputs, aInputBits );
+	Evaluate( aInputBits, aOutputBits );
+
+	int const	nOutputs	= GetOutputCount();
+	float const	zero		= ( m_encoding == ZERO_ONE ) ? 0.f : -1.f;
+
+	aOutputs.resize( nOutputs );
+	for ( int i = 0; i < nOutputs; i++ )
+	{
+		aOutputs[i] = ( ( aOutputBits[i / WORD_BITS] >> ( i % WORD_BITS ) ) & 1 ) ? 1.f : zero;
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! A weight is converted to a 1 bit if it is at least 0. The unused bits in the last word of each unit are 0.
+//!
+//! @param	aWeights	The weights of the net, in the order returned by GetWeights().
+//! @param	first		Index of the first weight of the layer.
+//! @param	nInputs		The number of inputs to each unit.
+//! @param	nUnits		The number of units.
+
+void BinaryNet::AddLayer( Neuron::WeightVector const & aWeights, int first, int nInputs, int nUnits )
+{
+	Layer	layer;
+	layer.nInputs	= nInputs;
+	layer.nUnits	= nUnits;
+	layer.nWords	= ( nInputs + WORD_BITS - 1 ) / WORD_BITS;
+	layer.aWeights.assign( nUnits * layer.nWords, 0 );
+
+	for ( int j = 0; j < nUnits; j++ )
+	{
+		Word * const	paUnitWeights	= &layer.aWeights[j * layer.nWords];
+
+		for ( int i = 0; i < nInputs; i++ )
+		{
+			if ( aWeights[first + j * nInputs + i] >= 0.f )
+			{
+				paUnitWeights[i / WORD_BITS] |= Word( 1 ) << ( i % WORD_BITS );
+			}
+		}
+	}
+
+	m_aLayers.push_back( layer );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! A unit's output bit is 1 if its combined input is at least 0.
+//!
+//! @param	layer		The layer.
+//! @param	paInputs	The input bits.
+//! @param	paOutputs	Where to store the output bits. The words must be cleared.
+
+void BinaryNet::EvaluateLayer( Layer const & layer, Word const * paInputs, Word * paOutputs ) const
+{
+	int const	nWords	= layer.nWords;
+
+	if ( m_encoding == ZERO_ONE )
+	{
+		// The combined input is (number of 1 inputs with positive weights) - (number of 1 inputs with negative
+		// weights), so it is at least 0 if 2 * popcount(x & w) >= popcount(x).
+
+		int	nOnes	= 0;
+		for ( int k = 0; k < nWords; k++ )
+		{
+			nOnes += Popcount( paInputs[k] );
+		}
+
+		for ( int j = 0; j < layer.nUnits; j++ )
+		{
+			Word const * const	paWeights	= &layer.aWeights[j * nWords];
+			int					nPositive	= 0;
+
+			for ( int k = 0; k < nWords; k++ )
+			{
+				nPositive += Popcount( paInputs[k] & paWeights[k] );
+			}
+
+			if ( 2 * nPositive >= nOnes )
+			{
+				paOutputs[j / WORD_BITS] |= Word( 1 ) << ( j % WORD_BITS );
+			}
+		}
+	}
+	else
+	{
+		// The combined input is (number of matching signs) - (number of differing signs), so it is at least 0 if
+		// 2 * popcount(x ^ w) <= n. The unused bits are 0 in both the inputs and the weights, so they never differ.
+
+		int const	nInputs	= layer.nInputs;
+
+		for ( int j = 0; j < layer.nUnits; j++ )
+		{
+			Word const * const	paWeights	= &layer.aWeights[j * nWords];
+			int					nDiffering	= 0;
+
+			for ( int k = 0; k < nWords; k++ )
+			{
+				nDiffering += Popcount( paInputs[k] ^ paWeights[k] );
+			}
+
+			if ( 2 * nDiffering <= nInputs )
+			{
+				paOutputs[j / WORD_BITS] |= Word( 1 ) << ( j % WORD_BITS );
+			}
+		}
+	}
+}
@@ -0,0 +1,256 @@
+/** @file *//********************************************************************************************************
+
+                                                    CacheFile.cpp
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/CacheFile.cpp#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#include "CacheFile.h"
+
+#include <cassert>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+
+static_assert( sizeof( CacheFile::Header ) == 64, "The layout of a cache file header must not change." );
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+CacheFile::CacheFile()
+	: m_pFile( 0 )
+{
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+CacheFile::~CacheFile()
+{
+	Close();
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	path		The path of the file.
+//! @param	signature	The signature the file must have.
+//! @param	fingerprint	The fingerprint the file must have.
+//! @param	width		The number of floats for each sample.
+//!
+//! @return		True if the file was opened. If not (for example, if it does not exist, is incomplete, or was written
+//!				for different data), the file is closed.
+
+bool CacheFile::Open( std::string const & path, char const * signature, uint64_t fingerprint, int width )
+{
+	Close();
+
+	std::error_code	error;
+	uint64_t const	size	= std::filesystem::file_size( path, error );
+	Header			header;
+
+	if ( error )
+	{
+		return false;
+	}
+
+	m_pFile	= fopen( path.c_str(), "rb" );
+	m_path	= path;
+
+	if ( m_pFile == 0 ||
+		 fread( &header, sizeof( header ), 1, m_pFile ) != 1 ||
+		 !IsValid( header, signature, fingerprint, width, size ) )
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The file is written under a temporary name until Commit() is called.
+//!
+//! @param	path		The path of the file.
+//! @param	signature	The signature of the file. It must be shorter than 32 characters.
+//! @param	fingerprint	The fingerprint of the data the file is computed from.
+//! @param	nSamples	The number of samples.
+//! @param	width		The number of floats for each sample.
+//!
+//! @return		True if the file was created. If not, the file is closed.
+
+bool CacheFile::Create( std::string const & path,
+						char const * signature,
+						uint64_t fingerprint,
+						int nSamples,
+						int width )
+{
+	assert( std::strlen( signature ) < sizeof( Header().signature ) );
+
+	Close();
+
+	Header	header;
+
+	std::memset( &header, 0, sizeof( header ) );
+	std::strcpy( header.signature, signature );
+	header.fingerprint	= fingerprint;
+	header.nSamples		= nSamples;
+	header.width		= width;
+
+	m_path		= path;
+	m_tempPath	= path + ".tmp";
+	m_pFile		= fopen( m_tempPath.c_str(), "wb" );
+
+	if ( m_pFile == 0 || fwrite( &header, sizeof( header ), 1, m_pFile ) != 1 )
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	paValues	Where to store the floats.
+//! @param	count		The number of floats to read.
+//!
+//! @return		True if all of the floats were read. If not, the file is closed.
+
+bool CacheFile::Read( float * paValues, size_t count )
+{
+	assert( m_pFile != 0 && m_tempPath.empty() );
+
+	if ( fread( paValues, sizeof( float ), count, m_pFile ) != count )
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	paValues	The floats.
+//! @param	count		The number of floats to write.
+//!
+//! @return		True if all of the floats were written. If not, the file is discarded.
+
+bool CacheFile::Write( float const * paValues, size_t count )
+{
+	assert( m_pFile != 0 && !m_tempPath.empty() );
+
+	if ( fwrite( paValues, sizeof( float ), count, m_pFile ) != count )
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @return		True if the file was closed and renamed. If not, the file is discarded.
+
+bool CacheFile::Commit()
+{
+	assert( m_pFile != 0 && !m_tempPath.empty() );
+
+	std::error_code	error;
+	bool const		closed	= fclose( m_pFile ) == 0;
+
+	m_pFile = 0;
+
+	if ( closed )
+	{
+		std::filesystem::rename( m_tempPath, m_path, error );
+	}
+
+	if ( !closed || error )
+	{
+		std::filesystem::remove( m_tempPath, error );
+		m_tempPath.clear();
+		return false;
+	}
+
+	m_tempPath.clear();
+
+	return true;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+void CacheFile::Close()
+{
+	if ( m_pFile != 0 )
+	{
+		fclose( m_pFile );
+		m_pFile = 0;
+
+		if ( !m_tempPath.empty() )
+		{
+			std::error_code	error;
+
+			std::filesystem::remove( m_tempPath, error );
+		}
+	}
+
+	m_path.clear();
+	m_tempPath.clear();
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	header		The header.
+//! @param	signature	The signature the file must have.
+//! @param	fingerprint	The fingerprint the file must have.
+//! @param	width		The number of floats for each sample.
+//! @param	size		The size of the file.
+//!
+//! @return		True if the header is valid and matches the signature, fingerprint and width and the size of the file.
+
+bool CacheFile::IsValid( Header const & header,
+						 char const * signature,
+						 uint64_t fingerprint,
+						 int width,
+						 uint64_t size )
+{
+	return std::strncmp( header.signature, signature, sizeof( header.signature ) ) == 0 &&
+		   header.fingerprint == fingerprint &&
+		   header.width == (uint64_t)width &&
+		   header.nSamples <= (uint64_t)std::numeric_limits< int >::max() &&
+		   size == sizeof( Header ) + header.nSamples * header.width * sizeof( float );
+}
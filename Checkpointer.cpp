@@ -0,0 +1,429 @@
+/** @file *//********************************************************************************************************
+
+                                                  Checkpointer.cpp
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/Checkpointer.cpp#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#include "Checkpointer.h"
+
+#include "Fnv1a.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <limits>
+#include <sstream>
+
+#if defined( _WIN32 )
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+//! The first line of a checkpoint file.
+static char const	CHECKPOINT_SIGNATURE[]	= "NeuralNet checkpoint 1";
+
+//! The extension of a checkpoint file.
+static char const	CHECKPOINT_EXTENSION[]	= ".ckpt";
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	pFile	The file.
+//!
+//! @return		True if the file's data was written to the disk.
+
+static bool SyncFile( FILE * pFile )
+{
+	if ( fflush( pFile ) != 0 )
+	{
+		return false;
+	}
+
+#if defined( _WIN32 )
+	return _commit( _fileno( pFile ) ) == 0;
+#else
+	return fsync( fileno( pFile ) ) == 0;
+#endif
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! A renamed file is only safe from a crash once its directory has been written to the disk.
+//!
+//! @param	path	The path of a file in the directory.
+
+static void SyncDirectory( std::string const & path )
+{
+#if !defined( _WIN32 )
+	std::filesystem::path	directory	= std::filesystem::path( path ).parent_path();
+
+	if ( directory.empty() )
+	{
+		directory = ".";
+	}
+
+	int const	fd	= open( directory.c_str(), O_RDONLY );
+
+	if ( fd >= 0 )
+	{
+		fsync( fd );
+		close( fd );
+	}
+#endif
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	prefix	The path and name prefix of the checkpoint files, for example "checkpoints/model".
+//! @param	nKept	The number of checkpoints kept on disk.
+
+Checkpointer::Checkpointer( std::string const & prefix, int nKept /* = DEFAULT_KEPT*/ )
+	: m_prefix( prefix ),
+	m_nKept( nKept ),
+	m_bPending( false ),
+	m_bWriting( false ),
+	m_bQuit( false ),
+	m_nFailures( 0 )
+{
+	assert( nKept > 0 );
+
+	m_thread = std::thread( &Checkpointer::Run, this );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! A checkpoint that has been requested is written before the checkpointer is destroyed.
+
+Checkpointer::~Checkpointer()
+{
+	{
+		std::lock_guard< std::mutex >	lock( m_mutex );
+		m_bQuit = true;
+	}
+	m_changed.notify_all();
+
+	m_thread.join();
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+void Checkpointer::Wait()
+{
+	std::unique_lock< std::mutex >	lock( m_mutex );
+
+	m_changed.wait( lock, [this] { return !m_bPending && !m_bWriting; } );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+int Checkpointer::GetFailureCount() const
+{
+	std::lock_guard< std::mutex >	lock( m_mutex );
+
+	return m_nFailures;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	write	The function that writes the snapshot of the net.
+//! @param	state	The training state.
+
+void Checkpointer::Enqueue( Writer const & write, TrainingState const & state )
+{
+	Job	job;
+	job.write	= write;
+	job.state	= state;
+
+	{
+		std::lock_guard< std::mutex >	lock( m_mutex );
+
+		std::swap( m_pending, job );	// The replaced snapshot (if any) is destroyed after the lock is released
+		m_bPending = true;
+	}
+
+	m_changed.notify_all();
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	read	The function that reads the net.
+//! @param	state	Where to store the training state.
+//!
+//! @return		True if a checkpoint was read.
+
+bool Checkpointer::Load( Reader const & read, TrainingState & state ) const
+{
+	std::vector< std::string > const	aPaths	= ListCheckpoints();
+
+	for ( size_t i = 0; i < aPaths.size(); i++ )
+	{
+		FILE * const	pFile	= fopen( aPaths[i].c_str(), "rb" );
+
+		if ( pFile == 0 )
+		{
+			continue;
+		}
+
+		// Read the whole file and check it before changing the net.
+
+		std::string	contents;
+		char		buffer[64 * 1024];
+		size_t		n;
+
+		while ( ( n = fread( buffer, 1, sizeof( buffer ), pFile ) ) > 0 )
+		{
+			contents.append( buffer, n );
+		}
+		fclose( pFile );
+
+		std::istringstream	in( contents );
+		std::string			signature;
+		std::string			label[4];
+		TrainingState		loaded;
+		size_t				size		= 0;
+		uint64_t			checksum	= 0;
+
+		std::getline( in, signature );
+		in >> label[0] >> loaded.step >> label[1] >> loaded.rate;
+		in >> label[2] >> size >> label[3] >> std::hex >> checksum;
+		in.ignore();	// The newline
+
+		if ( !in || signature != CHECKPOINT_SIGNATURE || label[0] != "step" || label[1] != "rate" ||
+			 label[2] != "size" || label[3] != "checksum" )
+		{
+			continue;
+		}
+
+		size_t const	start	= (size_t)in.tellg();
+
+		if ( contents.size() - start != size )
+		{
+			continue;
+		}
+
+		std::string const	payload	= contents.substr( start );
+
+		if ( Fnv1a::Hash( payload.data(), payload.size() ) != checksum )
+		{
+			continue;
+		}
+
+		std::istringstream	netIn( payload );
+
+		if ( read( netIn ) )
+		{
+			state = loaded;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The weights are written with enough digits to be read back exactly.
+//!
+//! @param	job		The checkpoint to write.
+//!
+//! @return		True if the checkpoint was written.
+
+bool Checkpointer::WriteCheckpoint( Job const & job ) const
+{
+	// Serialize
+
+	std::ostringstream	payloadOut;
+	payloadOut.precision( std::numeric_limits< float >::max_digits10 );
+	job.write( payloadOut );
+
+	if ( !payloadOut )
+	{
+		return false;
+	}
+
+	std::string const	payload	= payloadOut.str();
+
+	std::ostringstream	headerOut;
+	headerOut.precision( std::numeric_limits< float >::max_digits10 );
+	headerOut << CHECKPOINT_SIGNATURE << '\n'
+			  << "step " << job.state.step << '\n'
+			  << "rate " << job.state.rate << '\n'
+			  << "size " << payload.size() << '\n'
+			  << "checksum " << std::hex << Fnv1a::Hash( payload.data(), payload.size() ) << '\n';
+
+	std::string const	header	= headerOut.str();
+
+	// Write to a temporary file, flush it to the disk, and then give it its real name.
+
+	char	step[32];
+	snprintf( step, sizeof( step ), "%012lld", job.state.step );
+
+	std::string const	path		= m_prefix + "-" + step + CHECKPOINT_EXTENSION;
+	std::string const	tempPath	= path + ".tmp";
+	FILE * const		pFile		= fopen( tempPath.c_str(), "wb" );
+
+	if ( pFile == 0 )
+	{
+		return false;
+	}
+
+	bool const	written	= fwrite( header.data(), 1, header.size(), pFile ) == header.size() &&
+						  fwrite( payload.data(), 1, payload.size(), pFile ) == payload.size() &&
+						  SyncFile( pFile );
+
+	if ( fclose( pFile ) != 0 || !written )
+	{
+		std::remove( tempPath.c_str() );
+		return false;
+	}
+
+	std::error_code	error;
+	std::filesystem::rename( tempPath, path, error );
+	if ( error )
+	{
+		std::remove( tempPath.c_str() );
+		return false;
+	}
+
+	SyncDirectory( path );
+
+	return true;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+void Checkpointer::Prune() const
+{
+	std::vector< std::string > const	aPaths	= ListCheckpoints();
+
+	for ( size_t i = m_nKept; i < aPaths.size(); i++ )
+	{
+		std::remove( aPaths[i].c_str() );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @return		The paths of the checkpoint files. Since the steps in the names are padded, the newest file has the
+//!				greatest name.
+
+std::vector< std::string > Checkpointer::ListCheckpoints() const
+{
+	std::filesystem::path const	prefix		= m_prefix;
+	std::filesystem::path		directory	= prefix.parent_path();
+	std::string const			name		= prefix.filename().string() + "-";
+
+	if ( directory.empty() )
+	{
+		directory = ".";
+	}
+
+	std::vector< std::string >	aPaths;
+	std::error_code				error;
+
+	for ( std::filesystem::directory_iterator p( directory, error ), end; !error && p != end; p.increment( error ) )
+	{
+		std::string const	filename	= p->path().filename().string();
+		size_t const		extension	= filename.size() - ( sizeof( CHECKPOINT_EXTENSION ) - 1 );
+
+		if ( filename.size() > name.size() + sizeof( CHECKPOINT_EXTENSION ) - 1 &&
+			 filename.compare( 0, name.size(), name ) == 0 &&
+			 filename.compare( extension, std::string::npos, CHECKPOINT_EXTENSION ) == 0 &&
+			 filename.find_first_not_of( "0123456789", name.size() ) == extension )
+		{
+			aPaths.push_back( p->path().string() );
+		}
+	}
+
+	std::sort( aPaths.begin(), aPaths.end(), std::greater< std::string >() );
+
+	return aPaths;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+void Checkpointer::Run()
+{
+	std::unique_lock< std::mutex >	lock( m_mutex );
+
+	for ( ;; )
+	{
+		m_changed.wait( lock, [this] { return m_bQuit || m_bPending; } );
+
+		if ( !m_bPending )
+		{
+			return;		// Quitting and there is nothing left to write
+		}
+
+		Job	job;
+		std::swap( job, m_pending );
+		m_bPending	= false;
+		m_bWriting	= true;
+
+		lock.unlock();
+
+		bool const	written	= WriteCheckpoint( job );
+
+		if ( written )
+		{
+			Prune();
+		}
+
+		job = Job();	// Release the snapshot before reporting that the write is done
+
+		lock.lock();
+
+		if ( !written )
+		{
+			++m_nFailures;
+		}
+		m_bWriting = false;
+		m_changed.notify_all();
+	}
+}
@@ -0,0 +1,346 @@
+/** @file *//********************************************************************************************************
+
+                                                  CodeGenerator.cpp
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/CodeGenerator.cpp#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#include "CodeGenerator.h"
+
+#include "MultilayerFeedForward.h"
+#include "Perceptron.h"
+#include "TextFormat.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <ostream>
+
+//! The number of weights written on each line of an array.
+static int const	WEIGHTS_PER_LINE	= 8;
+
+//! The C++ keywords (including the alternative tokens), which cannot be used as names.
+static char const * const	KEYWORDS[]	=
+{
+	"alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break", "case", "catch",
+	"char", "char8_t", "char16_t", "char32_t", "class", "compl", "concept", "const", "consteval", "constexpr",
+	"constinit", "const_cast", "continue", "co_await", "co_return", "co_yield", "decltype", "default", "delete",
+	"do", "double", "dynamic_cast", "else", "enum", "explicit", "export", "extern", "false", "float", "for",
+	"friend", "goto", "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept", "not", "not_eq",
+	"nullptr", "operator", "or", "or_eq", "private", "protected", "public", "register", "reinterpret_cast",
+	"requires", "return", "short", "signed", "sizeof", "static", "static_assert", "static_cast", "struct", "switch",
+	"template", "this", "thread_local", "throw", "true", "try", "typedef", "typeid", "typename", "union", "unsigned",
+	"using", "virtual", "void", "volatile", "wchar_t", "while", "xor", "xor_eq"
+};
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	name	A name.
+//!
+//! @return		True if @a name is a valid C++ identifier that is neither a keyword nor reserved for the implementation
+//!				(a name containing two underscores in a row, or starting with an underscore and a capital letter).
+
+bool IsValidName( std::string const & name )
+{
+	if ( name.empty() || std::isdigit( (unsigned char)name[0] ) )
+	{
+		return false;
+	}
+
+	if ( name.find( "__" ) != std::string::npos ||
+		 ( name.size() > 1 && name[0] == '_' && std::isupper( (unsigned char)name[1] ) ) )
+	{
+		return false;
+	}
+
+	for ( size_t k = 0; k < sizeof( KEYWORDS ) / sizeof( KEYWORDS[0] ); k++ )
+	{
+		if ( name == KEYWORDS[k] )
+		{
+			return false;
+		}
+	}
+
+	for ( size_t i = 0; i < name.size(); i++ )
+	{
+		if ( !std::isalnum( (unsigned char)name[i] ) && name[i] != '_' )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The value is written as the shortest text that the compiler converts back to exactly the same float (see
+//! FormatFloat()), which does not depend on the locale.
+//!
+//! @param	out		The stream to write to.
+//! @param	x		The value. It must be finite.
+
+static void WriteFloat( std::ostream & out, float x )
+{
+	assert( std::isfinite( x ) );
+
+	static char const	MARKS[]	= { '.', 'e' };	// Either makes the literal a floating-point literal
+
+	char			buffer[MAX_FLOAT_TEXT_SIZE];
+	char * const	pEnd	= FormatFloat( x, buffer );
+
+	out.write( buffer, pEnd - buffer );
+
+	// Make sure that the literal is a floating-point literal so that the suffix is valid.
+
+	if ( std::find_first_of( buffer, pEnd, MARKS, MARKS + 2 ) == pEnd )
+	{
+		out << '.';
+	}
+
+	out << 'f';
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	aWeights	The weights.
+//!
+//! @return		True if every weight is finite, so that it can be written as a literal.
+
+static bool AreFinite( Neuron::WeightVector const & aWeights )
+{
+	for ( size_t i = 0; i < aWeights.size(); i++ )
+	{
+		if ( !std::isfinite( aWeights[i] ) )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	out			The stream to write to.
+//! @param	name		The name of the array.
+//! @param	rows		The name of the constant holding the number of rows.
+//! @param	columns		The name of the constant holding the number of columns.
+//! @param	aWeights	The weights.
+//! @param	first		Index of the first weight in the array.
+//! @param	nRows		The number of rows.
+//! @param	nColumns	The number of columns.
+
+static void WriteWeights( std::ostream & out, char const * name, char const * rows, char const * columns,
+						  Neuron::WeightVector const & aWeights, int first, int nRows, int nColumns )
+{
+	out << "alignas( 64 ) inline constexpr float\t" << name << "[" << rows << "][" << columns << "] =\n"
+		<< "{\n";
+
+	for ( int j = 0; j < nRows; j++ )
+	{
+		out << "\t{";
+
+		for ( int i = 0; i < nColumns; i++ )
+		{
+			out << ( ( i % WEIGHTS_PER_LINE == 0 ) ? "\n\t\t" : " " );
+			WriteFloat( out, aWeights[first + j * nColumns + i] );
+			out << ",";
+		}
+
+		out << "\n\t},\n";
+	}
+
+	out << "};\n"
+		<< "\n";
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	out			The stream to write to.
+//! @param	name		The namespace name.
+//! @param	type		The type of net.
+
+static void WriteProlog( std::ostream & out, std::string const & name, char const * type )
+{
+	out << "// " << name << ".h\n"
+		<< "//\n"
+		<< "// Generated from a trained " << type << ". Do not edit.\n"
+		<< "\n"
+		<< "#pragma once\n"
+		<< "\n"
+		<< "#include <cmath>\n"
+		<< "\n"
+		<< "namespace " << name << "\n"
+		<< "{\n"
+		<< "\n";
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The activation function is the sigmoid function used by Neuron.
+//!
+//! @param	out			The stream to write to.
+
+static void WriteActivation( std::ostream & out )
+{
+	out << "//! The activation function.\n"
+		<< "inline float Activation( float x )\n"
+		<< "{\n"
+		<< "\treturn 1.f / ( 1.f + std::exp( -x ) );\n"
+		<< "}\n"
+		<< "\n";
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	out			The stream to write to.
+//! @param	inputs		The expression for the inputs.
+//! @param	outputs		The expression for the outputs.
+//! @param	weights		The name of the weight array.
+//! @param	nInputs		The name of the constant holding the number of inputs.
+//! @param	nUnits		The name of the constant holding the number of units.
+
+static void WriteLayer( std::ostream & out, char const * inputs, char const * outputs, char const * weights,
+						char const * nInputs, char const * nUnits )
+{
+	out << "\tfor ( int j = 0; j < " << nUnits << "; j++ )\n"
+		<< "\t{\n"
+		<< "\t\tfloat\tinput\t= 0.f;\n"
+		<< "\n"
+		<< "\t\tfor ( int i = 0; i < " << nInputs << "; i++ )\n"
+		<< "\t\t{\n"
+		<< "\t\t\tinput += " << inputs << "[i] * " << weights << "[j][i];\n"
+		<< "\t\t}\n"
+		<< "\n"
+		<< "\t\t" << outputs << "[j] = Activation( input );\n"
+		<< "\t}\n";
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	out		The stream to write the header to.
+//! @param	p		The Perceptron.
+//! @param	name	The name of the namespace containing the generated code. It must be a valid name (see
+//!					IsValidName()).
+//!
+//! @return		True if the header was written, or false if a weight is not finite (in which case nothing is written).
+
+bool GenerateHeader( std::ostream & out, Perceptron const & p, std::string const & name )
+{
+	assert( IsValidName( name ) );
+	assert( p.GetInputCount() > 0 && p.GetOutputCount() > 0 );
+
+	int const					nInputs		= p.GetInputCount();
+	int const					nOutputs	= p.GetOutputCount();
+	Neuron::WeightVector const	aWeights	= p.GetWeights();
+
+	if ( !AreFinite( aWeights ) )
+	{
+		return false;
+	}
+
+	WriteProlog( out, name, "Perceptron" );
+
+	out << "inline constexpr int\tNUM_INPUTS\t= " << nInputs << ";\n"
+		<< "inline constexpr int\tNUM_OUTPUTS\t= " << nOutputs << ";\n"
+		<< "\n";
+
+	WriteWeights( out, "OUTPUT_WEIGHTS", "NUM_OUTPUTS", "NUM_INPUTS", aWeights, 0, nOutputs, nInputs );
+	WriteActivation( out );
+
+	out << "//! Computes the outputs for the given inputs.\n"
+		<< "inline void Evaluate( float const * paInputs, float * paOutputs )\n"
+		<< "{\n";
+	WriteLayer( out, "paInputs", "paOutputs", "OUTPUT_WEIGHTS", "NUM_INPUTS", "NUM_OUTPUTS" );
+	out << "}\n"
+		<< "\n"
+		<< "} // namespace " << name << "\n";
+
+	return true;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	out		The stream to write the header to.
+//! @param	mff		The MultilayerFeedForward.
+//! @param	name	The name of the namespace containing the generated code. It must be a valid name (see
+//!					IsValidName()).
+//!
+//! @return		True if the header was written, or false if a weight is not finite (in which case nothing is written).
+
+bool GenerateHeader( std::ostream & out, MultilayerFeedForward const & mff, std::string const & name )
+{
+	assert( IsValidName( name ) );
+	assert( mff.GetInputCount() > 0 && mff.GetHiddenCount() > 0 && mff.GetOutputCount() > 0 );
+
+	int const					nInputs		= mff.GetInputCount();
+	int const					nHidden		= mff.GetHiddenCount();
+	int const					nOutputs	= mff.GetOutputCount();
+	Neuron::WeightVector const	aWeights	= mff.GetWeights();
+
+	if ( !AreFinite( aWeights ) )
+	{
+		return false;
+	}
+
+	WriteProlog( out, name, "MultilayerFeedForward" );
+
+	out << "inline constexpr int\tNUM_INPUTS\t= " << nInputs << ";\n"
+		<< "inline constexpr int\tNUM_HIDDEN\t= " << nHidden << ";\n"
+		<< "inline constexpr int\tNUM_OUTPUTS\t= " << nOutputs << ";\n"
+		<< "\n";
+
+	WriteWeights( out, "HIDDEN_WEIGHTS", "NUM_HIDDEN", "NUM_INPUTS", aWeights, 0, nHidden, nInputs );
+	WriteWeights( out, "OUTPUT_WEIGHTS", "NUM_OUTPUTS", "NUM_HIDDEN", aWeights, nInputs * nHidden, nOutputs, nHidden );
+	WriteActivation( out );
+
+	out << "//! Computes the outputs for the given inputs.\n"
+		<< "inline void Evaluate( float const * paInputs, float * paOutputs )\n"
+		<< "{\n"
+		<< "\tfloat\taHidden[NUM_HIDDEN];\n"
+		<< "\n";
+	WriteLayer( out, "paInputs", "aHidden", "HIDDEN_WEIGHTS", "NUM_INPUTS", "NUM_HIDDEN" );
+	out << "\n";
+	WriteLayer( out, "aHidden", "paOutputs", "OUTPUT_WEIGHTS", "NUM_HIDDEN", "NUM_OUTPUTS" );
+	out << "}\n"
+		<< "\n"
+		<< "} // namespace " << name << "\n";
+
+	return true;
+}
@@ -0,0 +1,303 @@
+/** @file *//********************************************************************************************************
+
+                                                    Distiller.cpp
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/Distiller.cpp#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#include "Distiller.h"
+
+#include "CacheFile.h"
+#include "Fnv1a.h"
+#include "MultilayerFeedForward.h"
+
+#include <algorithm>
+#include <cassert>
+#include <thread>
+
+//! The signature at the start of a cache file.
+static char const	CACHE_SIGNATURE[]	= "NeuralNet soft targets 1";
+
+//! The maximum number of blocks computed ahead of the training.
+static int const	MAX_QUEUED_BLOCKS	= 2;
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	teacher		The teacher. It must not be changed while the distiller exists.
+//! @param	student		The student. It must have the same numbers of inputs and outputs as the teacher.
+//! @param	aInputs		The inputs of the data set. They must not be changed while the distiller exists.
+//! @param	blockSize	The number of samples whose soft targets are computed together.
+
+Distiller::Distiller( MultilayerFeedForward const & teacher,
+					  NeuralNet & student,
+					  NeuralNet::InputBatch const & aInputs,
+					  int blockSize /* = DEFAULT_BLOCK_SIZE*/ )
+	: m_teacher( teacher ),
+	m_student( student ),
+	m_aInputs( aInputs ),
+	m_blockSize( blockSize ),
+	m_paHardTargets( 0 ),
+	m_hardWeight( 0.f ),
+	m_fingerprint( 0 ),
+	m_bCached( false )
+{
+	assert( student.GetInputCount() == teacher.GetInputCount() );
+	assert( student.GetOutputCount() == teacher.GetOutputCount() );
+	assert( blockSize > 0 );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+Distiller::~Distiller()
+{
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Each sample is trained toward @a weight * its original target + ( 1 - @a weight ) * its soft target.
+//!
+//! @param	aTargets	The original targets. aTargets[i] is the target for input i. They must not be changed while
+//!						the distiller exists.
+//! @param	weight		The weight of the original targets, from 0 (soft targets only) to 1 (original targets only).
+
+void Distiller::SetHardTargets( NeuralNet::OutputBatch const & aTargets, float weight )
+{
+	assert( aTargets.size() == m_aInputs.size() );
+	assert( weight >= 0.f && weight <= 1.f );
+
+	m_paHardTargets	= &aTargets;
+	m_hardWeight	= weight;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! If the file exists and was written for the same teacher and data set, the soft targets are read from it and the
+//! teacher is never evaluated. Otherwise, the file is written during the next epoch. It is written under a temporary
+//! name and renamed when it is complete.
+//!
+//! @param	path	The path of the file, or an empty string if the soft targets should not be cached.
+//!
+//! @return		True if the file holds the soft targets already.
+
+bool Distiller::SetCache( std::string const & path )
+{
+	m_path			= path;
+	m_fingerprint	= path.empty() ? 0 : Fingerprint();
+	m_bCached		= !path.empty() && IsCacheValid();
+
+	return m_bCached;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The samples are trained in order. While the student is trained on one block, the soft targets of the next blocks
+//! are computed (or read) by a background thread.
+//!
+//! @param	rate	The learning rate.
+//!
+//! @return		The mean over the samples of half the sum of the squared errors, before the student is trained on each
+//!				sample.
+
+float Distiller::Train( float rate )
+{
+	int const				nSamples	= (int)m_aInputs.size();
+	int const				nOutputs	= m_student.GetOutputCount();
+	NeuralNet::ErrorVector	aErrors( nOutputs );
+	double					loss		= 0.;
+
+	std::thread	producer( &Distiller::Produce, this );
+
+	for ( int done = 0; done < nSamples; )
+	{
+		Block	block;
+
+		{
+			std::unique_lock< std::mutex >	lock( m_mutex );
+
+			m_changed.wait( lock, [this] { return !m_blocks.empty(); } );
+			block = std::move( m_blocks.front() );
+			m_blocks.pop_front();
+		}
+		m_changed.notify_all();
+
+		for ( int k = 0; k < (int)block.aOutputs.size(); k++ )
+		{
+			int const							i			= block.first + k;
+			NeuralNet::OutputVector const &		aSoft		= block.aOutputs[k];
+			NeuralNet::OutputVector const &		aOutputs	= m_student( m_aInputs[i] );
+
+			for ( int j = 0; j < nOutputs; j++ )
+			{
+				float	target	= aSoft[j];
+
+				if ( m_paHardTargets != 0 )
+				{
+					target += m_hardWeight * ( ( *m_paHardTargets )[i][j] - target );
+				}
+
+				aErrors[j]	= target - aOutputs[j];
+				loss		+= 0.5 * aErrors[j] * aErrors[j];
+			}
+
+			m_student.Train( m_aInputs[i], aErrors, rate );
+		}
+
+		done += (int)block.aOutputs.size();
+	}
+
+	producer.join();
+
+	return ( nSamples > 0 ) ? (float)( loss / nSamples ) : 0.f;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @return		The 64-bit FNV-1a hash of the sizes and weights of the teacher and the inputs of the data set.
+
+uint64_t Distiller::Fingerprint() const
+{
+	int const					nInputs		= m_teacher.GetInputCount();
+	int const					nHidden		= m_teacher.GetHiddenCount();
+	int const					nOutputs	= m_teacher.GetOutputCount();
+	uint64_t const				nSamples	= m_aInputs.size();
+	Neuron::WeightVector const	aWeights	= m_teacher.GetWeights();
+	Fnv1a						hash;
+
+	hash.Add( &nInputs, sizeof( nInputs ) );
+	hash.Add( &nHidden, sizeof( nHidden ) );
+	hash.Add( &nOutputs, sizeof( nOutputs ) );
+	hash.Add( aWeights.data(), aWeights.size() * sizeof( float ) );
+	hash.Add( &nSamples, sizeof( nSamples ) );
+
+	for ( size_t i = 0; i < m_aInputs.size(); i++ )
+	{
+		hash.Add( m_aInputs[i].data(), m_aInputs[i].size() * sizeof( float ) );
+	}
+
+	return hash.GetValue();
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @return		True if the cache file is complete and was written for the teacher and the data set.
+
+bool Distiller::IsCacheValid() const
+{
+	CacheFile	file;
+
+	return file.Open( m_path, CACHE_SIGNATURE, m_fingerprint, m_teacher.GetOutputCount() );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! If the cache file cannot be read, the soft targets are computed instead. If it cannot be written, the soft targets
+//! are not cached.
+
+void Distiller::Produce()
+{
+	int const				nSamples	= (int)m_aInputs.size();
+	int const				width		= m_teacher.GetOutputCount();
+	CacheFile				in;
+	CacheFile				out;
+	NeuralNet::InputBatch	aBatch;
+	std::vector< float >	aValues;
+
+	if ( m_bCached )
+	{
+		in.Open( m_path, CACHE_SIGNATURE, m_fingerprint, width );
+	}
+	else if ( !m_path.empty() )
+	{
+		out.Create( m_path, CACHE_SIGNATURE, m_fingerprint, nSamples, width );
+	}
+
+	m_bCached = false;	// Until the whole file has been read or written
+
+	for ( int first = 0; first < nSamples; first += m_blockSize )
+	{
+		int const		last	= std::min( first + m_blockSize, nSamples );
+		size_t const	size	= (size_t)( last - first ) * width;
+		Block			block;
+
+		block.first = first;
+		aValues.resize( size );
+
+		if ( in.IsOpen() && in.Read( aValues.data(), size ) )
+		{
+			block.aOutputs.resize( last - first );
+
+			for ( int k = 0; k < last - first; k++ )
+			{
+				float const * const	paSample	= aValues.data() + (size_t)k * width;
+
+				block.aOutputs[k].assign( paSample, paSample + width );
+			}
+		}
+		else
+		{
+			in.Close();
+
+			aBatch.assign( m_aInputs.begin() + first, m_aInputs.begin() + last );
+			m_teacher.EvaluateBatch( aBatch, block.aOutputs );
+
+			if ( out.IsOpen() )
+			{
+				for ( int k = 0; k < last - first; k++ )
+				{
+					std::copy( block.aOutputs[k].begin(), block.aOutputs[k].end(), aValues.data() + (size_t)k * width );
+				}
+
+				out.Write( aValues.data(), size );
+			}
+		}
+
+		{
+			std::unique_lock< std::mutex >	lock( m_mutex );
+
+			m_changed.wait( lock, [this] { return (int)m_blocks.size() < MAX_QUEUED_BLOCKS; } );
+			m_blocks.push_back( std::move( block ) );
+		}
+		m_changed.notify_all();
+	}
+
+	if ( in.IsOpen() )
+	{
+		in.Close();
+		m_bCached = true;
+	}
+
+	if ( out.IsOpen() )
+	{
+		m_bCached = out.Commit();
+	}
+}
@@ -0,0 +1,126 @@
+/** @file *//********************************************************************************************************
+
+                                               DistributedTrainer.cpp
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/DistributedTrainer.cpp#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#include "DistributedTrainer.h"
+
+#include "RingAllReduce.h"
+
+#include <algorithm>
+#include <future>
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	net		The net to train. Its settings (such as a thread pool) are used to compute the changes.
+//! @param	ring	The connection to the other workers.
+
+DistributedTrainer::DistributedTrainer( MultilayerFeedForward & net, RingAllReduce & ring )
+	: m_net( net ),
+	m_ring( ring ),
+	m_loss( 0.f )
+{
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+DistributedTrainer::~DistributedTrainer()
+{
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The other workers contribute zeros to the sum, so every worker gets exactly the first worker's weights. Every
+//! worker must call this before training unless the nets are known to be identical.
+//!
+//! @return		True if the weights were copied.
+
+bool DistributedTrainer::Synchronize()
+{
+	Neuron::WeightVector	aWeights	= m_net.GetWeights();
+
+	if ( m_ring.GetRank() != 0 )
+	{
+		std::fill( aWeights.begin(), aWeights.end(), 0.f );
+	}
+
+	if ( !m_ring.Sum( aWeights.data(), (int)aWeights.size() ) )
+	{
+		return false;
+	}
+
+	m_net.SetWeights( aWeights );
+
+	return true;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The learning rate is applied to the mean of the changes over the samples of all the workers, so the batches may
+//! have different sizes (a worker whose shard is exhausted can even pass an empty batch).
+//!
+//! @param	aInputs		The inputs of this worker's batch.
+//! @param	aTargets	The expected outputs. aTargets[b] is the expected output for aInputs[b].
+//! @param	rate		The learning rate.
+//!
+//! @return		True if the step succeeded. If it fails, the net is not changed and the workers can no longer be
+//!				trained together.
+
+bool DistributedTrainer::Train( NeuralNet::InputBatch const & aInputs, NeuralNet::OutputBatch const & aTargets,
+								float rate )
+{
+	MultilayerFeedForward::Gradients &	gradients	= m_gradients;
+
+	// The loss and the number of samples are summed with the changes to the output weights.
+
+	m_net.ComputeOutputGradients( aInputs, aTargets, gradients );
+	gradients.aOutput.push_back( gradients.loss );
+	gradients.aOutput.push_back( (float)aInputs.size() );
+
+	std::future< bool >	outputSum	= m_ring.SumAsync( gradients.aOutput.data(), (int)gradients.aOutput.size() );
+
+	m_net.ComputeHiddenGradients( aInputs, gradients );
+
+	std::future< bool >	hiddenSum	= m_ring.SumAsync( gradients.aHidden.data(), (int)gradients.aHidden.size() );
+
+	bool const	outputSummed	= outputSum.get();
+	bool const	hiddenSummed	= hiddenSum.get();
+
+	if ( !outputSummed || !hiddenSummed )
+	{
+		return false;
+	}
+
+	float const	nSamples	= gradients.aOutput.back();
+	gradients.aOutput.pop_back();
+	gradients.loss = gradients.aOutput.back();
+	gradients.aOutput.pop_back();
+
+	if ( nSamples > 0.f )
+	{
+		m_loss = gradients.loss / nSamples;
+		m_net.ApplyGradients( gradients, rate / nSamples );
+	}
+
+	return true;
+}
@@ -0,0 +1,340 @@
+/** @file *//********************************************************************************************************
+
+                                                    Ensemble.cpp
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/Ensemble.cpp#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#include "Ensemble.h"
+
+#include "MultilayerFeedForward.h"
+#include "Perceptron.h"
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	nModels		The number of nets.
+//! @param	nInputs		The number of inputs to each net.
+//! @param	nHidden		The number of hidden units in each net. If the value is 0, the nets are Perceptrons.
+//! @param	nOutputs	The number of outputs from each net.
+//!
+//! @note	The weights are initialized to 1, as they are by the Perceptron and MultilayerFeedForward constructors.
+
+Ensemble::Ensemble( int nModels, int nInputs, int nHidden, int nOutputs )
+	: m_nModels( nModels ),
+	m_nInputs( nInputs ),
+	m_nHidden( nHidden ),
+	m_nOutputs( nOutputs ),
+	m_aHiddenWeights( nHidden * nInputs * nModels, 1.f ),
+	m_aHiddenOutputs( nHidden * nModels ),
+	m_aHiddenGradients( nHidden * nModels ),
+	m_aOutputWeights( nOutputs * ( ( nHidden > 0 ) ? nHidden : nInputs ) * nModels, 1.f ),
+	m_aOutputs( nOutputs * nModels ),
+	m_aOutputGradients( nOutputs * nModels ),
+	m_aSums( nModels )
+{
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+Ensemble::~Ensemble()
+{
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	model	Index of the net.
+//! @param	p		The Perceptron to copy the weights from. It must have the same topology as the ensemble.
+
+void Ensemble::Set( int model, Perceptron const & p )
+{
+	assert( m_nHidden == 0 );
+
+	SetWeights( model, p.GetWeights() );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	model	Index of the net.
+//! @param	mff		The MultilayerFeedForward to copy the weights from. It must have the same topology as the ensemble.
+
+void Ensemble::Set( int model, MultilayerFeedForward const & mff )
+{
+	assert( m_nHidden > 0 );
+
+	SetWeights( model, mff.GetWeights() );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	model	Index of the net.
+//!
+//! @return		The weights in the order expected by the Perceptron or MultilayerFeedForward constructor, so that the
+//!				net can be extracted from the ensemble.
+
+Neuron::WeightVector Ensemble::GetWeights( int model ) const
+{
+	assert( model >= 0 && model < m_nModels );
+
+	int const	nHiddenWeights	= (int)m_aHiddenWeights.size() / m_nModels;
+	int const	nOutputWeights	= (int)m_aOutputWeights.size() / m_nModels;
+
+	Neuron::WeightVector	aWeights( nHiddenWeights + nOutputWeights );
+
+	for ( int w = 0; w < nHiddenWeights; w++ )
+	{
+		aWeights[w] = m_aHiddenWeights[w * m_nModels + model];
+	}
+
+	for ( int w = 0; w < nOutputWeights; w++ )
+	{
+		aWeights[nHiddenWeights + w] = m_aOutputWeights[w * m_nModels + model];
+	}
+
+	return aWeights;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	aInputs		The interleaved inputs of every net. Input @a k of net @a m is at <tt>k * nModels + m</tt>.
+//! @return				The interleaved outputs of every net. Output @a i of net @a m is at <tt>i * nModels + m</tt>.
+
+Ensemble::ValueVector const & Ensemble::operator()( ValueVector const & aInputs )
+{
+	assert( (int)aInputs.size() == m_nInputs * m_nModels );
+
+	if ( m_nHidden > 0 )
+	{
+		ForwardLayer( m_aHiddenWeights, m_nHidden, m_nInputs,
+					  &aInputs[0], &m_aHiddenOutputs[0], &m_aHiddenGradients[0] );
+		ForwardLayer( m_aOutputWeights, m_nOutputs, m_nHidden,
+					  &m_aHiddenOutputs[0], &m_aOutputs[0], &m_aOutputGradients[0] );
+	}
+	else
+	{
+		ForwardLayer( m_aOutputWeights, m_nOutputs, m_nInputs, &aInputs[0], &m_aOutputs[0], 0 );
+	}
+
+	return m_aOutputs;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Each net is trained exactly as the corresponding Perceptron or MultilayerFeedForward would be trained.
+//!
+//! @param	aInputs		The interleaved inputs of every net used in the most recent evaluation.
+//! @param	aErrors		The interleaved error values for each output of every net.
+//! @param	rate		The learning rate.
+
+void Ensemble::Train( ValueVector const & aInputs, ValueVector const & aErrors, float rate )
+{
+	assert( (int)aInputs.size() == m_nInputs * m_nModels );
+	assert( (int)aErrors.size() == m_nOutputs * m_nModels );
+
+	if ( m_nHidden == 0 )
+	{
+		AdjustLayer( m_aOutputWeights, m_nOutputs, m_nInputs, &aInputs[0], &aErrors[0], rate );
+		return;
+	}
+
+	int const	nModels		= m_nModels;
+	int const	nOutputs	= m_nOutputs;
+	int const	nHidden		= m_nHidden;
+
+	// Output layer
+
+	float *	const	paOutputGradients	= &m_aOutputGradients[0];
+	float const *	paErrors			= &aErrors[0];
+
+	for ( int i = 0; i < nOutputs * nModels; i++ )
+	{
+		paOutputGradients[i] *= paErrors[i];
+	}
+
+	AdjustLayer( m_aOutputWeights, nOutputs, nHidden, &m_aHiddenOutputs[0], paOutputGradients, rate );
+
+	// Hidden layer. The errors are back-propagated through the adjusted output weights, as they are in
+	// MultilayerFeedForward::Train().
+
+	float * const	paSums	= &m_aSums[0];
+
+	for ( int j = 0; j < nHidden; j++ )
+	{
+		for ( int m = 0; m < nModels; m++ )
+		{
+			paSums[m] = 0.f;
+		}
+
+		for ( int i = 0; i < nOutputs; i++ )
+		{
+			float const * const	paWeights	= &m_aOutputWeights[( i * nHidden + j ) * nModels];
+			float const * const	paGradients	= &paOutputGradients[i * nModels];
+
+			for ( int m = 0; m < nModels; m++ )
+			{
+				paSums[m] += paWeights[m] * paGradients[m];
+			}
+		}
+
+		float * const	paHiddenGradients	= &m_aHiddenGradients[j * nModels];
+
+		for ( int m = 0; m < nModels; m++ )
+		{
+			paHiddenGradients[m] *= paSums[m];
+		}
+	}
+
+	AdjustLayer( m_aHiddenWeights, nHidden, m_nInputs, &aInputs[0], &m_aHiddenGradients[0], rate );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	model		Index of the net.
+//! @param	aWeights	The weights in the order expected by the Perceptron or MultilayerFeedForward constructor.
+
+void Ensemble::SetWeights( int model, Neuron::WeightVector const & aWeights )
+{
+	assert( model >= 0 && model < m_nModels );
+
+	int const	nHiddenWeights	= (int)m_aHiddenWeights.size() / m_nModels;
+	int const	nOutputWeights	= (int)m_aOutputWeights.size() / m_nModels;
+
+	assert( (int)aWeights.size() == nHiddenWeights + nOutputWeights );
+
+	for ( int w = 0; w < nHiddenWeights; w++ )
+	{
+		m_aHiddenWeights[w * m_nModels + model] = aWeights[w];
+	}
+
+	for ( int w = 0; w < nOutputWeights; w++ )
+	{
+		m_aOutputWeights[w * m_nModels + model] = aWeights[nHiddenWeights + w];
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The activation function is the sigmoid function used by Neuron.
+//!
+//! @param	aWeights		The layer's weights, indexed by [unit][input][net].
+//! @param	nUnits			The number of units in the layer.
+//! @param	nInputs			The number of inputs to each unit.
+//! @param	paInputs		The inputs, indexed by [input][net].
+//! @param	paOutputs		Where to store the outputs, indexed by [unit][net].
+//! @param	paGradients		Where to store the gradients of the outputs, indexed by [unit][net] (or 0 if not needed).
+
+void Ensemble::ForwardLayer( ValueVector const & aWeights, int nUnits, int nInputs,
+							 float const * paInputs, float * paOutputs, float * paGradients )
+{
+	int const		nModels	= m_nModels;
+	float * const	paSums	= &m_aSums[0];
+
+	for ( int j = 0; j < nUnits; j++ )
+	{
+		for ( int m = 0; m < nModels; m++ )
+		{
+			paSums[m] = 0.f;
+		}
+
+		for ( int k = 0; k < nInputs; k++ )
+		{
+			float const * const	paWeights	= &aWeights[( j * nInputs + k ) * nModels];
+			float const * const	paValues	= &paInputs[k * nModels];
+
+			for ( int m = 0; m < nModels; m++ )
+			{
+				paSums[m] += paWeights[m] * paValues[m];
+			}
+		}
+
+		float * const	paUnitOutputs	= &paOutputs[j * nModels];
+
+		for ( int m = 0; m < nModels; m++ )
+		{
+			paUnitOutputs[m] = 1.f / ( 1.f + expf( -paSums[m] ) );
+		}
+
+		if ( paGradients != 0 )
+		{
+			float * const	paUnitGradients	= &paGradients[j * nModels];
+
+			for ( int m = 0; m < nModels; m++ )
+			{
+				paUnitGradients[m] = paUnitOutputs[m] * ( 1.f - paUnitOutputs[m] );
+			}
+		}
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The weights for each input are adjusted using the same formula as Neuron::AdjustWeights():
+//! <tt>W[i] += aInputs[i] * e * rate</tt>.
+//!
+//! @param	aWeights	The layer's weights, indexed by [unit][input][net].
+//! @param	nUnits		The number of units in the layer.
+//! @param	nInputs		The number of inputs to each unit.
+//! @param	paInputs	The inputs, indexed by [input][net].
+//! @param	paErrors	The error terms, indexed by [unit][net].
+//! @param	rate		The learning rate.
+
+void Ensemble::AdjustLayer( ValueVector & aWeights, int nUnits, int nInputs,
+							float const * paInputs, float const * paErrors, float rate )
+{
+	int const	nModels	= m_nModels;
+
+	for ( int j = 0; j < nUnits; j++ )
+	{
+		float const * const	paUnitErrors	= &paErrors[j * nModels];
+
+		for ( int k = 0; k < nInputs; k++ )
+		{
+			float * const		paWeights	= &aWeights[( j * nInputs + k ) * nModels];
+			float const * const	paValues	= &paInputs[k * nModels];
+
+			for ( int m = 0; m < nModels; m++ )
+			{
+				paWeights[m] += paValues[m] * paUnitErrors[m] * rate;
+			}
+		}
+	}
+}
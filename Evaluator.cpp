@@ -0,0 +1,296 @@
+/** @file *//********************************************************************************************************
+
+                                                    Evaluator.cpp
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/Evaluator.cpp#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#include "Evaluator.h"
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+//! The number of blocks given to each thread at a time. The metrics of that many blocks are held at once.
+static int const	BLOCKS_PER_THREAD	= 8;
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	aValues		The outputs (or targets).
+//!
+//! @return		The index of the largest value. Ties go to the lowest index.
+
+static int ArgMax( NeuralNet::OutputVector const & aValues )
+{
+	return (int)( std::max_element( aValues.begin(), aValues.end() ) - aValues.begin() );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	nOutputs_	The number of outputs of the net.
+//! @param	nBins		The number of calibration bins.
+
+Evaluator::Metrics::Metrics( int nOutputs_ /* = 0*/, int nBins /* = DEFAULT_BIN_COUNT*/ )
+	: nOutputs( nOutputs_ ),
+	nSamples( 0 ),
+	nCorrect( 0 ),
+	squaredError( 0. ),
+	aConfusion( (size_t)nOutputs_ * nOutputs_, 0 ),
+	aBins( nBins, CalibrationBin() )
+{
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	other	The metrics of other samples, for a net with the same number of outputs and the same number of
+//!					calibration bins.
+
+void Evaluator::Metrics::Merge( Metrics const & other )
+{
+	assert( other.nOutputs == nOutputs );
+	assert( other.aBins.size() == aBins.size() );
+
+	nSamples		+= other.nSamples;
+	nCorrect		+= other.nCorrect;
+	squaredError	+= other.squaredError;
+
+	for ( size_t k = 0; k < aConfusion.size(); k++ )
+	{
+		aConfusion[k] += other.aConfusion[k];
+	}
+
+	for ( size_t b = 0; b < aBins.size(); b++ )
+	{
+		aBins[b].nSamples	+= other.aBins[b].nSamples;
+		aBins[b].nCorrect	+= other.aBins[b].nCorrect;
+		aBins[b].confidence	+= other.aBins[b].confidence;
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+float Evaluator::Metrics::GetMeanSquaredError() const
+{
+	double const	count	= (double)nSamples * nOutputs;
+
+	return ( count > 0. ) ? (float)( squaredError / count ) : 0.f;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+float Evaluator::Metrics::GetAccuracy() const
+{
+	return ( nSamples > 0 ) ? (float)( (double)nCorrect / (double)nSamples ) : 0.f;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The expected calibration error is the mean over the samples of the difference between the accuracy and the mean
+//! confidence of the predictions in the sample's bin. A well-calibrated net, whose predictions with a confidence of
+//! 0.8 are right 80% of the time, has an error near 0.
+//!
+//! @return		The expected calibration error, from 0 to 1.
+
+float Evaluator::Metrics::GetCalibrationError() const
+{
+	double	error	= 0.;
+
+	for ( size_t b = 0; b < aBins.size(); b++ )
+	{
+		CalibrationBin const &	bin	= aBins[b];
+
+		error += std::fabs( (double)bin.nCorrect - bin.confidence );	// = nSamples * |accuracy - mean confidence|
+	}
+
+	return ( nSamples > 0 ) ? (float)( error / (double)nSamples ) : 0.f;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	pPool		The thread pool used to evaluate the blocks (or 0 if none). If a net that is evaluated uses the
+//!						same pool to evaluate its units, its units are evaluated serially, since a call to
+//!						ThreadPool::ParallelFor() from inside the pool runs on the calling thread.
+//! @param	blockSize	The number of samples evaluated together.
+//! @param	nBins		The number of calibration bins. The confidences from 0 to 1 are split evenly among them.
+
+Evaluator::Evaluator( ThreadPool * pPool /* = 0*/,
+					  int blockSize /* = DEFAULT_BLOCK_SIZE*/,
+					  int nBins /* = DEFAULT_BIN_COUNT*/ )
+	: m_pPool( pPool ),
+	m_blockSize( blockSize ),
+	m_nBins( nBins )
+{
+	assert( blockSize > 0 );
+	assert( nBins > 0 );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+Evaluator::~Evaluator()
+{
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	net			The net.
+//! @param	aInputs		The inputs of the data set.
+//! @param	aTargets	The expected outputs of the data set. aTargets[i] is the expected output for aInputs[i].
+//!
+//! @return		The metrics of the net over the data set.
+
+Evaluator::Metrics Evaluator::Evaluate( NeuralNet const & net,
+										NeuralNet::InputBatch const & aInputs,
+										NeuralNet::OutputBatch const & aTargets ) const
+{
+	assert( aInputs.size() == aTargets.size() );
+
+	int const	nOutputs	= net.GetOutputCount();
+	int const	nSamples	= (int)aInputs.size();
+	int const	nBlocks		= ( nSamples + m_blockSize - 1 ) / m_blockSize;
+	int const	nThreads	= ( m_pPool != 0 ) ? m_pPool->GetThreadCount() : 1;
+	int const	groupSize	= nThreads * BLOCKS_PER_THREAD;
+	Metrics		total( nOutputs, m_nBins );
+
+	// The blocks are processed in groups, so that only the metrics of one group of blocks are held at once.
+
+	std::vector< Metrics >	aPartials( std::min( groupSize, nBlocks ), Metrics( nOutputs, m_nBins ) );
+
+	for ( int firstBlock = 0; firstBlock < nBlocks; firstBlock += groupSize )
+	{
+		int const	nGroupBlocks	= std::min( groupSize, nBlocks - firstBlock );
+
+		auto const	evaluateBlocks	= [&] ( int first, int last )
+		{
+			for ( int b = first; b < last; b++ )
+			{
+				int const	firstSample	= ( firstBlock + b ) * m_blockSize;
+				int const	lastSample	= std::min( firstSample + m_blockSize, nSamples );
+
+				aPartials[b] = Metrics( nOutputs, m_nBins );
+				EvaluateBlock( net, aInputs, aTargets, firstSample, lastSample, aPartials[b] );
+			}
+		};
+
+		if ( m_pPool != 0 )
+		{
+			m_pPool->ParallelFor( nGroupBlocks, 1, evaluateBlocks );
+		}
+		else
+		{
+			evaluateBlocks( 0, nGroupBlocks );
+		}
+
+		for ( int b = 0; b < nGroupBlocks; b++ )
+		{
+			total.Merge( aPartials[b] );
+		}
+	}
+
+	return total;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The inputs and the outputs of the block are kept in buffers owned by the calling thread, so they are allocated only
+//! once by each thread.
+//!
+//! @param	net			The net.
+//! @param	aInputs		The inputs of the data set.
+//! @param	aTargets	The expected outputs of the data set.
+//! @param	first		The first sample of the block.
+//! @param	last		The sample after the last sample of the block.
+//! @param	metrics		The metrics to add the block's samples to.
+
+void Evaluator::EvaluateBlock( NeuralNet const & net,
+							   NeuralNet::InputBatch const & aInputs,
+							   NeuralNet::OutputBatch const & aTargets,
+							   int first,
+							   int last,
+							   Metrics & metrics ) const
+{
+	static thread_local NeuralNet::InputBatch	aBlockInputs;
+	static thread_local NeuralNet::OutputBatch	aBlockOutputs;
+
+	int const	nOutputs	= metrics.nOutputs;
+
+	aBlockInputs.assign( aInputs.begin() + first, aInputs.begin() + last );
+	net.EvaluateBatch( aBlockInputs, aBlockOutputs );
+
+	for ( int i = first; i < last; i++ )
+	{
+		NeuralNet::OutputVector const &	aOutput	= aBlockOutputs[i - first];
+		NeuralNet::OutputVector const &	aTarget	= aTargets[i];
+
+		assert( (int)aTarget.size() == nOutputs );
+
+		double	error	= 0.;
+
+		for ( int j = 0; j < nOutputs; j++ )
+		{
+			double const	e	= aTarget[j] - aOutput[j];
+			error += e * e;
+		}
+
+		metrics.squaredError += error;
+
+		if ( nOutputs == 0 )
+		{
+			continue;
+		}
+
+		int const	actual		= ArgMax( aTarget );
+		int const	predicted	= ArgMax( aOutput );
+		bool const	correct		= ( actual == predicted );
+		float const	confidence	= std::min( std::max( aOutput[predicted], 0.f ), 1.f );
+		int const	bin			= std::min( (int)( confidence * m_nBins ), m_nBins - 1 );
+
+		metrics.nCorrect += correct ? 1 : 0;
+		metrics.aConfusion[(size_t)actual * nOutputs + predicted] += 1;
+
+		CalibrationBin &	calibration	= metrics.aBins[bin];
+
+		calibration.nSamples	+= 1;
+		calibration.nCorrect	+= correct ? 1 : 0;
+		calibration.confidence	+= confidence;
+	}
+
+	metrics.nSamples += last - first;
+}
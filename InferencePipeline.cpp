@@ -0,0 +1,235 @@
+/** @file *//********************************************************************************************************
+
+                                                InferencePipeline.cpp
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/InferencePipeline.cpp#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#include "InferencePipeline.h"
+
+#include "MultilayerFeedForward.h"
+
+#include <cassert>
+#include <chrono>
+
+#if defined( __linux__ )
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+//! The number of times an idle stage yields the processor before it starts sleeping.
+static int const	MAX_YIELDS	= 1000;
+
+//! How long an idle stage sleeps between polls of its ring, after it has yielded MAX_YIELDS times.
+static std::chrono::microseconds const	IDLE_SLEEP( 50 );
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	thread	The thread.
+//! @param	core	The index of the core, or a negative number if the thread should not be pinned.
+//!
+//! @note	Threads are only pinned on Linux. Elsewhere, the operating system chooses the cores.
+
+static void PinToCore( std::thread & thread, int core )
+{
+#if defined( __linux__ )
+	if ( core >= 0 && core < CPU_SETSIZE )
+	{
+		cpu_set_t	cores;
+
+		CPU_ZERO( &cores );
+		CPU_SET( core, &cores );
+		pthread_setaffinity_np( thread.native_handle(), sizeof( cores ), &cores );
+	}
+#else
+	(void)thread;
+	(void)core;
+#endif
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	nIdle	The number of times in a row that the caller has found nothing to do. It is incremented.
+
+static void Idle( int & nIdle )
+{
+	if ( ++nIdle < MAX_YIELDS )
+	{
+		std::this_thread::yield();
+	}
+	else
+	{
+		std::this_thread::sleep_for( IDLE_SLEEP );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	net			The net. It must not be changed while the pipeline exists.
+//! @param	capacity	The maximum number of inputs in the pipeline at once. It must be a power of 2. A larger
+//!						capacity absorbs more variation in the rate of the inputs.
+//! @param	aCores		The core to pin the thread of each stage to (the hidden stage first), or an empty vector if
+//!						the threads should not be pinned. A negative index leaves that stage's thread unpinned.
+
+InferencePipeline::InferencePipeline( MultilayerFeedForward const & net,
+									  int capacity /* = DEFAULT_CAPACITY*/,
+									  std::vector< int > const & aCores /* = std::vector< int >()*/ )
+	: m_net( net ),
+	m_aSlots( capacity ),
+	m_free( capacity ),
+	m_inputs( capacity ),
+	m_hidden( capacity ),
+	m_outputs( capacity ),
+	m_bQuit( false )
+{
+	assert( aCores.empty() || (int)aCores.size() == NUM_STAGES );
+
+	// The buffers are allocated in advance, so the stages never allocate memory.
+
+	for ( int i = 0; i < capacity; i++ )
+	{
+		m_aSlots[i].aInputs.resize( net.GetInputCount() );
+		m_aSlots[i].aHiddenOutputs.resize( net.GetHiddenCount() );
+		m_aSlots[i].aOutputs.resize( net.GetOutputCount() );
+		m_free.Push( i );
+	}
+
+	for ( int stage = 0; stage < NUM_STAGES; stage++ )
+	{
+		m_aThreads.push_back( std::thread( &InferencePipeline::Run, this, Stage( stage ) ) );
+
+		if ( !aCores.empty() )
+		{
+			PinToCore( m_aThreads.back(), aCores[stage] );
+		}
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Inputs whose outputs have not been popped are discarded.
+
+InferencePipeline::~InferencePipeline()
+{
+	m_bQuit.store( true, std::memory_order_relaxed );
+
+	for ( int stage = 0; stage < NUM_STAGES; stage++ )
+	{
+		m_aThreads[stage].join();
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	aInputs		The input values.
+//!
+//! @return		True if the input was added, or false if the pipeline is full.
+
+bool InferencePipeline::Push( Neuron::InputVector const & aInputs )
+{
+	assert( (int)aInputs.size() == m_net.GetInputCount() );
+
+	int	slot;
+
+	if ( !m_free.Pop( slot ) )
+	{
+		return false;
+	}
+
+	m_aSlots[slot].aInputs = aInputs;
+
+	bool const	pushed	= m_inputs.Push( slot );	// There is room in the ring for every slot
+
+	assert( pushed );
+	(void)pushed;
+
+	return true;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	aOutputs	Where to store the output values.
+//!
+//! @return		True if outputs were removed, or false if the outputs of the oldest input are not ready yet.
+
+bool InferencePipeline::Pop( NeuralNet::OutputVector & aOutputs )
+{
+	int	slot;
+
+	if ( !m_outputs.Pop( slot ) )
+	{
+		return false;
+	}
+
+	aOutputs = m_aSlots[slot].aOutputs;
+	m_free.Push( slot );
+
+	return true;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	stage	The stage.
+
+void InferencePipeline::Run( Stage stage )
+{
+	SpscRing< int > &	input	= ( stage == HIDDEN_STAGE ) ? m_inputs : m_hidden;
+	SpscRing< int > &	output	= ( stage == HIDDEN_STAGE ) ? m_hidden : m_outputs;
+	int					nIdle	= 0;
+
+	while ( !m_bQuit.load( std::memory_order_relaxed ) )
+	{
+		int	slot;
+
+		if ( !input.Pop( slot ) )
+		{
+			Idle( nIdle );
+			continue;
+		}
+
+		nIdle = 0;
+
+		Slot &	s	= m_aSlots[slot];
+
+		if ( stage == HIDDEN_STAGE )
+		{
+			m_net.EvaluateHidden( s.aInputs, s.aHiddenOutputs );
+		}
+		else
+		{
+			m_net.EvaluateOutputs( s.aHiddenOutputs.data(), s.aOutputs );
+		}
+
+		bool const	pushed	= output.Push( slot );	// There is room in the ring for every slot
+
+		assert( pushed );
+		(void)pushed;
+	}
+}
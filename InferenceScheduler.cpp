@@ -0,0 +1,245 @@
+/** @file *//********************************************************************************************************
+
+                                               InferenceScheduler.cpp
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/InferenceScheduler.cpp#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#include "InferenceScheduler.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	value	The value to add.
+
+void InferenceScheduler::Histogram::Add( double value )
+{
+	int	bucket	= 0;
+
+	if ( value >= 1. )
+	{
+		bucket = (int)std::floor( std::log2( value ) ) + 1;
+	}
+
+	if ( (int)aCounts.size() <= bucket )
+	{
+		aCounts.resize( bucket + 1, 0 );
+	}
+
+	++aCounts[bucket];
+	++count;
+	sum += value;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	net				The net that evaluates the requests. It must not be changed while the scheduler exists.
+//! @param	maxBatchSize	The maximum number of requests in a batch.
+//! @param	maxDelay		The longest a request waits in the queue for a batch to fill.
+//! @param	nThreads		The number of worker threads.
+
+InferenceScheduler::InferenceScheduler( NeuralNet const & net, int maxBatchSize, std::chrono::microseconds maxDelay,
+										int nThreads /* = 1*/ )
+	: m_net( net ),
+	m_maxBatchSize( maxBatchSize ),
+	m_maxDelay( maxDelay ),
+	m_bQuit( false )
+{
+	assert( maxBatchSize > 0 );
+	assert( nThreads > 0 );
+
+	for ( int i = 0; i < nThreads; i++ )
+	{
+		m_aThreads.push_back( std::thread( &InferenceScheduler::Run, this ) );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The requests still in the queue are processed before the worker threads exit.
+
+InferenceScheduler::~InferenceScheduler()
+{
+	{
+		std::lock_guard< std::mutex >	lock( m_mutex );
+		m_bQuit = true;
+	}
+	m_ready.notify_all();
+
+	for ( size_t i = 0; i < m_aThreads.size(); i++ )
+	{
+		m_aThreads[i].join();
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	aInputs		The inputs.
+//!
+//! @return		A future for the outputs.
+
+std::future< NeuralNet::OutputVector > InferenceScheduler::Submit( Neuron::InputVector const & aInputs )
+{
+	Request	request;
+	request.aInputs = aInputs;
+
+	std::future< NeuralNet::OutputVector >	future	= request.promise.get_future();
+
+	Enqueue( request );
+
+	return future;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	aInputs		The inputs.
+//! @param	callback	The function that receives the outputs. It is called on a worker thread.
+
+void InferenceScheduler::Submit( Neuron::InputVector const & aInputs, Callback const & callback )
+{
+	Request	request;
+	request.aInputs		= aInputs;
+	request.callback	= callback;
+
+	Enqueue( request );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+InferenceScheduler::Statistics InferenceScheduler::GetStatistics() const
+{
+	std::lock_guard< std::mutex >	lock( m_mutex );
+
+	return m_statistics;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	request		The request. Its contents are moved into the queue.
+
+void InferenceScheduler::Enqueue( Request & request )
+{
+	request.arrival = Clock::now();
+
+	{
+		std::lock_guard< std::mutex >	lock( m_mutex );
+		m_queue.push_back( std::move( request ) );
+	}
+
+	m_ready.notify_one();
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+void InferenceScheduler::Run()
+{
+	NeuralNet::InputBatch		aInputs;
+	NeuralNet::OutputBatch		aOutputs;
+	std::vector< Request >		aBatch;
+
+	std::unique_lock< std::mutex >	lock( m_mutex );
+
+	for ( ;; )
+	{
+		m_ready.wait( lock, [this] { return m_bQuit || !m_queue.empty(); } );
+
+		if ( m_queue.empty() )
+		{
+			return;		// Quitting and there is nothing left to do
+		}
+
+		// Wait for the batch to fill, but no longer than the oldest request's deadline.
+
+		Clock::time_point const	deadline	= m_queue.front().arrival + m_maxDelay;
+
+		m_ready.wait_until( lock, deadline, [this] { return m_bQuit || (int)m_queue.size() >= m_maxBatchSize; } );
+
+		if ( m_queue.empty() )
+		{
+			continue;	// Another worker took the requests
+		}
+
+		// Take a batch
+
+		int const				size	= std::min( (int)m_queue.size(), m_maxBatchSize );
+		Clock::time_point const	now		= Clock::now();
+
+		aBatch.clear();
+		for ( int b = 0; b < size; b++ )
+		{
+			Request &	request	= m_queue.front();
+
+			m_statistics.queueDelays.Add(
+				(double)std::chrono::duration_cast< std::chrono::microseconds >( now - request.arrival ).count() );
+			aBatch.push_back( std::move( request ) );
+			m_queue.pop_front();
+		}
+		m_statistics.batchSizes.Add( size );
+
+		// If there are more requests, let another worker start on them.
+
+		if ( !m_queue.empty() )
+		{
+			m_ready.notify_one();
+		}
+
+		lock.unlock();
+
+		// Evaluate the batch and deliver the results
+
+		aInputs.resize( size );
+		for ( int b = 0; b < size; b++ )
+		{
+			aInputs[b].swap( aBatch[b].aInputs );
+		}
+
+		m_net.EvaluateBatch( aInputs, aOutputs );
+
+		for ( int b = 0; b < size; b++ )
+		{
+			if ( aBatch[b].callback )
+			{
+				aBatch[b].callback( aOutputs[b] );
+			}
+			else
+			{
+				aBatch[b].promise.set_value( aOutputs[b] );
+			}
+		}
+
+		lock.lock();
+	}
+}
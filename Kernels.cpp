@@ -0,0 +1,197 @@
+/** @file *//********************************************************************************************************
+
+                                                     Kernels.cpp
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/Kernels.cpp#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#include "Kernels.h"
+
+#include "Neuron.h"
+
+#include <cassert>
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	paInputs	The inputs.
+//! @param	nInputs		The number of inputs.
+//! @param	papWeights	The weights of each unit in the block.
+//! @param	paSums		Where to store the combined input of each unit in the block.
+//!
+//! @note	The UNROLL partial sums of a unit are added in a fixed order, so the result depends only on the
+//!			configuration and not on how the layer is split into tiles.
+
+template< int UNROLL, int BLOCK >
+static void ComputeBlock( float const * paInputs, int nInputs, float const * const * papWeights, float * paSums )
+{
+	float	aPartial[BLOCK][UNROLL];
+
+	for ( int b = 0; b < BLOCK; b++ )
+	{
+		for ( int u = 0; u < UNROLL; u++ )
+		{
+			aPartial[b][u] = 0.f;
+		}
+	}
+
+	int const	nFull	= nInputs - nInputs % UNROLL;
+	int			i		= 0;
+
+	for ( ; i < nFull; i += UNROLL )
+	{
+		for ( int b = 0; b < BLOCK; b++ )
+		{
+			for ( int u = 0; u < UNROLL; u++ )
+			{
+				aPartial[b][u] += paInputs[i + u] * papWeights[b][i + u];
+			}
+		}
+	}
+
+	for ( ; i < nInputs; i++ )
+	{
+		for ( int b = 0; b < BLOCK; b++ )
+		{
+			aPartial[b][0] += paInputs[i] * papWeights[b][i];
+		}
+	}
+
+	for ( int b = 0; b < BLOCK; b++ )
+	{
+		// Add the partial sums pairwise.
+
+		for ( int width = UNROLL / 2; width > 0; width /= 2 )
+		{
+			for ( int u = 0; u < width; u++ )
+			{
+				aPartial[b][u] += aPartial[b][u + width];
+			}
+		}
+
+		paSums[b] = aPartial[b][0];
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	paUnits		The units.
+//! @param	nUnits		The number of units.
+//! @param	paInputs	The inputs.
+//! @param	paSums		Where to store the combined input of each unit.
+
+template< int UNROLL, int BLOCK >
+static void ComputeSums( Neuron const * paUnits, int nUnits, float const * paInputs, float * paSums )
+{
+	if ( nUnits == 0 )
+	{
+		return;
+	}
+
+	int const	nInputs	= (int)paUnits[0].GetWeights().size();
+	int			j		= 0;
+
+	for ( ; j + BLOCK <= nUnits; j += BLOCK )
+	{
+		float const *	apWeights[BLOCK];
+
+		for ( int b = 0; b < BLOCK; b++ )
+		{
+			apWeights[b] = paUnits[j + b].GetWeights().data();
+		}
+
+		ComputeBlock< UNROLL, BLOCK >( paInputs, nInputs, apWeights, &paSums[j] );
+	}
+
+	// The remaining units are computed one at a time.
+
+	for ( ; j < nUnits; j++ )
+	{
+		float const *	pWeights	= paUnits[j].GetWeights().data();
+
+		ComputeBlock< UNROLL, 1 >( paInputs, nInputs, &pWeights, &paSums[j] );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+bool KernelConfig::IsValid() const
+{
+	return ( unroll == 1 || unroll == 4 || unroll == 8 ) &&
+		   ( unitBlock == 1 || unitBlock == 2 || unitBlock == 4 ) &&
+		   tileSize >= 0;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+std::vector< KernelConfig > KernelConfig::GetCandidates()
+{
+	static int const	UNROLLS[]		= { 1, 4, 8 };
+	static int const	UNIT_BLOCKS[]	= { 1, 2, 4 };
+
+	std::vector< KernelConfig >	aCandidates;
+
+	for ( int u = 0; u < (int)( sizeof( UNROLLS ) / sizeof( UNROLLS[0] ) ); u++ )
+	{
+		for ( int b = 0; b < (int)( sizeof( UNIT_BLOCKS ) / sizeof( UNIT_BLOCKS[0] ) ); b++ )
+		{
+			aCandidates.push_back( KernelConfig( UNROLLS[u], UNIT_BLOCKS[b] ) );
+		}
+	}
+
+	return aCandidates;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Computing several partial sums per unit breaks the dependency between successive additions so that they can be
+//! pipelined or vectorized. Computing several units together loads each input once for the whole block.
+//!
+//! @param	config		The kernel configuration.
+//! @param	paUnits		The units. Every unit must have the same number of inputs.
+//! @param	nUnits		The number of units.
+//! @param	paInputs	The inputs to every unit.
+//! @param	paSums		Where to store the combined input of each unit.
+//!
+//! @note	With the default configuration, the sums are computed in the same order as Neuron::Input(), so the results
+//!			are identical. Other configurations add the products in a different order and may differ slightly.
+
+void ComputeSums( KernelConfig const & config, Neuron const * paUnits, int nUnits, float const * paInputs,
+				  float * paSums )
+{
+	assert( config.IsValid() );
+
+	switch ( config.unroll * 10 + config.unitBlock )
+	{
+	case 11:	ComputeSums< 1, 1 >( paUnits, nUnits, paInputs, paSums );	break;
+	case 12:	ComputeSums< 1, 2 >( paUnits, nUnits, paInputs, paSums );	break;
+	case 14:	ComputeSums< 1, 4 >( paUnits, nUnits, paInputs, paSums );	break;
+	case 41:	ComputeSums< 4, 1 >( paUnits, nUnits, paInputs, paSums );	break;
+	case 42:	ComputeSums< 4, 2 >( paUnits, nUnits, paInputs, paSums );	break;
+	case 44:	ComputeSums< 4, 4 >( paUnits, nUnits, paInputs, paSums );	break;
+	case 81:	ComputeSums< 8, 1 >( paUnits, nUnits, paInputs, paSums );	break;
+	case 82:	ComputeSums< 8, 2 >( paUnits, nUnits, paInputs, paSums );	break;
+	case 84:	ComputeSums< 8, 4 >( paUnits, nUnits, paInputs, paSums );	break;
+	default:	assert( false );											break;
+	}
+}
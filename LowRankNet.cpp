@@ -0,0 +1,759 @@
+/** @file *//********************************************************************************************************
+
+                                                   LowRankNet.cpp
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/LowRankNet.cpp#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#include "LowRankNet.h"
+
+#include "Kernels.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+
+//! The maximum number of sweeps of the Jacobi method.
+static int const	MAX_SWEEPS			= 50;
+
+//! Off-diagonal elements smaller than this (relative to the matrix) are treated as 0 by the Jacobi method.
+static double const	JACOBI_TOLERANCE	= 1.e-15;
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The cyclic Jacobi method zeroes each off-diagonal element in turn with a rotation, until the matrix is diagonal.
+//! It is slower than the methods in numerical libraries, but it is simple and very accurate, and it only needs to be
+//! done once for each layer.
+//!
+//! @param	aMatrix		A symmetric @a n x @a n matrix, in row-major order. It is destroyed.
+//! @param	n			The size of the matrix.
+//! @param	aValues		Where to store the eigenvalues, largest first.
+//! @param	aVectors	Where to store the eigenvectors, in row-major order. Column @a c is the eigenvector of
+//!						eigenvalue @a c.
+
+static void EigenDecompose( std::vector< double > & aMatrix, int n, std::vector< double > & aValues,
+							std::vector< double > & aVectors )
+{
+	std::vector< double >	aRotated( (size_t)n * n, 0. );
+
+	for ( int i = 0; i < n; i++ )
+	{
+		aRotated[(size_t)i * n + i] = 1.;
+	}
+
+	double const	norm	= std::sqrt( std::inner_product( aMatrix.begin(), aMatrix.end(), aMatrix.begin(), 0. ) );
+
+	for ( int sweep = 0; sweep < MAX_SWEEPS; sweep++ )
+	{
+		bool	rotated	= false;
+
+		for ( int p = 0; p < n - 1; p++ )
+		{
+			for ( int q = p + 1; q < n; q++ )
+			{
+				double const	app	= aMatrix[(size_t)p * n + p];
+				double const	aqq	= aMatrix[(size_t)q * n + q];
+				double const	apq	= aMatrix[(size_t)p * n + q];
+
+				if ( std::fabs( apq ) <= JACOBI_TOLERANCE * std::sqrt( std::fabs( app * aqq ) ) ||
+					 std::fabs( apq ) <= JACOBI_TOLERANCE * norm )
+				{
+					continue;
+				}
+
+				// Find the rotation that zeroes apq.
+
+				double const	theta	= ( aqq - app ) / ( 2. * apq );
+				double const	t		= ( ( theta >= 0. ) ? 1. : -1. ) / ( std::fabs( theta ) +
+																		 std::sqrt( theta * theta + 1. ) );
+				double const	c		= 1. / std::sqrt( t * t + 1. );
+				double const	s		= t * c;
+
+				for ( int r = 0; r < n; r++ )
+				{
+					double const	arp	= aMatrix[(size_t)r * n + p];
+					double const	arq	= aMatrix[(size_t)r * n + q];
+
+					aMatrix[(size_t)r * n + p]	= c * arp - s * arq;
+					aMatrix[(size_t)r * n + q]	= s * arp + c * arq;
+				}
+
+				for ( int r = 0; r < n; r++ )
+				{
+					double const	apr	= aMatrix[(size_t)p * n + r];
+					double const	aqr	= aMatrix[(size_t)q * n + r];
+
+					aMatrix[(size_t)p * n + r]	= c * apr - s * aqr;
+					aMatrix[(size_t)q * n + r]	= s * apr + c * aqr;
+				}
+
+				for ( int r = 0; r < n; r++ )
+				{
+					double const	vrp	= aRotated[(size_t)r * n + p];
+					double const	vrq	= aRotated[(size_t)r * n + q];
+
+					aRotated[(size_t)r * n + p]	= c * vrp - s * vrq;
+					aRotated[(size_t)r * n + q]	= s * vrp + c * vrq;
+				}
+
+				aMatrix[(size_t)p * n + q] = 0.;
+				aMatrix[(size_t)q * n + p] = 0.;
+				rotated = true;
+			}
+		}
+
+		if ( !rotated )
+		{
+			break;
+		}
+	}
+
+	// Sort the eigenvalues, largest first. Round-off can make an eigenvalue of a Gram matrix slightly negative.
+
+	std::vector< int >	aOrder( n );
+
+	std::iota( aOrder.begin(), aOrder.end(), 0 );
+	std::stable_sort( aOrder.begin(), aOrder.end(), [&aMatrix, n] ( int a, int b )
+	{
+		return aMatrix[(size_t)a * n + a] > aMatrix[(size_t)b * n + b];
+	} );
+
+	aValues.resize( n );
+	aVectors.resize( (size_t)n * n );
+
+	for ( int c = 0; c < n; c++ )
+	{
+		aValues[c] = std::max( aMatrix[(size_t)aOrder[c] * n + aOrder[c]], 0. );
+
+		for ( int r = 0; r < n; r++ )
+		{
+			aVectors[(size_t)r * n + c] = aRotated[(size_t)r * n + aOrder[c]];
+		}
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+LowRankNet::LowRankNet()
+{
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	mff			The net to compress. It is not changed.
+//! @param	criterion	How the rank of each layer is chosen.
+//! @param	target		For MAX_ERROR, the largest relative error allowed in the weights of a layer (for example,
+//!						.01). For MIN_SPEEDUP, the factor by which the number of multiplications in a layer must be
+//!						reduced (for example, 4).
+
+LowRankNet::LowRankNet( MultilayerFeedForward const & mff, Criterion criterion, float target )
+	: NeuralNet( mff.GetInputCount(), mff.GetOutputCount() ),
+	m_aHiddenOutputs( mff.GetHiddenCount() ),
+	m_aHiddenGradients( mff.GetHiddenCount() ),
+	m_aOutputGradients( mff.GetOutputCount() )
+{
+	assert( target > 0.f );
+
+	int const					nHidden		= mff.GetHiddenCount();
+	int const					nOutputs	= mff.GetOutputCount();
+	Neuron::WeightVector const	aWeights	= mff.GetWeights();		// The hidden units come first
+
+	Factorize( aWeights.data(), nHidden, m_nInputs, criterion, target, m_hidden );
+	Factorize( aWeights.data() + nHidden * m_nInputs, nOutputs, nHidden, criterion, target, m_output );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+LowRankNet::~LowRankNet()
+{
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+int LowRankNet::GetWeightCount() const
+{
+	int	count	= 0;
+
+	for ( Layer const * pLayer : { &m_hidden, &m_output } )
+	{
+		for ( Neuron const & unit : pLayer->aProjection )
+		{
+			count += (int)unit.GetWeights().size();
+		}
+
+		for ( Neuron const & unit : pLayer->aUnits )
+		{
+			count += (int)unit.GetWeights().size();
+		}
+	}
+
+	return count;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	aInputs		The input values.
+//!
+//! @return		A vector of output values.
+
+LowRankNet::OutputVector const & LowRankNet::operator()( Neuron::InputVector const & aInputs )
+{
+	assert( (int)aInputs.size() == m_nInputs );
+
+	m_aInputs = aInputs;
+
+	ComputeLayerSums( m_hidden, m_aInputs.data(), m_aHiddenProjected, m_aHiddenOutputs );
+
+	for ( int j = 0; j < (int)m_aHiddenOutputs.size(); j++ )
+	{
+		m_aHiddenOutputs[j] = m_hidden.aUnits[j].Activation( m_aHiddenOutputs[j], &m_aHiddenGradients[j] );
+	}
+
+	ComputeLayerSums( m_output, m_aHiddenOutputs.data(), m_aOutputProjected, m_aOutputs );
+
+	for ( int i = 0; i < (int)m_aOutputs.size(); i++ )
+	{
+		m_aOutputs[i] = m_output.aUnits[i].Activation( m_aOutputs[i], &m_aOutputGradients[i] );
+	}
+
+	return m_aOutputs;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The intermediate values are stored in buffers local to the calling thread.
+
+void LowRankNet::Evaluate( Neuron::InputVector const & aInputs, OutputVector & aOutputs ) const
+{
+	static thread_local OutputVector	aHiddenOutputs;
+	static thread_local OutputVector	aProjected;
+
+	EvaluateHidden( aInputs, aHiddenOutputs );
+	ComputeLayerSums( m_output, aHiddenOutputs.data(), aProjected, aOutputs );
+
+	for ( int i = 0; i < (int)aOutputs.size(); i++ )
+	{
+		aOutputs[i] = m_output.aUnits[i].Activation( aOutputs[i] );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The intermediate values are stored in buffers local to the calling thread. The projection of a factorized output
+//! layer is computed in full, since it is shared by all the outputs.
+
+void LowRankNet::EvaluateSelected( Neuron::InputVector const & aInputs, IndexVector const & aIndexes,
+								   OutputVector & aOutputs ) const
+{
+	static thread_local OutputVector	aHiddenOutputs;
+	static thread_local OutputVector	aProjected;
+
+	EvaluateHidden( aInputs, aHiddenOutputs );
+
+	int const						rank		= (int)m_output.aProjection.size();
+	Neuron::InputVector const *		paInputs	= &aHiddenOutputs;
+
+	if ( rank > 0 )
+	{
+		aProjected.resize( rank );
+		ComputeSums( KernelConfig(), m_output.aProjection.data(), rank, aHiddenOutputs.data(), aProjected.data() );
+		paInputs = &aProjected;
+	}
+
+	int const	size	= (int)aIndexes.size();
+
+	aOutputs.resize( size );
+
+	for ( int k = 0; k < size; k++ )
+	{
+		aOutputs[k] = m_output.aUnits[aIndexes[k]]( *paInputs );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The intermediate values are stored in buffers local to the calling thread.
+
+void LowRankNet::TopK( Neuron::InputVector const & aInputs, int k, RankedOutputVector & aBest ) const
+{
+	static thread_local OutputVector	aHiddenOutputs;
+	static thread_local OutputVector	aProjected;
+	static thread_local OutputVector	aSums;
+
+	aBest.clear();
+
+	if ( m_output.aUnits.empty() )
+	{
+		return;
+	}
+
+	EvaluateHidden( aInputs, aHiddenOutputs );
+	ComputeLayerSums( m_output, aHiddenOutputs.data(), aProjected, aSums );
+
+	for ( int i = 0; i < (int)aSums.size(); i++ )
+	{
+		AddCandidate( aBest, k, i, aSums[i] );
+	}
+
+	FinishCandidates( aBest, m_output.aUnits[0] );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	pResource	The memory resource. It must outlive the net and its copies.
+
+void LowRankNet::SetMemoryResource( std::pmr::memory_resource * pResource )
+{
+	for ( Layer * pLayer : { &m_hidden, &m_output } )
+	{
+		for ( Neuron & unit : pLayer->aProjection )
+		{
+			unit.SetMemoryResource( pResource );
+		}
+
+		for ( Neuron & unit : pLayer->aUnits )
+		{
+			unit.SetMemoryResource( pResource );
+		}
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The errors are back-propagated through both factors of a factorized layer, so a short run of training (using a
+//! smaller learning rate than the original training) recovers some of the accuracy lost in the compression. The
+//! error terms of each layer are computed before its weights are changed.
+//!
+//! @param	aInputs		The input values. They must be the inputs of the most recent call to operator().
+//! @param	aErrors		The error values for each output.
+//! @param	rate		The learning rate.
+
+void LowRankNet::Train( Neuron::InputVector const & aInputs, ErrorVector const & aErrors, float rate )
+{
+	assert( aInputs == m_aInputs );
+	assert( aErrors.size() == m_aOutputGradients.size() );
+
+	UpdateVersion();
+
+	for ( int i = 0; i < (int)m_aOutputGradients.size(); i++ )
+	{
+		m_aOutputGradients[i] *= aErrors[i];
+	}
+
+	BackPropagate( m_output, m_aHiddenOutputs, m_aOutputProjected, m_aOutputGradients, &m_aPropagated, rate );
+
+	for ( int j = 0; j < (int)m_aHiddenGradients.size(); j++ )
+	{
+		m_aHiddenGradients[j] *= m_aPropagated[j];
+	}
+
+	BackPropagate( m_hidden, aInputs, m_aHiddenProjected, m_aHiddenGradients, 0, rate );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The weights are approximated with a truncated singular value decomposition. The singular values and vectors are
+//! computed from the eigendecomposition of the smaller of the two Gram matrices of the weights.
+//!
+//! @param	paWeights	The weights of the layer. The weights of each unit are stored together.
+//! @param	nUnits		The number of units.
+//! @param	nInputs		The number of inputs of each unit.
+//! @param	criterion	How the rank is chosen.
+//! @param	target		The target error or speedup.
+//! @param	layer		Where to store the layer.
+
+void LowRankNet::Factorize( float const * paWeights, int nUnits, int nInputs, Criterion criterion, float target,
+							Layer & layer )
+{
+	int const	size	= std::min( nUnits, nInputs );
+	bool const	left	= ( nUnits <= nInputs );	// If true, the eigenvectors are the left singular vectors
+
+	// Compute the Gram matrix and its eigendecomposition.
+
+	std::vector< double >	aGram( (size_t)size * size );
+	std::vector< double >	aValues;
+	std::vector< double >	aVectors;
+
+	for ( int a = 0; a < size; a++ )
+	{
+		for ( int b = 0; b <= a; b++ )
+		{
+			double	sum	= 0.;
+
+			if ( left )
+			{
+				for ( int j = 0; j < nInputs; j++ )
+				{
+					sum += (double)paWeights[a * nInputs + j] * paWeights[b * nInputs + j];
+				}
+			}
+			else
+			{
+				for ( int i = 0; i < nUnits; i++ )
+				{
+					sum += (double)paWeights[i * nInputs + a] * paWeights[i * nInputs + b];
+				}
+			}
+
+			aGram[(size_t)a * size + b] = sum;
+			aGram[(size_t)b * size + a] = sum;
+		}
+	}
+
+	EigenDecompose( aGram, size, aValues, aVectors );
+
+	// Choose the rank. The squared error of the approximation is the sum of the eigenvalues that are dropped.
+
+	double const	total	= std::accumulate( aValues.begin(), aValues.end(), 0. );
+	int				rank;
+
+	if ( criterion == MAX_ERROR )
+	{
+		double const	limit	= (double)target * target * total;
+		double			dropped	= total;
+
+		for ( rank = 0; rank < size && dropped > limit; rank++ )
+		{
+			dropped -= aValues[rank];
+		}
+	}
+	else
+	{
+		rank = (int)( (double)nUnits * nInputs / ( (double)target * ( nUnits + nInputs ) ) );
+	}
+
+	rank = std::max( 1, std::min( rank, size ) );
+
+	layer.aProjection.clear();
+	layer.aUnits.clear();
+
+	if ( (double)rank * ( nUnits + nInputs ) >= (double)nUnits * nInputs )
+	{
+		// Factorizing the layer would not make it smaller, so it is copied.
+
+		for ( int i = 0; i < nUnits; i++ )
+		{
+			layer.aUnits.push_back( Neuron( Neuron::WeightVector( paWeights + i * nInputs,
+																  paWeights + ( i + 1 ) * nInputs ) ) );
+		}
+
+		layer.error = 0.f;
+		return;
+	}
+
+	double const	dropped	= std::accumulate( aValues.begin() + rank, aValues.end(), 0. );
+
+	layer.error = ( total > 0. ) ? (float)std::sqrt( dropped / total ) : 0.f;
+
+	// W ~ Ur * ( Ur' * W ) if the eigenvectors are the left singular vectors, or ( W * Vr ) * Vr' if they are the
+	// right singular vectors.
+
+	Neuron::WeightVector	aProjection( nInputs );
+	Neuron::WeightVector	aUnit( rank );
+
+	for ( int c = 0; c < rank; c++ )
+	{
+		for ( int j = 0; j < nInputs; j++ )
+		{
+			double	x	= 0.;
+
+			if ( left )
+			{
+				for ( int i = 0; i < nUnits; i++ )
+				{
+					x += aVectors[(size_t)i * size + c] * paWeights[i * nInputs + j];
+				}
+			}
+			else
+			{
+				x = aVectors[(size_t)j * size + c];
+			}
+
+			aProjection[j] = (float)x;
+		}
+
+		layer.aProjection.push_back( Neuron( aProjection ) );
+	}
+
+	for ( int i = 0; i < nUnits; i++ )
+	{
+		for ( int c = 0; c < rank; c++ )
+		{
+			double	x	= 0.;
+
+			if ( left )
+			{
+				x = aVectors[(size_t)i * size + c];
+			}
+			else
+			{
+				for ( int j = 0; j < nInputs; j++ )
+				{
+					x += (double)paWeights[i * nInputs + j] * aVectors[(size_t)j * size + c];
+				}
+			}
+
+			aUnit[c] = (float)x;
+		}
+
+		layer.aUnits.push_back( Neuron( aUnit ) );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	layer		The layer.
+//! @param	paInputs	The inputs of the layer.
+//! @param	aProjected	Where to store the projected inputs, if the layer is factorized.
+//! @param	aSums		Where to store the combined inputs of the units.
+
+void LowRankNet::ComputeLayerSums( Layer const & layer, float const * paInputs, OutputVector & aProjected,
+								   OutputVector & aSums )
+{
+	int const	rank	= (int)layer.aProjection.size();
+	int const	nUnits	= (int)layer.aUnits.size();
+
+	if ( rank > 0 )
+	{
+		aProjected.resize( rank );
+		ComputeSums( KernelConfig(), layer.aProjection.data(), rank, paInputs, aProjected.data() );
+		paInputs = aProjected.data();
+	}
+
+	aSums.resize( nUnits );
+	ComputeSums( KernelConfig(), layer.aUnits.data(), nUnits, paInputs, aSums.data() );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	layer			The layer.
+//! @param	aInputs			The inputs of the layer.
+//! @param	aProjected		The projected inputs of the layer, if it is factorized.
+//! @param	aDeltas			The error terms of the units.
+//! @param	paInputDeltas	Where to store the error terms of the inputs (or 0 if they are not needed). The vector
+//!							is resized to the number of inputs.
+//! @param	rate			The learning rate.
+
+void LowRankNet::BackPropagate( Layer & layer, Neuron::InputVector const & aInputs, OutputVector const & aProjected,
+								GradientVector const & aDeltas, GradientVector * paInputDeltas, float rate )
+{
+	int const	rank	= (int)layer.aProjection.size();
+	int const	nUnits	= (int)layer.aUnits.size();
+	int const	nInputs	= (int)aInputs.size();
+
+	if ( rank == 0 )
+	{
+		if ( paInputDeltas != 0 )
+		{
+			paInputDeltas->assign( nInputs, 0.f );
+
+			for ( int i = 0; i < nUnits; i++ )
+			{
+				Neuron::WeightStorage const &	aWeights	= layer.aUnits[i].GetWeights();
+
+				for ( int j = 0; j < nInputs; j++ )
+				{
+					( *paInputDeltas )[j] += aWeights[j] * aDeltas[i];
+				}
+			}
+		}
+
+		for ( int i = 0; i < nUnits; i++ )
+		{
+			layer.aUnits[i].AdjustWeights( aInputs, aDeltas[i], rate );
+		}
+
+		return;
+	}
+
+	// The error terms of the projected inputs
+
+	m_aProjectedDeltas.assign( rank, 0.f );
+
+	for ( int i = 0; i < nUnits; i++ )
+	{
+		Neuron::WeightStorage const &	aWeights	= layer.aUnits[i].GetWeights();
+
+		for ( int c = 0; c < rank; c++ )
+		{
+			m_aProjectedDeltas[c] += aWeights[c] * aDeltas[i];
+		}
+	}
+
+	if ( paInputDeltas != 0 )
+	{
+		paInputDeltas->assign( nInputs, 0.f );
+
+		for ( int c = 0; c < rank; c++ )
+		{
+			Neuron::WeightStorage const &	aWeights	= layer.aProjection[c].GetWeights();
+
+			for ( int j = 0; j < nInputs; j++ )
+			{
+				( *paInputDeltas )[j] += aWeights[j] * m_aProjectedDeltas[c];
+			}
+		}
+	}
+
+	for ( int i = 0; i < nUnits; i++ )
+	{
+		layer.aUnits[i].AdjustWeights( aProjected, aDeltas[i], rate );
+	}
+
+	for ( int c = 0; c < rank; c++ )
+	{
+		layer.aProjection[c].AdjustWeights( aInputs, m_aProjectedDeltas[c], rate );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	aInputs			The input values.
+//! @param	aHiddenOutputs	Where to store the outputs of the hidden units.
+
+void LowRankNet::EvaluateHidden( Neuron::InputVector const & aInputs, OutputVector & aHiddenOutputs ) const
+{
+	static thread_local OutputVector	aProjected;
+
+	assert( (int)aInputs.size() == m_nInputs );
+
+	ComputeLayerSums( m_hidden, aInputs.data(), aProjected, aHiddenOutputs );
+
+	for ( int j = 0; j < (int)aHiddenOutputs.size(); j++ )
+	{
+		aHiddenOutputs[j] = m_hidden.aUnits[j].Activation( aHiddenOutputs[j] );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	out		The output stream.
+//! @param	net		The LowRankNet to output.
+
+std::ostream & operator<<( std::ostream & out, LowRankNet const & net )
+{
+	out << static_cast< NeuralNet const & >( net );
+
+	for ( LowRankNet::Layer const * pLayer : { &net.m_hidden, &net.m_output } )
+	{
+		int const	rank	= (int)pLayer->aProjection.size();
+		int const	nUnits	= (int)pLayer->aUnits.size();
+
+		out << ' ' << rank << ' ' << nUnits << ' ' << pLayer->error << std::endl;
+
+		for ( int c = 0; c < rank; c++ )
+		{
+			out << pLayer->aProjection[c] << std::endl;
+		}
+
+		for ( int i = 0; i < nUnits; i++ )
+		{
+			out << pLayer->aUnits[i] << std::endl;
+		}
+	}
+
+	return out;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	in		The input stream.
+//! @param	net		The LowRankNet to input.
+
+std::istream & operator>>( std::istream & in, LowRankNet & net )
+{
+	in >> static_cast< NeuralNet & >( net );
+
+	for ( LowRankNet::Layer * pLayer : { &net.m_hidden, &net.m_output } )
+	{
+		int		rank;
+		int		nUnits;
+
+		in >> rank >> nUnits >> pLayer->error;
+
+		if ( !in )
+		{
+			return in;
+		}
+
+		pLayer->aProjection.resize( rank );
+		pLayer->aUnits.resize( nUnits );
+
+		for ( int c = 0; c < rank; c++ )
+		{
+			in >> pLayer->aProjection[c];
+		}
+
+		for ( int i = 0; i < nUnits; i++ )
+		{
+			in >> pLayer->aUnits[i];
+		}
+	}
+
+	int const	nHidden	= (int)net.m_hidden.aUnits.size();
+
+	net.m_aHiddenOutputs.resize( nHidden );
+	net.m_aHiddenGradients.resize( nHidden );
+	net.m_aOutputGradients.resize( net.m_aOutputs.size() );
+
+	return in;
+}
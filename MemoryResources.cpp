@@ -0,0 +1,368 @@
+/** @file *//********************************************************************************************************
+
+                                                 MemoryResources.cpp
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/MemoryResources.cpp#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#include "MemoryResources.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <new>
+
+#if defined( __linux__ )
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+//! The size of a huge page.
+static size_t const	HUGE_PAGE_SIZE	= 2 * 1024 * 1024;
+
+#if defined( __linux__ )
+
+//! The mbind() policy that restricts allocation to the given nodes (from <linux/mempolicy.h>).
+static int const	MPOL_BIND_POLICY	= 2;
+
+#endif
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @return		The size of a normal page.
+
+static size_t GetPageSize()
+{
+#if defined( __linux__ )
+	return (size_t)sysconf( _SC_PAGESIZE );
+#else
+	return 4096;
+#endif
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	alignment	The minimum alignment of an allocation. It must be a power of 2.
+//! @param	pUpstream	The resource that provides the memory. It must support the alignment.
+
+AlignedResource::AlignedResource( size_t alignment /* = DEFAULT_ALIGNMENT*/,
+								  std::pmr::memory_resource * pUpstream /* = std::pmr::new_delete_resource()*/ )
+	: m_alignment( alignment ),
+	m_pUpstream( pUpstream )
+{
+	assert( alignment > 0 && ( alignment & ( alignment - 1 ) ) == 0 );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+AlignedResource::~AlignedResource()
+{
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+void * AlignedResource::do_allocate( size_t bytes, size_t alignment )
+{
+	return m_pUpstream->allocate( bytes, std::max( alignment, m_alignment ) );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+void AlignedResource::do_deallocate( void * p, size_t bytes, size_t alignment )
+{
+	m_pUpstream->deallocate( p, bytes, std::max( alignment, m_alignment ) );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+bool AlignedResource::do_is_equal( std::pmr::memory_resource const & other ) const noexcept
+{
+	AlignedResource const * const	pOther	= dynamic_cast< AlignedResource const * >( &other );
+
+	return pOther != 0 && pOther->m_alignment == m_alignment && pOther->m_pUpstream->is_equal( *m_pUpstream );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	hugePages	The use of huge pages.
+//! @param	node		The NUMA node to bind the memory to, or ANY_NODE.
+
+PageResource::PageResource( HugePages hugePages /* = NO_HUGE_PAGES*/, int node /* = ANY_NODE*/ )
+	: m_hugePages( hugePages ),
+	m_node( node )
+{
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+PageResource::~PageResource()
+{
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @return		The node, or 0 if it cannot be determined.
+
+int PageResource::GetCurrentNode()
+{
+#if defined( __linux__ ) && defined( SYS_getcpu )
+	unsigned	cpu;
+	unsigned	node;
+
+	if ( syscall( SYS_getcpu, &cpu, &node, 0 ) == 0 )
+	{
+		return (int)node;
+	}
+#endif
+
+	return 0;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	bytes		The size of the allocation.
+//! @param	alignment	The alignment of the allocation. It must not be greater than the size of a page.
+//!
+//! @return		The memory. std::bad_alloc is thrown if the memory cannot be allocated.
+
+void * PageResource::do_allocate( size_t bytes, size_t alignment )
+{
+	size_t const	size	= GetMappedSize( bytes );
+
+#if defined( __linux__ )
+
+	assert( alignment <= GetPageSize() );
+
+	void *	p	= MAP_FAILED;
+
+#if defined( MAP_HUGETLB )
+	if ( m_hugePages == EXPLICIT_HUGE_PAGES )
+	{
+		p = mmap( 0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0 );
+	}
+#endif
+
+	if ( p == MAP_FAILED && m_hugePages != NO_HUGE_PAGES )
+	{
+		// Map an extra huge page and trim the ends so that the memory starts on a huge page boundary, since only
+		// aligned huge pages can be backed by transparent huge pages.
+
+		char * const	pMapped	= (char *)mmap( 0, size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+												MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+		if ( pMapped != MAP_FAILED )
+		{
+			char * const	pAligned	=
+				(char *)( ( (uintptr_t)pMapped + HUGE_PAGE_SIZE - 1 ) & ~( (uintptr_t)HUGE_PAGE_SIZE - 1 ) );
+
+			if ( pAligned > pMapped )
+			{
+				munmap( pMapped, pAligned - pMapped );
+			}
+			munmap( pAligned + size, ( pMapped + HUGE_PAGE_SIZE ) - pAligned );
+
+#if defined( MADV_HUGEPAGE )
+			madvise( pAligned, size, MADV_HUGEPAGE );
+#endif
+			p = pAligned;
+		}
+	}
+	else if ( p == MAP_FAILED )
+	{
+		p = mmap( 0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+	}
+
+	if ( p == MAP_FAILED )
+	{
+		throw std::bad_alloc();
+	}
+
+	// The pages have not been touched yet, so binding them now determines where they are placed. If the binding
+	// fails (for example, because the node does not exist), the memory is still usable.
+
+	if ( m_node != ANY_NODE )
+	{
+		int const					bitsPerWord	= (int)sizeof( unsigned long ) * 8;
+		std::vector< unsigned long >	aMask( m_node / bitsPerWord + 1, 0 );
+
+		aMask[m_node / bitsPerWord] = 1UL << ( m_node % bitsPerWord );
+
+		syscall( SYS_mbind, p, size, MPOL_BIND_POLICY, aMask.data(), aMask.size() * bitsPerWord + 1, 0 );
+	}
+
+	return p;
+
+#else
+
+	return ::operator new( size, std::align_val_t( std::max( alignment, GetPageSize() ) ) );
+
+#endif
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+void PageResource::do_deallocate( void * p, size_t bytes, size_t alignment )
+{
+	size_t const	size	= GetMappedSize( bytes );
+
+#if defined( __linux__ )
+	(void)alignment;	// Mapped memory is always page-aligned
+	munmap( p, size );
+#else
+	::operator delete( p, size, std::align_val_t( std::max( alignment, GetPageSize() ) ) );
+#endif
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+bool PageResource::do_is_equal( std::pmr::memory_resource const & other ) const noexcept
+{
+	// Memory from any PageResource can be returned to any other, since it is released the same way.
+
+	return dynamic_cast< PageResource const * >( &other ) != 0;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	bytes	The size of the allocation.
+//!
+//! @return		The size rounded up to a whole number of pages (huge pages, if they are used).
+
+size_t PageResource::GetMappedSize( size_t bytes ) const
+{
+	size_t const	pageSize	= ( m_hugePages != NO_HUGE_PAGES ) ? HUGE_PAGE_SIZE : GetPageSize();
+
+	return ( std::max( bytes, (size_t)1 ) + pageSize - 1 ) / pageSize * pageSize;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	pUpstream	The resource that provides the chunks.
+//! @param	chunkSize	The normal size of a chunk. Larger allocations get a chunk of their own.
+//! @param	alignment	The minimum alignment of an allocation. It must be a power of 2.
+
+ArenaResource::ArenaResource( std::pmr::memory_resource * pUpstream /* = std::pmr::get_default_resource()*/,
+							  size_t chunkSize /* = DEFAULT_CHUNK_SIZE*/,
+							  size_t alignment /* = AlignedResource::DEFAULT_ALIGNMENT*/ )
+	: m_pUpstream( pUpstream ),
+	m_chunkSize( chunkSize ),
+	m_alignment( alignment ),
+	m_pNext( 0 ),
+	m_pEnd( 0 )
+{
+	assert( alignment > 0 && ( alignment & ( alignment - 1 ) ) == 0 );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @warning	Everything allocated from the arena is released, so anything using it must have been destroyed.
+
+ArenaResource::~ArenaResource()
+{
+	for ( size_t i = 0; i < m_aChunks.size(); i++ )
+	{
+		m_pUpstream->deallocate( m_aChunks[i].p, m_aChunks[i].size, m_aChunks[i].alignment );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+void * ArenaResource::do_allocate( size_t bytes, size_t alignment )
+{
+	alignment = std::max( alignment, m_alignment );
+
+	std::lock_guard< std::mutex >	lock( m_mutex );
+
+	char *	p	= (char *)( ( (uintptr_t)m_pNext + alignment - 1 ) & ~( (uintptr_t)alignment - 1 ) );
+
+	if ( m_pNext == 0 || p + bytes > m_pEnd )
+	{
+		Chunk	chunk;
+		chunk.size		= std::max( m_chunkSize, bytes );
+		chunk.alignment	= alignment;
+		chunk.p			= m_pUpstream->allocate( chunk.size, chunk.alignment );
+		m_aChunks.push_back( chunk );
+
+		p		= (char *)chunk.p;
+		m_pEnd	= p + chunk.size;
+	}
+
+	m_pNext = p + bytes;
+
+	return p;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The memory is not reused. It is released when the arena is destroyed.
+
+void ArenaResource::do_deallocate( void * /* p */, size_t /* bytes */, size_t /* alignment */ )
+{
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+bool ArenaResource::do_is_equal( std::pmr::memory_resource const & other ) const noexcept
+{
+	return this == &other;
+}
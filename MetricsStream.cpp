@@ -0,0 +1,250 @@
+/** @file *//********************************************************************************************************
+
+                                                  MetricsStream.cpp
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/MetricsStream.cpp#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#include "MetricsStream.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <ostream>
+
+float const	MetricsStream::SATURATION_LIMIT	= 0.01f;
+
+//! How long the background thread sleeps when there are no statistics to process.
+static std::chrono::milliseconds const	POLL_INTERVAL( 1 );
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	exporter			The function that exports the summaries.
+//! @param	stepsPerSummary		The number of steps in a summary.
+//! @param	capacity			The number of steps whose statistics can wait for the background thread. It must be a
+//!								power of 2.
+
+MetricsStream::MetricsStream( Exporter const & exporter,
+							  int stepsPerSummary /* = DEFAULT_STEPS_PER_SUMMARY*/,
+							  int capacity /* = DEFAULT_CAPACITY*/ )
+	: m_exporter( exporter ),
+	m_stepsPerSummary( stepsPerSummary ),
+	m_ring( capacity ),
+	m_nextStep( 0 ),
+	m_bQuit( false ),
+	m_expectedStep( 0 ),
+	m_totalLoss( 0. ),
+	m_totalGradientNorm( 0. ),
+	m_totalUpdateMagnitude( 0. ),
+	m_totalSaturation( 0. )
+{
+	assert( stepsPerSummary > 0 );
+
+	m_summary.nSteps	= 0;
+	m_summary.nDropped	= 0;
+
+	m_thread = std::thread( &MetricsStream::Run, this );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The statistics published so far are exported before the stream is destroyed, including a final partial summary.
+
+MetricsStream::~MetricsStream()
+{
+	m_bQuit.store( true, std::memory_order_release );
+	m_thread.join();
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! If the ring is full, the statistics are dropped.
+//!
+//! @param	stats	The statistics.
+
+void MetricsStream::Publish( Stats const & stats )
+{
+	// Only this thread changes the step, but the background thread reads it when the stream is destroyed.
+
+	Record	record;
+	record.step		= m_nextStep.load( std::memory_order_relaxed );
+	record.stats	= stats;
+
+	m_nextStep.store( record.step + 1, std::memory_order_release );
+
+	m_ring.Push( record );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	output	The output of a unit with a sigmoid activation function.
+//!
+//! @return		True if the output is so close to 0 or 1 that the gradient of the unit has nearly vanished.
+
+bool MetricsStream::IsSaturated( float output )
+{
+	return output < SATURATION_LIMIT || output > 1.f - SATURATION_LIMIT;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+void MetricsStream::Run()
+{
+	Record	record;
+
+	for ( ;; )
+	{
+		// Check for quitting before emptying the ring, so that everything published before the destructor was called
+		// is received.
+
+		bool const	quit	= m_bQuit.load( std::memory_order_acquire );
+
+		while ( m_ring.Pop( record ) )
+		{
+			Accumulate( record );
+		}
+
+		if ( quit )
+		{
+			break;
+		}
+
+		std::this_thread::sleep_for( POLL_INTERVAL );
+	}
+
+	// Steps dropped after the last one received are counted in the final summary.
+
+	long long const	nextStep	= m_nextStep.load( std::memory_order_acquire );
+
+	if ( nextStep > m_expectedStep )
+	{
+		if ( m_summary.nSteps + m_summary.nDropped == 0 )
+		{
+			m_summary.firstStep = m_expectedStep;
+		}
+		m_summary.nDropped += (int)( nextStep - m_expectedStep );
+		m_summary.lastStep	= nextStep - 1;
+	}
+
+	if ( m_summary.nSteps + m_summary.nDropped > 0 )
+	{
+		Export();
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	record	The statistics of a step.
+
+void MetricsStream::Accumulate( Record const & record )
+{
+	Stats const &	stats	= record.stats;
+
+	// Any steps skipped since the previous record were dropped.
+
+	if ( m_summary.nSteps + m_summary.nDropped == 0 )
+	{
+		m_summary.firstStep			= m_expectedStep;
+		m_summary.maxLoss			= stats.loss;
+		m_summary.maxGradientNorm	= stats.gradientNorm;
+	}
+
+	m_summary.lastStep			= record.step;
+	m_summary.nSteps			+= 1;
+	m_summary.nDropped			+= (int)( record.step - m_expectedStep );
+	m_summary.maxLoss			= std::max( m_summary.maxLoss, stats.loss );
+	m_summary.maxGradientNorm	= std::max( m_summary.maxGradientNorm, stats.gradientNorm );
+
+	m_totalLoss				+= stats.loss;
+	m_totalGradientNorm		+= stats.gradientNorm;
+	m_totalUpdateMagnitude	+= stats.updateMagnitude;
+	m_totalSaturation		+= stats.saturation;
+
+	m_expectedStep = record.step + 1;
+
+	if ( m_summary.nSteps + m_summary.nDropped >= m_stepsPerSummary )
+	{
+		Export();
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+void MetricsStream::Export()
+{
+	if ( m_summary.nSteps > 0 )
+	{
+		m_summary.meanLoss				= (float)( m_totalLoss / m_summary.nSteps );
+		m_summary.meanGradientNorm		= (float)( m_totalGradientNorm / m_summary.nSteps );
+		m_summary.meanUpdateMagnitude	= (float)( m_totalUpdateMagnitude / m_summary.nSteps );
+		m_summary.meanSaturation		= (float)( m_totalSaturation / m_summary.nSteps );
+	}
+	else
+	{
+		m_summary.meanLoss				= 0.f;
+		m_summary.maxLoss				= 0.f;
+		m_summary.meanGradientNorm		= 0.f;
+		m_summary.maxGradientNorm		= 0.f;
+		m_summary.meanUpdateMagnitude	= 0.f;
+		m_summary.meanSaturation		= 0.f;
+	}
+
+	if ( m_exporter )
+	{
+		m_exporter( m_summary );
+	}
+
+	m_summary.nSteps		= 0;
+	m_summary.nDropped		= 0;
+	m_totalLoss				= 0.;
+	m_totalGradientNorm		= 0.;
+	m_totalUpdateMagnitude	= 0.;
+	m_totalSaturation		= 0.;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	out			The output stream.
+//! @param	summary		The summary to output.
+
+std::ostream & operator<<( std::ostream & out, MetricsStream::Summary const & summary )
+{
+	out << "steps " << summary.firstStep << '-' << summary.lastStep
+		<< " dropped " << summary.nDropped
+		<< " loss " << summary.meanLoss << " (max " << summary.maxLoss << ')'
+		<< " gradient " << summary.meanGradientNorm << " (max " << summary.maxGradientNorm << ')'
+		<< " update " << summary.meanUpdateMagnitude
+		<< " saturation " << summary.meanSaturation;
+
+	return out;
+}
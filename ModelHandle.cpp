@@ -0,0 +1,276 @@
+/** @file *//********************************************************************************************************
+
+                                                   ModelHandle.cpp
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/ModelHandle.cpp#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#include "ModelHandle.h"
+
+#include <cassert>
+#include <chrono>
+#include <functional>
+
+//! How often the background thread checks whether the readers of the retired nets have finished. Readers do not
+//! signal when they finish, so that they never lock.
+static std::chrono::milliseconds const	RECLAIM_INTERVAL( 1 );
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	handle	The handle to read.
+
+ModelHandle::Reader::Reader( ModelHandle & handle )
+	: m_handle( handle )
+{
+	// Claim a free slot, starting at a place determined by the thread so that readers on different threads usually
+	// use different slots (and different cache lines).
+
+	size_t const	start	= std::hash< std::thread::id >()( std::this_thread::get_id() );
+
+	for ( size_t i = 0; ; i++ )
+	{
+		int const		slot	= int( ( start + i ) % MAX_READERS );
+		uint64_t		free	= 0;
+		uint64_t const	epoch	= handle.m_epoch.load();
+
+		if ( handle.m_aSlots[slot].epoch.compare_exchange_strong( free, epoch ) )
+		{
+			m_slot = slot;
+			break;
+		}
+
+		if ( ( i + 1 ) % MAX_READERS == 0 )
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	// Since the slot was claimed before the net is loaded, any net this reader could get will not be deleted until
+	// the slot is released.
+
+	m_pModel = handle.m_pModel.load();
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The reader only releases its slot. A replaced net that it was the last to use is deleted by the handle's
+//! background thread, so a reader never waits for a lock or pays for freeing a net.
+
+ModelHandle::Reader::~Reader()
+{
+	m_handle.m_aSlots[m_slot].epoch.store( 0, std::memory_order_release );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+ModelHandle::ModelHandle()
+	: m_pModel( 0 ),
+	m_epoch( 1 ),
+	m_bQuit( false )
+{
+	for ( int i = 0; i < MAX_READERS; i++ )
+	{
+		m_aSlots[i].epoch = 0;
+	}
+
+	m_reclaimer = std::thread( &ModelHandle::RunReclaimer, this );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	pModel	The initial net.
+
+ModelHandle::ModelHandle( std::unique_ptr< NeuralNet > pModel )
+	: m_pModel( pModel.release() ),
+	m_epoch( 1 ),
+	m_bQuit( false )
+{
+	for ( int i = 0; i < MAX_READERS; i++ )
+	{
+		m_aSlots[i].epoch = 0;
+	}
+
+	m_reclaimer = std::thread( &ModelHandle::RunReclaimer, this );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @warning	There must be no active readers.
+
+ModelHandle::~ModelHandle()
+{
+	{
+		std::lock_guard< std::mutex >	lock( m_publishMutex );
+		m_bQuit = true;
+	}
+	m_retiredChanged.notify_all();
+
+	m_reclaimer.join();
+
+	for ( size_t i = 0; i < m_aRetired.size(); i++ )
+	{
+		delete m_aRetired[i].pModel;
+	}
+
+	delete m_pModel.load();
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The new net is visible to every reader that starts after this call. The old net is deleted when the readers that
+//! started before this call have finished, either by this call or later by the background thread.
+//!
+//! @param	pModel	The new net.
+
+void ModelHandle::Publish( std::unique_ptr< NeuralNet > pModel )
+{
+	std::lock_guard< std::mutex >	lock( m_publishMutex );
+
+	NeuralNet const * const	pOld	= m_pModel.exchange( pModel.release() );
+
+	// Readers that announce this epoch or a later one started after the exchange, so they cannot see the old net.
+
+	uint64_t const	epoch	= m_epoch.fetch_add( 1 ) + 1;
+
+	if ( pOld != 0 )
+	{
+		Retired	retired;
+		retired.pModel	= pOld;
+		retired.epoch	= epoch;
+		m_aRetired.push_back( retired );
+	}
+
+	Reclaim();
+
+	if ( !m_aRetired.empty() )
+	{
+		m_retiredChanged.notify_all();
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The net is built by @a build on a new thread, so this function returns immediately and readers are not
+//! affected until the new net is published.
+//!
+//! @param	build	The function that builds the new net.
+//!
+//! @return		A future whose value is true if the net was built and published.
+
+std::future< bool > ModelHandle::LoadAsync( Builder const & build )
+{
+	return std::async( std::launch::async, [this, build] () -> bool
+	{
+		std::unique_ptr< NeuralNet >	pModel	= build();
+
+		if ( !pModel )
+		{
+			return false;
+		}
+
+		Publish( std::move( pModel ) );
+		return true;
+	} );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! A retired net may be deleted if every active reader announced an epoch at or after the net's retirement.
+//!
+//! @note	The caller must hold m_publishMutex.
+
+void ModelHandle::Reclaim()
+{
+	if ( m_aRetired.empty() )
+	{
+		return;
+	}
+
+	uint64_t	oldest	= m_epoch.load();
+
+	for ( int i = 0; i < MAX_READERS; i++ )
+	{
+		uint64_t const	epoch	= m_aSlots[i].epoch.load();
+
+		if ( epoch != 0 && epoch < oldest )
+		{
+			oldest = epoch;
+		}
+	}
+
+	size_t	nKept	= 0;
+
+	for ( size_t i = 0; i < m_aRetired.size(); i++ )
+	{
+		if ( m_aRetired[i].epoch <= oldest )
+		{
+			delete m_aRetired[i].pModel;
+		}
+		else
+		{
+			m_aRetired[nKept++] = m_aRetired[i];
+		}
+	}
+
+	m_aRetired.resize( nKept );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! While there are retired nets, the slots are checked every RECLAIM_INTERVAL. Otherwise, the thread sleeps until a
+//! net is retired.
+
+void ModelHandle::RunReclaimer()
+{
+	std::unique_lock< std::mutex >	lock( m_publishMutex );
+
+	for ( ;; )
+	{
+		m_retiredChanged.wait( lock, [this] { return m_bQuit || !m_aRetired.empty(); } );
+
+		if ( m_bQuit )
+		{
+			return;		// The destructor deletes the remaining retired nets
+		}
+
+		Reclaim();
+
+		if ( !m_aRetired.empty() )
+		{
+			m_retiredChanged.wait_for( lock, RECLAIM_INTERVAL );
+		}
+	}
+}
@@ -13,16 +13,41 @@
 
 #include "MultilayerFeedForward.h"
 
+#include "Autotuner.h"
+#include "MetricsStream.h"
+#include "TextFormat.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
 #include <vector>
 #include <iostream>
 #include <cassert>
 
+//! The number of bytes of weights processed by each tile when a layer is split across threads. Tiles this size fit
+//! comfortably in a core's L1/L2 cache.
+static int const	TILE_SIZE_IN_BYTES		= 32 * 1024;
+
+//! The number of partial sums of each unit in deterministic mode.
+static int const	DETERMINISTIC_UNROLL	= 8;
+
+//! The largest count that ReadText() accepts. Every integer up to this value is represented exactly by a float.
+static int const	MAX_COUNT				= 1 << 24;
+
 
 /********************************************************************************************************************/
 /*																													*/
 /********************************************************************************************************************/
 
 MultilayerFeedForward::MultilayerFeedForward()
+	: m_bHiddenSumsValid( false ),
+	m_bInferenceOnly( false ),
+	m_bHiddenFrozen( false ),
+	m_bOutputFrozen( false ),
+	m_bDeterministic( false ),
+	m_pThreadPool( 0 ),
+	m_parallelThreshold( DEFAULT_PARALLEL_THRESHOLD ),
+	m_pAutotuner( 0 )
 {
 }
 
@@ -38,10 +63,19 @@ MultilayerFeedForward::MultilayerFeedForward()
 MultilayerFeedForward::MultilayerFeedForward( int nInputs, int nHidden, int nOutputs )
 	: NeuralNet( nInputs, nOutputs ),
 	m_aHiddenUnits( nHidden, Neuron( nInputs ) ),
+	m_aHiddenSums( nHidden ),
+	m_bHiddenSumsValid( false ),
 	m_aHiddenOutputs( nHidden ),
 	m_aHiddenGradients( nHidden ),
 	m_aOutputUnits( nOutputs, Neuron( nHidden ) ),
-	m_aOutputGradients( nOutputs )
+	m_aOutputGradients( nOutputs ),
+	m_bInferenceOnly( false ),
+	m_bHiddenFrozen( false ),
+	m_bOutputFrozen( false ),
+	m_bDeterministic( false ),
+	m_pThreadPool( 0 ),
+	m_parallelThreshold( DEFAULT_PARALLEL_THRESHOLD ),
+	m_pAutotuner( 0 )
 {
 }
 
@@ -62,10 +96,19 @@ MultilayerFeedForward::MultilayerFeedForward( int nInputs, int nHidden, int nOut
 											  Neuron::WeightVector const & aWeights )
 	: NeuralNet( nInputs, nOutputs ),
 	m_aHiddenUnits( nHidden ),
+	m_aHiddenSums( nHidden ),
+	m_bHiddenSumsValid( false ),
 	m_aHiddenOutputs( nHidden ),
 	m_aHiddenGradients( nHidden ),
 	m_aOutputUnits( nOutputs ),
-	m_aOutputGradients( nOutputs )
+	m_aOutputGradients( nOutputs ),
+	m_bInferenceOnly( false ),
+	m_bHiddenFrozen( false ),
+	m_bOutputFrozen( false ),
+	m_bDeterministic( false ),
+	m_pThreadPool( 0 ),
+	m_parallelThreshold( DEFAULT_PARALLEL_THRESHOLD ),
+	m_pAutotuner( 0 )
 {
 	assert( (int)aWeights.size() == ( nInputs + nOutputs ) * nHidden );
 
@@ -101,27 +144,158 @@ MultilayerFeedForward::~MultilayerFeedForward()
 /*																													*/
 /********************************************************************************************************************/
 
-MultilayerFeedForward::OutputVector const & MultilayerFeedForward::operator()( Neuron::InputVector const & aInputs )
+//! The weights of a frozen layer are not changed by training, and the errors are not propagated back into the hidden
+//! layer if it is frozen, which saves most of the cost of training when only the output layer is trained.
+//!
+//! @param	layer	The layer.
+//! @param	frozen	If true, the layer is frozen. If false, it is trained.
+//!
+//! @warning	After the hidden layer is unfrozen, the net must be evaluated before it is trained.
+
+void MultilayerFeedForward::SetFrozen( Layer layer, bool frozen )
 {
-	// Update the hidden outputs.
+	if ( layer == HIDDEN_LAYER )
+	{
+		m_bHiddenFrozen = frozen;
+	}
+	else
+	{
+		m_bOutputFrozen = frozen;
+	}
+}
 
-	int const	nHidden	= (int)m_aHiddenUnits.size();
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! If a thread pool has been set with SetThreadPool(), the units of a layer containing at least @a threshold weights
+//! are split into tiles that are processed concurrently by the pool's threads. Smaller layers are processed serially
+//! because the cost of distributing the work would outweigh the gain.
+//!
+//! @param	pPool		The thread pool to use, or 0 to process every layer serially. The pool is not owned by the
+//!						net and must outlive its use.
+//! @param	threshold	The minimum number of weights in a layer for it to be processed in parallel.
+
+void MultilayerFeedForward::SetThreadPool( ThreadPool * pPool, int threshold /* = DEFAULT_PARALLEL_THRESHOLD*/ )
+{
+	m_pThreadPool		= pPool;
+	m_parallelThreshold	= threshold;
+
+	ConfigureKernels();
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The combined input of a unit is a sum of products, and the order of the additions changes the rounding of the
+//! result. The order used by a kernel depends on its configuration (see KernelConfig), which an autotuner chooses by
+//! timing it, possibly differently for each thread count and on each run. In deterministic mode, every kernel adds
+//! the products in the same fixed order: the products are split among 8 partial sums, which are then added pairwise.
+//! An autotuner still chooses the other settings of the kernels, which do not affect the results.
+//!
+//! The other sums computed by the net (such as the back-propagated errors and the changes to the weights for a
+//! batch) are always computed by a single thread for each unit in a fixed order, so in deterministic mode the
+//! results of evaluating and training the net do not depend on the thread pool, the autotuner or the timing.
+//!
+//! @param	deterministic	If true, the net enters deterministic mode.
+//!
+//! @note	A net in deterministic mode may give slightly different results than a net that is not, and its results
+//!			may differ between compilers and processors.
+
+void MultilayerFeedForward::SetDeterministic( bool deterministic )
+{
+	m_bDeterministic = deterministic;
+
+	ConfigureKernels();
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The autotuner is asked for the best kernel for each layer's shape, which may take a moment if it has not seen the
+//! shape before. The kernels are chosen again when the shape of the net or its thread pool changes.
+//!
+//! @param	pAutotuner	The autotuner, or 0 to use the default kernel, which computes the same results as Neuron.
+//!						The autotuner is not owned by the net and must outlive its use.
+//!
+//! @note	The kernels chosen by an autotuner add the products in a different order than the default kernel, so
+//!			their results may differ slightly.
+
+void MultilayerFeedForward::SetAutotuner( Autotuner * pAutotuner )
+{
+	m_pAutotuner = pAutotuner;
+
+	ConfigureKernels();
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @return		The weights in the same order as they are given to the constructor: the input weights of each hidden
+//!				unit followed by the input weights of each output unit.
+
+Neuron::WeightVector MultilayerFeedForward::GetWeights() const
+{
+	int const	nHidden		= (int)m_aHiddenUnits.size();
+	int const	nOutputs	= (int)m_aOutputUnits.size();
+
+	Neuron::WeightVector	aWeights;
+	aWeights.reserve( ( m_nInputs + nOutputs ) * nHidden );
 
 	for ( int j = 0; j < nHidden; j++ )
 	{
-		m_aHiddenOutputs[j] = m_aHiddenUnits[j]( aInputs, &m_aHiddenGradients[j] );
+		Neuron::WeightStorage const &	aUnitWeights	= m_aHiddenUnits[j].GetWeights();
+		aWeights.insert( aWeights.end(), aUnitWeights.begin(), aUnitWeights.end() );
 	}
 
-	// Update the outputs.
+	for ( int i = 0; i < nOutputs; i++ )
+	{
+		Neuron::WeightStorage const &	aUnitWeights	= m_aOutputUnits[i].GetWeights();
+		aWeights.insert( aWeights.end(), aUnitWeights.begin(), aUnitWeights.end() );
+	}
+
+	return aWeights;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The memory resources of the weights are kept.
+//!
+//! @param	aWeights	The weights, in the same order as the weights given to the constructor.
 
+void MultilayerFeedForward::SetWeights( Neuron::WeightVector const & aWeights )
+{
+	int const	nHidden		= (int)m_aHiddenUnits.size();
 	int const	nOutputs	= (int)m_aOutputUnits.size();
 
+	assert( (int)aWeights.size() == ( m_nInputs + nOutputs ) * nHidden );
+
+	Neuron::WeightVector::const_iterator	pFirst	= aWeights.begin();
+
+	for ( int j = 0; j < nHidden; j++ )
+	{
+		m_aHiddenUnits[j].Initialize( Neuron::WeightVector( pFirst, pFirst + m_nInputs ) );
+		pFirst += m_nInputs;
+	}
+
 	for ( int i = 0; i < nOutputs; i++ )
 	{
-		m_aOutputs[i] = m_aOutputUnits[i]( m_aHiddenOutputs, &m_aOutputGradients[i] );
+		m_aOutputUnits[i].Initialize( Neuron::WeightVector( pFirst, pFirst + nHidden ) );
+		pFirst += nHidden;
 	}
 
-	return m_aOutputs;
+	m_bHiddenSumsValid = false;
+	UpdateVersion();
 }
 
 
@@ -129,33 +303,172 @@ MultilayerFeedForward::OutputVector const & MultilayerFeedForward::operator()( N
 /*																													*/
 /********************************************************************************************************************/
 
-void MultilayerFeedForward::Train( Neuron::InputVector const & aInputs, ErrorVector const & aErrors, float rate )
+//! This reads the format written by operator<<(), like operator>>(), but much faster: the whole text is parsed at
+//! once, in parallel if there is a thread pool, without using the locale. Like operator>>(), it keeps the settings of
+//! the net and the memory resources of the weights. For example:
+//!
+//! @code
+//!		std::ifstream		file( path, std::ios::binary );
+//!		std::string const	text( ( std::istreambuf_iterator< char >( file ) ), std::istreambuf_iterator< char >() );
+//!
+//!		if ( !net.ReadText( text, &pool ) )
+//!		{
+//!			... fail ...
+//!		}
+//! @endcode
+//!
+//! @param	text	The text of a net written by operator<<().
+//! @param	pPool	The thread pool used to parse the text (or 0 if none).
+//!
+//! @return		True if the net was read. If not, the net is not changed.
+
+bool MultilayerFeedForward::ReadText( std::string const & text, ThreadPool * pPool /* = 0*/ )
 {
-	assert( aInputs.size() == m_nInputs );
-	assert( aErrors.size() == m_aOutputUnits.size() );
+	std::vector< float >	aValues;
 
-	int const	nOutputs	= (int)m_aOutputUnits.size();
+	if ( !ParseFloats( text, aValues, pPool ) || aValues.size() < 4 )
+	{
+		return false;
+	}
+
+	// The text holds the number of inputs, the number of outputs, the number of hidden units and the number of
+	// outputs again, followed by the number of weights and the weights of each unit.
+
+	int		aCounts[4];
+
+	for ( int k = 0; k < 4; k++ )
+	{
+		if ( !( aValues[k] >= 0.f && aValues[k] <= (float)MAX_COUNT && aValues[k] == std::floor( aValues[k] ) ) )
+		{
+			return false;
+		}
+
+		aCounts[k] = (int)aValues[k];
+	}
+
+	int const	nInputs		= aCounts[0];
+	int const	nOutputs	= aCounts[1];
+	int const	nHidden		= aCounts[2];
+
+	if ( aCounts[3] != nOutputs ||
+		 aValues.size() != 4 + (size_t)nHidden * ( 1 + nInputs ) + (size_t)nOutputs * ( 1 + nHidden ) )
+	{
+		return false;
+	}
+
+	for ( size_t k = 4; k < aValues.size(); )
+	{
+		int const	size	= ( k < 4 + (size_t)nHidden * ( 1 + nInputs ) ) ? nInputs : nHidden;
+
+		if ( aValues[k] != (float)size )
+		{
+			return false;
+		}
+
+		k += 1 + size;
+	}
+
+	Resize( nInputs, nHidden, nOutputs );
+
+	float const *	pFirst	= aValues.data() + 4;
+
+	for ( int j = 0; j < nHidden; j++ )
+	{
+		m_aHiddenUnits[j].Initialize( Neuron::WeightVector( pFirst + 1, pFirst + 1 + nInputs ) );
+		pFirst += 1 + nInputs;
+	}
 
 	for ( int i = 0; i < nOutputs; i++ )
 	{
-		m_aOutputGradients[i] *= aErrors[i];
-		m_aOutputUnits[i].AdjustWeights( m_aHiddenOutputs, m_aOutputGradients[i], rate );
+		m_aOutputUnits[i].Initialize( Neuron::WeightVector( pFirst + 1, pFirst + 1 + nHidden ) );
+		pFirst += 1 + nHidden;
+	}
+
+	ConfigureKernels();
+	UpdateVersion();
+
+	return true;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+void MultilayerFeedForward::SetMemoryResource( std::pmr::memory_resource * pResource )
+{
+	for ( size_t j = 0; j < m_aHiddenUnits.size(); j++ )
+	{
+		m_aHiddenUnits[j].SetMemoryResource( pResource );
+	}
+
+	for ( size_t i = 0; i < m_aOutputUnits.size(); i++ )
+	{
+		m_aOutputUnits[i].SetMemoryResource( pResource );
 	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	aInputs			The input values.
+//! @param	aHiddenOutputs	Where to store the outputs of the hidden units. The vector is resized to the number of
+//!							hidden units.
+
+void MultilayerFeedForward::EvaluateHidden( Neuron::InputVector const & aInputs, OutputVector & aHiddenOutputs ) const
+{
+	assert( (int)aInputs.size() == m_nInputs );
 
 	int const	nHidden	= (int)m_aHiddenUnits.size();
 
+	aHiddenOutputs.resize( nHidden );
+	ComputeSums( m_hiddenKernel, m_aHiddenUnits.data(), nHidden, aInputs.data(), aHiddenOutputs.data() );
+
 	for ( int j = 0; j < nHidden; j++ )
 	{
-		float	s	= 0.f;
-		for ( int i = 0; i < nOutputs; i++ )
-		{
-			s += m_aOutputUnits[i].GetWeights()[j] * m_aOutputGradients[i];
-		}
-		m_aHiddenGradients[j] *= s;
+		aHiddenOutputs[j] = m_aHiddenUnits[j].Activation( aHiddenOutputs[j] );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Together with EvaluateHidden(), this evaluates the net one layer at a time, for example in different threads.
+//!
+//! @param	paHiddenOutputs		The outputs of the hidden units.
+//! @param	aOutputs			Where to store the output values. The vector is resized to the number of outputs.
+
+void MultilayerFeedForward::EvaluateOutputs( float const * paHiddenOutputs, OutputVector & aOutputs ) const
+{
+	int const	nOutputs	= (int)m_aOutputUnits.size();
 
-		m_aHiddenUnits[j].AdjustWeights( aInputs, m_aHiddenGradients[j], rate );
+	aOutputs.resize( nOutputs );
+	ComputeSums( m_outputKernel, m_aOutputUnits.data(), nOutputs, paHiddenOutputs, aOutputs.data() );
+
+	for ( int i = 0; i < nOutputs; i++ )
+	{
+		aOutputs[i] = m_aOutputUnits[i].Activation( aOutputs[i] );
 	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The outputs of the hidden units are stored in a buffer local to the calling thread. The units are processed
+//! serially even if a thread pool has been set, so that concurrent callers do not wait for each other.
+
+void MultilayerFeedForward::Evaluate( Neuron::InputVector const & aInputs, OutputVector & aOutputs ) const
+{
+	static thread_local OutputVector	aHiddenOutputs;
 
+	EvaluateHidden( aInputs, aHiddenOutputs );
+	EvaluateOutputs( aHiddenOutputs.data(), aOutputs );
 }
 
 
@@ -163,29 +476,141 @@ void MultilayerFeedForward::Train( Neuron::InputVector const & aInputs, ErrorVec
 /*																													*/
 /********************************************************************************************************************/
 
-//! @param	out		The output stream.
-//! @param	mff		The MultilayerFeedForward to output.
+//! A net that is only used for inference does not need the derivatives of the activation function that are computed
+//! and saved for Train(). In inference-only mode, they are not computed and the buffers holding them are freed.
+//!
+//! @param	inferenceOnly	If true, the net enters inference-only mode. If false, it leaves inference-only mode and
+//!							may be trained again after its next evaluation.
+//!
+//! @warning	Train() must not be called in inference-only mode, or before the net has been evaluated after leaving
+//!				it.
 
-std::ostream & operator<<( std::ostream & out, MultilayerFeedForward const & mff )
+void MultilayerFeedForward::SetInferenceOnly( bool inferenceOnly )
 {
-	out << static_cast< NeuralNet const & >( mff );
+	m_bInferenceOnly = inferenceOnly;
 
-	int const	nHidden	= (int)mff.m_aHiddenUnits.size();
-	int const	nOutputs	= (int)mff.m_aOutputUnits.size();
+	if ( inferenceOnly )
+	{
+		GradientVector().swap( m_aHiddenGradients );
+		GradientVector().swap( m_aOutputGradients );
+	}
+	else
+	{
+		m_aHiddenGradients.resize( m_aHiddenUnits.size() );
+		m_aOutputGradients.resize( m_aOutputUnits.size() );
+	}
+}
 
-	out << ' ' << nHidden << ' ' << nOutputs << std::endl;
 
-	for ( int i = 0; i < nHidden; i++ )
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The combined inputs to the hidden units are saved so that a later call to operator()( InputChangeVector const & )
+//! can update them incrementally.
+//!
+//! @param	aInputs		The input values.
+//! @return				A vector of output values. The size of the vector is the number of outputs.
+
+MultilayerFeedForward::OutputVector const & MultilayerFeedForward::operator()( Neuron::InputVector const & aInputs )
+{
+	assert( (int)aInputs.size() == m_nInputs );
+
+	if ( &aInputs != &m_aInputs )
 	{
-		out << mff.m_aHiddenUnits[i] << std::endl;
+		m_aInputs = aInputs;
 	}
 
-	for ( int j = 0; j < nOutputs; j++ )
+	// Update the hidden outputs.
+
+	int const	nHidden	= (int)m_aHiddenUnits.size();
+
+	ForEachUnit( nHidden, m_nInputs, m_hiddenKernel.tileSize, [this] ( int first, int last )
 	{
-		out << mff.m_aOutputUnits[j] << std::endl;
+		ComputeSums( m_hiddenKernel, m_aHiddenUnits.data() + first, last - first, m_aInputs.data(),
+					 m_aHiddenSums.data() + first );
+
+		for ( int j = first; j < last; j++ )
+		{
+			Neuron const &	unit	= m_aHiddenUnits[j];
+			float const		sum		= m_aHiddenSums[j];
+
+			m_aHiddenOutputs[j] = ( m_bInferenceOnly || m_bHiddenFrozen ) ? unit.Activation( sum )
+																	  : unit.Activation( sum, &m_aHiddenGradients[j] );
+		}
+	} );
+
+	m_bHiddenSumsValid = true;
+
+	// Update the outputs.
+
+	UpdateOutputs();
+
+	return m_aOutputs;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The outputs of the hidden units are stored in a buffer local to the calling thread. Each layer is processed a tile
+//! of units at a time, so that the weights of a tile stay in the cache while they are applied to every sample. The
+//! sums are computed with the same kernels as Evaluate(), so the outputs are the same.
+
+void MultilayerFeedForward::EvaluateBatch( InputBatch const & aInputs, OutputBatch & aOutputs ) const
+{
+	static thread_local OutputBatch	aHiddenOutputs;
+
+	int const	size		= (int)aInputs.size();
+	int const	nHidden		= (int)m_aHiddenUnits.size();
+	int const	nOutputs	= (int)m_aOutputUnits.size();
+
+	if ( (int)aHiddenOutputs.size() < size )
+	{
+		aHiddenOutputs.resize( size );
+	}
+	aOutputs.resize( size );
+	for ( int b = 0; b < size; b++ )
+	{
+		assert( (int)aInputs[b].size() == m_nInputs );
+		aHiddenOutputs[b].resize( nHidden );
+		aOutputs[b].resize( nOutputs );
 	}
 
-	return out;
+	int const	hiddenTileSize	= std::max( TILE_SIZE_IN_BYTES / std::max( m_nInputs * (int)sizeof( float ), 1 ), 1 );
+
+	for ( int first = 0; first < nHidden; first += hiddenTileSize )
+	{
+		int const	last	= std::min( first + hiddenTileSize, nHidden );
+
+		ComputeBatchSums( m_hiddenKernel, m_aHiddenUnits.data(), first, last, size, aInputs, aHiddenOutputs );
+
+		for ( int b = 0; b < size; b++ )
+		{
+			for ( int j = first; j < last; j++ )
+			{
+				aHiddenOutputs[b][j] = m_aHiddenUnits[j].Activation( aHiddenOutputs[b][j] );
+			}
+		}
+	}
+
+	int const	outputTileSize	= std::max( TILE_SIZE_IN_BYTES / std::max( nHidden * (int)sizeof( float ), 1 ), 1 );
+
+	for ( int first = 0; first < nOutputs; first += outputTileSize )
+	{
+		int const	last	= std::min( first + outputTileSize, nOutputs );
+
+		ComputeBatchSums( m_outputKernel, m_aOutputUnits.data(), first, last, size, aHiddenOutputs, aOutputs );
+
+		for ( int b = 0; b < size; b++ )
+		{
+			for ( int i = first; i < last; i++ )
+			{
+				aOutputs[b][i] = m_aOutputUnits[i].Activation( aOutputs[b][i] );
+			}
+		}
+	}
 }
 
 
@@ -193,30 +618,786 @@ std::ostream & operator<<( std::ostream & out, MultilayerFeedForward const & mff
 /*																													*/
 /********************************************************************************************************************/
 
-//! @param	in		The input stream.
-//! @param	mff		The MultilayerFeedForward to input.
+//! The outputs of the hidden units are stored in a buffer local to the calling thread. The selected outputs are
+//! computed with the same kernel as Evaluate() and TopK(), so they match their results.
 
-std::istream & operator>>( std::istream & in, MultilayerFeedForward & mff )
+void MultilayerFeedForward::EvaluateSelected( Neuron::InputVector const & aInputs, IndexVector const & aIndexes,
+											  OutputVector & aOutputs ) const
 {
-	in >> static_cast< NeuralNet & >( mff );
+	static thread_local OutputVector	aHiddenOutputs;
 
-	int		nOutputs;
-	int		nHidden;
+	EvaluateHidden( aInputs, aHiddenOutputs );
 
-	in >> nHidden >> nOutputs;
+	int const	nOutputs	= (int)m_aOutputUnits.size();
+	int const	size		= (int)aIndexes.size();
 
-	mff.m_aHiddenUnits.resize( nHidden );
-	mff.m_aOutputUnits.resize( nOutputs );
+	aOutputs.resize( size );
 
-	for ( int i = 0; i < nHidden; i++ )
+	for ( int k = 0; k < size; k++ )
 	{
-		in >> mff.m_aHiddenUnits[i];
+		assert( aIndexes[k] >= 0 && aIndexes[k] < nOutputs );
+
+		Neuron const &	unit	= m_aOutputUnits[aIndexes[k]];
+
+		ComputeSums( m_outputKernel, &unit, 1, aHiddenOutputs.data(), &aOutputs[k] );
+		aOutputs[k] = unit.Activation( aOutputs[k] );
 	}
+}
 
-	for ( int j = 0; j < nOutputs; j++ )
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The outputs of the hidden units are stored in a buffer local to the calling thread.
+
+void MultilayerFeedForward::TopK( Neuron::InputVector const & aInputs, int k, RankedOutputVector & aBest ) const
+{
+	static thread_local OutputVector	aHiddenOutputs;
+	static thread_local OutputVector	aSums;
+
+	int const	nOutputs	= (int)m_aOutputUnits.size();
+
+	aBest.clear();
+
+	if ( nOutputs == 0 )
 	{
-		in >> mff.m_aOutputUnits[j];
+		return;
 	}
 
+	EvaluateHidden( aInputs, aHiddenOutputs );
+
+	aSums.resize( nOutputs );
+	ComputeSums( m_outputKernel, m_aOutputUnits.data(), nOutputs, aHiddenOutputs.data(), aSums.data() );
+
+	for ( int i = 0; i < nOutputs; i++ )
+	{
+		AddCandidate( aBest, k, i, aSums[i] );
+	}
+
+	FinishCandidates( aBest, m_aOutputUnits[0] );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The hidden layer is skipped. This is used with outputs of the hidden units that have been computed in advance (see
+//! ActivationCache), which is much faster when the hidden layer is frozen and the same inputs are used repeatedly.
+//! The result may be used to train the output layer with TrainOutputs().
+//!
+//! @param	paHiddenOutputs		The outputs of the hidden units.
+//!
+//! @return		A vector of output values.
+
+MultilayerFeedForward::OutputVector const & MultilayerFeedForward::EvaluateFromHidden( float const * paHiddenOutputs )
+{
+	m_aHiddenOutputs.assign( paHiddenOutputs, paHiddenOutputs + m_aHiddenUnits.size() );
+	m_bHiddenSumsValid = false;		// The hidden sums no longer match the hidden outputs
+
+	UpdateOutputs();
+
+	return m_aOutputs;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! This is an incremental alternative to operator()( Neuron::InputVector const & ) for when successive inputs differ
+//! in only a few places. Rather than recomputing the combined input to each hidden unit from every input, only the
+//! contributions of the changed inputs are updated, so the cost of the first layer is proportional to the number
+//! of changes rather than to the number of inputs. The output layer is recomputed normally.
+//!
+//! The changes are applied to the inputs of the most recent evaluation, and the result becomes the new most recent
+//! inputs (the inputs that Train() would normally be given).
+//!
+//! @param	aChanges	The new values of the inputs that have changed. An input must not appear more than once.
+//! @return				A vector of output values. The size of the vector is the number of outputs.
+//!
+//! @note	The combined inputs accumulate rounding errors over many consecutive incremental evaluations. A full
+//!			evaluation resets them.
+//! @note	Training invalidates the saved combined inputs, so the first incremental evaluation after Train() is a
+//!			full evaluation.
+//! @warning	The net must have been evaluated with operator()( Neuron::InputVector const & ) at least once.
+
+MultilayerFeedForward::OutputVector const & MultilayerFeedForward::operator()( InputChangeVector const & aChanges )
+{
+	assert( (int)m_aInputs.size() == m_nInputs );
+
+	int const	nChanges	= (int)aChanges.size();
+
+#if !defined( NDEBUG )
+
+	// A repeated index would add the change of that input more than once to the saved combined inputs.
+
+	std::vector< bool >	aChanged( m_nInputs, false );
+
+	for ( int k = 0; k < nChanges; k++ )
+	{
+		int const	index	= aChanges[k].index;
+
+		assert( index >= 0 && index < m_nInputs );
+		assert( !aChanged[index] );
+		aChanged[index] = true;
+	}
+
+#endif // !defined( NDEBUG )
+
+	if ( !m_bHiddenSumsValid )
+	{
+		for ( int k = 0; k < nChanges; k++ )
+		{
+			m_aInputs[aChanges[k].index] = aChanges[k].value;
+		}
+
+		return ( *this )( m_aInputs );
+	}
+
+	// Update the hidden outputs by adding the contribution of the change in each changed input.
+
+	int const	nHidden	= (int)m_aHiddenUnits.size();
+
+	ForEachUnit( nHidden, nChanges, 0, [this, &aChanges, nChanges] ( int first, int last )
+	{
+		for ( int j = first; j < last; j++ )
+		{
+			Neuron::WeightStorage const &	aWeights	= m_aHiddenUnits[j].GetWeights();
+			float							sum			= m_aHiddenSums[j];
+
+			for ( int k = 0; k < nChanges; k++ )
+			{
+				int const	index	= aChanges[k].index;
+
+				sum += aWeights[index] * ( aChanges[k].value - m_aInputs[index] );
+			}
+
+			m_aHiddenSums[j]	= sum;
+			m_aHiddenOutputs[j]	= ( m_bInferenceOnly || m_bHiddenFrozen )
+								  ? m_aHiddenUnits[j].Activation( sum )
+								  : m_aHiddenUnits[j].Activation( sum, &m_aHiddenGradients[j] );
+		}
+	} );
+
+	for ( int k = 0; k < nChanges; k++ )
+	{
+		m_aInputs[aChanges[k].index] = aChanges[k].value;
+	}
+
+	// Update the outputs.
+
+	UpdateOutputs();
+
+	return m_aOutputs;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The batch is evaluated with the same kernels as EvaluateBatch(), and the outputs and derivatives of the hidden
+//! units are saved in @a gradients for ComputeHiddenGradients(). Since the changes to the output weights are complete
+//! before the hidden units are visited, they can be sent to other processes while the changes to the hidden weights
+//! are being computed.
+//!
+//! @param	aInputs		The inputs of the batch.
+//! @param	aTargets	The expected outputs. aTargets[b] is the expected output for aInputs[b].
+//! @param	gradients	Where to store the changes to the output weights and the loss.
+
+void MultilayerFeedForward::ComputeOutputGradients( InputBatch const & aInputs, OutputBatch const & aTargets,
+													Gradients & gradients ) const
+{
+	assert( aInputs.size() == aTargets.size() );
+
+	int const	size		= (int)aInputs.size();
+	int const	nHidden		= (int)m_aHiddenUnits.size();
+	int const	nOutputs	= (int)m_aOutputUnits.size();
+
+	gradients.aOutput.assign( nOutputs * nHidden, 0.f );
+	gradients.aHiddenOutputs.resize( size );
+	gradients.aHiddenDerivatives.resize( size );
+	gradients.aOutputDeltas.resize( size );
+	for ( int b = 0; b < size; b++ )
+	{
+		assert( (int)aInputs[b].size() == m_nInputs );
+		assert( (int)aTargets[b].size() == nOutputs );
+		gradients.aHiddenOutputs[b].resize( nHidden );
+		gradients.aHiddenDerivatives[b].resize( nHidden );
+		gradients.aOutputDeltas[b].resize( nOutputs );
+	}
+
+	ForEachUnit( nHidden, (int64_t)m_nInputs * size, m_hiddenKernel.tileSize, [&] ( int first, int last )
+	{
+		ComputeBatchSums( m_hiddenKernel, m_aHiddenUnits.data(), first, last, size, aInputs, gradients.aHiddenOutputs );
+
+		for ( int b = 0; b < size; b++ )
+		{
+			for ( int j = first; j < last; j++ )
+			{
+				float &	output	= gradients.aHiddenOutputs[b][j];
+
+				output = m_aHiddenUnits[j].Activation( output, &gradients.aHiddenDerivatives[b][j] );
+			}
+		}
+	} );
+
+	// The loss of each unit is kept separately and the losses are added up in order, so that the result does not
+	// depend on the number of threads.
+
+	std::vector< float >	aLosses( nOutputs );
+
+	ForEachUnit( nOutputs, (int64_t)nHidden * size, m_outputKernel.tileSize, [&] ( int first, int last )
+	{
+		// The sums are stored where the deltas go, and each one is replaced by its delta below.
+
+		ComputeBatchSums( m_outputKernel, m_aOutputUnits.data(), first, last, size, gradients.aHiddenOutputs,
+						  gradients.aOutputDeltas );
+
+		for ( int i = first; i < last; i++ )
+		{
+			Neuron const &	unit	= m_aOutputUnits[i];
+			float * const	paRow	= gradients.aOutput.data() + i * nHidden;
+			float			loss	= 0.f;
+
+			for ( int b = 0; b < size; b++ )
+			{
+				OutputVector const &	aHiddenOutputs	= gradients.aHiddenOutputs[b];
+				float					derivative;
+				float const				output			= unit.Activation( gradients.aOutputDeltas[b][i], &derivative );
+				float const				e				= aTargets[b][i] - output;
+				float const				delta			= derivative * e;
+
+				gradients.aOutputDeltas[b][i] = delta;
+				loss += 0.5f * e * e;
+
+				for ( int j = 0; j < nHidden; j++ )
+				{
+					paRow[j] += aHiddenOutputs[j] * delta;
+				}
+			}
+
+			aLosses[i] = loss;
+		}
+	} );
+
+	gradients.loss = 0.f;
+	for ( int i = 0; i < nOutputs; i++ )
+	{
+		gradients.loss += aLosses[i];
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! If the hidden layer is frozen, the changes are all 0.
+//!
+//! @param	aInputs		The inputs of the batch. They must be the same inputs given to ComputeOutputGradients().
+//! @param	gradients	The result of ComputeOutputGradients(). The changes to the hidden weights are stored in it.
+
+void MultilayerFeedForward::ComputeHiddenGradients( InputBatch const & aInputs, Gradients & gradients ) const
+{
+	int const	size		= (int)aInputs.size();
+	int const	nHidden		= (int)m_aHiddenUnits.size();
+	int const	nOutputs	= (int)m_aOutputUnits.size();
+
+	assert( (int)gradients.aOutputDeltas.size() == size );
+
+	gradients.aHidden.assign( nHidden * m_nInputs, 0.f );
+
+	if ( m_bHiddenFrozen )
+	{
+		return;
+	}
+
+	ForEachUnit( nHidden, (int64_t)m_nInputs * size, m_hiddenKernel.tileSize, [&] ( int first, int last )
+	{
+		for ( int j = first; j < last; j++ )
+		{
+			float * const	paRow	= gradients.aHidden.data() + j * m_nInputs;
+
+			for ( int b = 0; b < size; b++ )
+			{
+				OutputVector const &		aOutputDeltas	= gradients.aOutputDeltas[b];
+				Neuron::InputVector const &	aUnitInputs		= aInputs[b];
+
+				float	s	= 0.f;
+				for ( int i = 0; i < nOutputs; i++ )
+				{
+					s += m_aOutputUnits[i].GetWeights()[j] * aOutputDeltas[i];
+				}
+
+				float const	delta	= gradients.aHiddenDerivatives[b][j] * s;
+
+				for ( int k = 0; k < m_nInputs; k++ )
+				{
+					paRow[k] += aUnitInputs[k] * delta;
+				}
+			}
+		}
+	} );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	aInputs		The inputs of the batch.
+//! @param	aTargets	The expected outputs. aTargets[b] is the expected output for aInputs[b].
+//! @param	gradients	Where to store the changes to the weights and the loss.
+
+void MultilayerFeedForward::ComputeGradients( InputBatch const & aInputs, OutputBatch const & aTargets,
+											  Gradients & gradients ) const
+{
+	ComputeOutputGradients( aInputs, aTargets, gradients );
+	ComputeHiddenGradients( aInputs, gradients );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The weights are adjusted using this formula: <tt>W += changes * rate</tt>. Unlike Train(), which uses the new
+//! weights of the output units to compute the changes to the hidden units, all the changes are computed from the
+//! weights before they are changed. The weights of frozen layers are not changed.
+//!
+//! @param	gradients	The changes, as computed by ComputeGradients() (possibly combined with others).
+//! @param	rate		The learning rate.
+
+void MultilayerFeedForward::ApplyGradients( Gradients const & gradients, float rate )
+{
+	assert( !m_bInferenceOnly );
+
+	int const	nHidden		= (int)m_aHiddenUnits.size();
+	int const	nOutputs	= (int)m_aOutputUnits.size();
+
+	assert( (int)gradients.aHidden.size() == nHidden * m_nInputs );
+	assert( (int)gradients.aOutput.size() == nOutputs * nHidden );
+
+	UpdateVersion();
+
+	if ( !m_bOutputFrozen )
+	{
+		ForEachUnit( nOutputs, nHidden, m_outputKernel.tileSize, [&] ( int first, int last )
+		{
+			for ( int i = first; i < last; i++ )
+			{
+				m_aOutputUnits[i].AdjustWeights( gradients.aOutput.data() + i * nHidden, rate );
+			}
+		} );
+	}
+
+	if ( !m_bHiddenFrozen )
+	{
+		ForEachUnit( nHidden, m_nInputs, m_hiddenKernel.tileSize, [this, &gradients, rate] ( int first, int last )
+		{
+			for ( int j = first; j < last; j++ )
+			{
+				m_aHiddenUnits[j].AdjustWeights( gradients.aHidden.data() + j * m_nInputs, rate );
+			}
+		} );
+
+		m_bHiddenSumsValid = false;
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+void MultilayerFeedForward::Train( Neuron::InputVector const & aInputs, ErrorVector const & aErrors, float rate )
+{
+	assert( !m_bInferenceOnly );
+	assert( (int)aInputs.size() == m_nInputs );
+	assert( aErrors.size() == m_aOutputUnits.size() );
+
+	int const	nOutputs	= (int)m_aOutputUnits.size();
+	int const	nHidden		= (int)m_aHiddenUnits.size();
+
+	UpdateVersion();
+
+	// The errors are propagated back through the output layer even if it is frozen, unless the hidden layer is frozen
+	// too.
+
+	if ( !m_bHiddenFrozen || !m_bOutputFrozen )
+	{
+		TrainOutputLayer( aErrors, rate );
+	}
+
+	if ( !m_bHiddenFrozen )
+	{
+		ForEachUnit( nHidden, m_nInputs, m_hiddenKernel.tileSize, [&] ( int first, int last )
+		{
+			for ( int j = first; j < last; j++ )
+			{
+				float	s	= 0.f;
+				for ( int i = 0; i < nOutputs; i++ )
+				{
+					s += m_aOutputUnits[i].GetWeights()[j] * m_aOutputGradients[i];
+				}
+				m_aHiddenGradients[j] *= s;
+
+				m_aHiddenUnits[j].AdjustWeights( aInputs, m_aHiddenGradients[j], rate );
+			}
+		} );
+
+		m_bHiddenSumsValid = false;
+	}
+
+	if ( m_pMetrics != 0 )
+	{
+		PublishMetrics( aInputs, aErrors, rate );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The hidden layer must be frozen (see SetFrozen()). This is used to train the output layer from the outputs of the
+//! hidden units that have been computed in advance (see ActivationCache and EvaluateFromHidden()).
+//!
+//! @param	aErrors		The error values for each output.
+//! @param	rate		The learning rate.
+
+void MultilayerFeedForward::TrainOutputs( ErrorVector const & aErrors, float rate )
+{
+	assert( !m_bInferenceOnly );
+	assert( m_bHiddenFrozen );
+	assert( aErrors.size() == m_aOutputUnits.size() );
+
+	UpdateVersion();
+
+	if ( !m_bOutputFrozen )
+	{
+		TrainOutputLayer( aErrors, rate );
+	}
+
+	if ( m_pMetrics != 0 )
+	{
+		PublishMetrics( m_aInputs, aErrors, rate );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The gradients of the output units are multiplied by the errors so that they can be propagated back to the hidden
+//! layer. The weights are changed only if the output layer is not frozen.
+//!
+//! @param	aErrors		The error values for each output.
+//! @param	rate		The learning rate.
+
+void MultilayerFeedForward::TrainOutputLayer( ErrorVector const & aErrors, float rate )
+{
+	int const	nOutputs	= (int)m_aOutputUnits.size();
+	int const	nHidden		= (int)m_aHiddenUnits.size();
+
+	ForEachUnit( nOutputs, nHidden, m_outputKernel.tileSize, [this, &aErrors, rate] ( int first, int last )
+	{
+		for ( int i = first; i < last; i++ )
+		{
+			m_aOutputGradients[i] *= aErrors[i];
+			if ( !m_bOutputFrozen )
+			{
+				m_aOutputUnits[i].AdjustWeights( m_aHiddenOutputs, m_aOutputGradients[i], rate );
+			}
+		}
+	} );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The weights of a unit change by @a rate times the unit's gradient times its inputs, so the norm of the gradient
+//! with respect to the weights of a layer is the norm of the layer's gradients times the norm of its inputs. The
+//! statistics are computed from the gradients that Train() has just used, without visiting the weights. The weights
+//! of frozen layers are not included in the norms.
+//!
+//! @param	aInputs		The inputs the net was trained with.
+//! @param	aErrors		The errors the net was trained with.
+//! @param	rate		The learning rate.
+
+void MultilayerFeedForward::PublishMetrics( Neuron::InputVector const & aInputs, ErrorVector const & aErrors,
+											float rate ) const
+{
+	int const	nOutputs	= (int)m_aOutputUnits.size();
+	int const	nHidden		= (int)m_aHiddenUnits.size();
+	float		errorSquares			= 0.f;
+	float		outputGradientSquares	= 0.f;
+	float		hiddenGradientSquares	= 0.f;
+	float		hiddenOutputSquares		= 0.f;
+	float		inputSquares			= 0.f;
+	int			nSaturated				= 0;
+
+	for ( int i = 0; i < nOutputs; i++ )
+	{
+		errorSquares			+= aErrors[i] * aErrors[i];
+		outputGradientSquares	+= m_aOutputGradients[i] * m_aOutputGradients[i];
+		if ( MetricsStream::IsSaturated( m_aOutputs[i] ) )
+		{
+			++nSaturated;
+		}
+	}
+
+	for ( int j = 0; j < nHidden; j++ )
+	{
+		hiddenOutputSquares += m_aHiddenOutputs[j] * m_aHiddenOutputs[j];
+		if ( MetricsStream::IsSaturated( m_aHiddenOutputs[j] ) )
+		{
+			++nSaturated;
+		}
+	}
+
+	if ( !m_bHiddenFrozen )
+	{
+		for ( int j = 0; j < nHidden; j++ )
+		{
+			hiddenGradientSquares += m_aHiddenGradients[j] * m_aHiddenGradients[j];
+		}
+
+		for ( int k = 0; k < m_nInputs; k++ )
+		{
+			inputSquares += aInputs[k] * aInputs[k];
+		}
+	}
+
+	if ( m_bOutputFrozen )
+	{
+		outputGradientSquares = 0.f;
+	}
+
+	MetricsStream::Stats	stats;
+	stats.loss				= 0.5f * errorSquares;
+	stats.gradientNorm		= std::sqrt( outputGradientSquares * hiddenOutputSquares +
+										 hiddenGradientSquares * inputSquares );
+	stats.updateMagnitude	= rate * stats.gradientNorm;
+	stats.saturation		= ( nOutputs + nHidden > 0 ) ? (float)nSaturated / ( nOutputs + nHidden ) : 0.f;
+
+	m_pMetrics->Publish( stats );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+void MultilayerFeedForward::UpdateOutputs()
+{
+	int const	nHidden		= (int)m_aHiddenUnits.size();
+	int const	nOutputs	= (int)m_aOutputUnits.size();
+
+	ForEachUnit( nOutputs, nHidden, m_outputKernel.tileSize, [this] ( int first, int last )
+	{
+		ComputeSums( m_outputKernel, m_aOutputUnits.data() + first, last - first, m_aHiddenOutputs.data(),
+					 m_aOutputs.data() + first );
+
+		for ( int i = first; i < last; i++ )
+		{
+			Neuron const &	unit	= m_aOutputUnits[i];
+			float const		sum		= m_aOutputs[i];
+
+			m_aOutputs[i] = m_bInferenceOnly ? unit.Activation( sum ) : unit.Activation( sum, &m_aOutputGradients[i] );
+		}
+	} );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	kernel		The kernel configuration of the layer.
+//! @param	paUnits		The units of the layer.
+//! @param	first		The first unit.
+//! @param	last		The unit after the last unit.
+//! @param	size		The number of samples.
+//! @param	aInputs		The inputs of the layer for each sample.
+//! @param	aSums		Where to store the combined inputs. aSums[b][j] is set for each sample b and each unit j from
+//!						@a first to @a last.
+
+void MultilayerFeedForward::ComputeBatchSums( KernelConfig const & kernel, Neuron const * paUnits, int first, int last,
+											  int size, InputBatch const & aInputs, OutputBatch & aSums )
+{
+	for ( int b = 0; b < size; b++ )
+	{
+		ComputeSums( kernel, paUnits + first, last - first, aInputs[b].data(), aSums[b].data() + first );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The amount of work is computed in 64 bits, since a large layer evaluated for a large batch has more than 2^31
+//! multiplications.
+//!
+//! @param	nUnits		The number of units in the layer.
+//! @param	nInputs		The number of inputs to each unit in the layer (times the number of samples, for a batch).
+//! @param	tileSize	The number of units in each tile, or 0 to use tiles of about TILE_SIZE_IN_BYTES of weights.
+//! @param	f			The function to call for each tile of units.
+
+void MultilayerFeedForward::ForEachUnit( int nUnits, int64_t nInputs, int tileSize,
+										 std::function< void ( int first, int last ) > const & f ) const
+{
+	if ( m_pThreadPool != 0 && (int64_t)nUnits * nInputs >= m_parallelThreshold )
+	{
+		if ( tileSize <= 0 )
+		{
+			int64_t const	unitSize	= std::max( nInputs * (int64_t)sizeof( float ), (int64_t)1 );
+
+			tileSize = (int)std::max( TILE_SIZE_IN_BYTES / unitSize, (int64_t)1 );
+		}
+
+		m_pThreadPool->ParallelFor( nUnits, tileSize, f );
+	}
+	else
+	{
+		f( 0, nUnits );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The weights of new units are empty, and the buffers are resized to match. The most recent inputs are reset to
+//! zeros, so they always have one value for each input.
+//!
+//! @param	nInputs		The number of inputs.
+//! @param	nHidden		The number of hidden units.
+//! @param	nOutputs	The number of outputs.
+
+void MultilayerFeedForward::Resize( int nInputs, int nHidden, int nOutputs )
+{
+	m_nInputs = nInputs;
+	m_aInputs.assign( nInputs, 0.f );
+	m_aOutputs.resize( nOutputs, 0.f );
+	m_aHiddenUnits.resize( nHidden );
+	m_aHiddenSums.resize( nHidden );
+	m_aHiddenOutputs.resize( nHidden );
+	m_aHiddenGradients.resize( m_bInferenceOnly ? 0 : nHidden );
+	m_aOutputUnits.resize( nOutputs );
+	m_aOutputGradients.resize( m_bInferenceOnly ? 0 : nOutputs );
+	m_bHiddenSumsValid = false;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Without an autotuner, both layers use the default kernel. In deterministic mode, the order of the additions is
+//! fixed (see SetDeterministic()).
+
+void MultilayerFeedForward::ConfigureKernels()
+{
+	if ( m_pAutotuner == 0 )
+	{
+		m_hiddenKernel = KernelConfig();
+		m_outputKernel = KernelConfig();
+	}
+	else
+	{
+		int const	nHidden		= (int)m_aHiddenUnits.size();
+		int const	nOutputs	= (int)m_aOutputUnits.size();
+
+		// A layer is tuned for the thread pool only if it is large enough to be split across the pool.
+
+		ThreadPool * const	pHiddenPool	= ( (int64_t)nHidden * m_nInputs >= m_parallelThreshold ) ? m_pThreadPool : 0;
+		ThreadPool * const	pOutputPool	= ( (int64_t)nOutputs * nHidden >= m_parallelThreshold ) ? m_pThreadPool : 0;
+
+		m_hiddenKernel = m_pAutotuner->Get( nHidden, m_nInputs, pHiddenPool );
+		m_outputKernel = m_pAutotuner->Get( nOutputs, nHidden, pOutputPool );
+	}
+
+	if ( m_bDeterministic )
+	{
+		m_hiddenKernel.unroll = DETERMINISTIC_UNROLL;
+		m_outputKernel.unroll = DETERMINISTIC_UNROLL;
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	out		The output stream.
+//! @param	mff		The MultilayerFeedForward to output.
+
+std::ostream & operator<<( std::ostream & out, MultilayerFeedForward const & mff )
+{
+	out << static_cast< NeuralNet const & >( mff );
+
+	int const	nHidden	= (int)mff.m_aHiddenUnits.size();
+	int const	nOutputs	= (int)mff.m_aOutputUnits.size();
+
+	out << ' ' << nHidden << ' ' << nOutputs << std::endl;
+
+	for ( int i = 0; i < nHidden; i++ )
+	{
+		out << mff.m_aHiddenUnits[i] << std::endl;
+	}
+
+	for ( int j = 0; j < nOutputs; j++ )
+	{
+		out << mff.m_aOutputUnits[j] << std::endl;
+	}
+
+	return out;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	in		The input stream.
+//! @param	mff		The MultilayerFeedForward to input.
+
+std::istream & operator>>( std::istream & in, MultilayerFeedForward & mff )
+{
+	in >> static_cast< NeuralNet & >( mff );
+
+	int		nOutputs;
+	int		nHidden;
+
+	in >> nHidden >> nOutputs;
+
+	if ( !in )
+	{
+		return in;
+	}
+
+	mff.Resize( mff.m_nInputs, nHidden, nOutputs );
+
+	for ( int i = 0; i < nHidden; i++ )
+	{
+		in >> mff.m_aHiddenUnits[i];
+	}
+
+	for ( int j = 0; j < nOutputs; j++ )
+	{
+		in >> mff.m_aOutputUnits[j];
+	}
+
+	mff.ConfigureKernels();
+
 	return in;
 }
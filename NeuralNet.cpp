@@ -13,15 +13,34 @@
 
 #include "NeuralNet.h"
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 
+//! The most recent version given to the weights of any net.
+static std::atomic< uint64_t >	s_lastVersion( 0 );
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @return		A version that has not been given to the weights of any net.
+
+static uint64_t NextVersion()
+{
+	return s_lastVersion.fetch_add( 1, std::memory_order_relaxed ) + 1;
+}
+
 
 /********************************************************************************************************************/
 /*																													*/
 /********************************************************************************************************************/
 
 NeuralNet::NeuralNet()
-: m_nInputs( 0 )
+: m_nInputs( 0 ),
+	m_pMetrics( 0 ),
+	m_version( NextVersion() )
 {
 }
 
@@ -35,7 +54,9 @@ NeuralNet::NeuralNet()
 
 NeuralNet::NeuralNet( int nInputs, int nOutputs )
 	: m_nInputs( nInputs ),
-	m_aOutputs( nOutputs, 0.f )
+	m_aOutputs( nOutputs, 0.f ),
+	m_pMetrics( 0 ),
+	m_version( NextVersion() )
 {
 }
 
@@ -50,6 +71,114 @@ NeuralNet::~NeuralNet()
 }
 
 
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+void NeuralNet::EvaluateBatch( InputBatch const & aInputs, OutputBatch & aOutputs ) const
+{
+	int const	size	= (int)aInputs.size();
+
+	aOutputs.resize( size );
+
+	for ( int b = 0; b < size; b++ )
+	{
+		Evaluate( aInputs[b], aOutputs[b] );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	aInputs		The input values.
+//!
+//! @return		The index of the largest output. Ties are won by the lowest index.
+
+int NeuralNet::ArgMax( Neuron::InputVector const & aInputs ) const
+{
+	static thread_local RankedOutputVector	aBest;
+
+	TopK( aInputs, 1, aBest );
+
+	return aBest.empty() ? -1 : aBest[0].index;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Derived classes call this whenever they change the weights.
+
+void NeuralNet::UpdateVersion()
+{
+	m_version = NextVersion();
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Outputs are compared by value, and then by index (lower is better) so that the results are deterministic.
+
+static bool IsBetter( NeuralNet::RankedOutput const & a, NeuralNet::RankedOutput const & b )
+{
+	return ( a.value > b.value ) || ( a.value == b.value && a.index < b.index );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The candidates are kept in a heap with the worst one at the top, so each candidate costs O(log k).
+//!
+//! @param	aBest	The best candidates found so far.
+//! @param	k		The number of candidates to keep.
+//! @param	index	Index of the output.
+//! @param	x		The combined input to the output unit.
+
+void NeuralNet::AddCandidate( RankedOutputVector & aBest, int k, int index, float x )
+{
+	RankedOutput	candidate;
+	candidate.index	= index;
+	candidate.value	= x;
+
+	if ( (int)aBest.size() < k )
+	{
+		aBest.push_back( candidate );
+		std::push_heap( aBest.begin(), aBest.end(), IsBetter );
+	}
+	else if ( k > 0 && IsBetter( candidate, aBest.front() ) )
+	{
+		std::pop_heap( aBest.begin(), aBest.end(), IsBetter );
+		aBest.back() = candidate;
+		std::push_heap( aBest.begin(), aBest.end(), IsBetter );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	aBest	The best candidates, as built by AddCandidate().
+//! @param	unit	A unit whose activation function converts the combined inputs to outputs.
+
+void NeuralNet::FinishCandidates( RankedOutputVector & aBest, Neuron const & unit )
+{
+	std::sort_heap( aBest.begin(), aBest.end(), IsBetter );
+
+	for ( size_t i = 0; i < aBest.size(); i++ )
+	{
+		aBest[i].value = unit.Activation( aBest[i].value );
+	}
+}
+
+
 /********************************************************************************************************************/
 /*																													*/
 /********************************************************************************************************************/
@@ -77,6 +206,13 @@ std::istream & operator>>( std::istream & in, NeuralNet & nn )
 	int	size;
 	in >> nn.m_nInputs >> size;
 
+	nn.UpdateVersion();	// Even if the extraction fails, the net may have changed
+
+	if ( !in )
+	{
+		return in;
+	}
+
 	nn.m_aOutputs.resize( size, 0.f );
 
 	return in;
@@ -13,6 +13,9 @@
 
 #include "Neuron.h"
 
+#include "TextFormat.h"
+
+#include <atomic>
 #include <cmath>
 #include <vector>
 #include <iostream>
@@ -26,6 +29,7 @@
 //! @warning Use Neuron::Initialize to initialize a Neuron constructed by the default constructor.
 
 Neuron::Neuron()
+	: m_pWeights( std::make_shared< WeightStorage >() )
 {
 }
 
@@ -38,7 +42,7 @@ Neuron::Neuron()
 //! @param	nInputs		Number of inputs
 
 Neuron::Neuron( int nInputs )
-	: m_aWeights( nInputs, 1.f )
+	: m_pWeights( std::make_shared< WeightStorage >( nInputs, 1.f ) )
 {
 }
 
@@ -52,7 +56,7 @@ Neuron::Neuron( int nInputs )
 //! @note	The number of inputs is implied by the size of the weight vector.
 
 Neuron::Neuron( WeightVector const & aWeights )
-	: m_aWeights( aWeights )
+	: m_pWeights( std::make_shared< WeightStorage >( aWeights.begin(), aWeights.end() ) )
 {
 }
 
@@ -78,7 +82,23 @@ Neuron::~Neuron()
 
 void Neuron::Initialize( WeightVector const & aWeights )
 {
-	m_aWeights = aWeights;
+	m_pWeights = std::make_shared< WeightStorage >( aWeights.begin(), aWeights.end(), m_pWeights->get_allocator() );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The weights are copied into memory allocated from @a pResource, so they are no longer shared with copies of
+//! this neuron. This is how the weights are placed in aligned, huge-page or NUMA-local memory (see
+//! MemoryResources.h).
+//!
+//! @param	pResource	The memory resource. It must outlive the neuron and its copies.
+
+void Neuron::SetMemoryResource( std::pmr::memory_resource * pResource )
+{
+	m_pWeights = std::make_shared< WeightStorage >( *m_pWeights, pResource );
 }
 
 
@@ -91,14 +111,16 @@ void Neuron::Initialize( WeightVector const & aWeights )
 
 float Neuron::Input( InputVector const & aInputs ) const
 {
-	assert( aInputs.size() == m_aWeights.size() );
+	WeightStorage const &	aWeights	= *m_pWeights;
+
+	assert( aInputs.size() == aWeights.size() );
 
 	int const	nInputs	= (int)aInputs.size();
 	float		input	= 0;
 
 	for ( int i = 0; i < nInputs; i++ )
 	{
-		input += aInputs[i] * m_aWeights[i];
+		input += aInputs[i] * aWeights[i];
 	}
 
 	return input;
@@ -117,13 +139,67 @@ float Neuron::Input( InputVector const & aInputs ) const
 
 void Neuron::AdjustWeights( InputVector const & aInputs, float e, float rate )
 {
-	assert( aInputs.size() == m_aWeights.size() );
+	Unshare();
+
+	WeightStorage &	aWeights	= *m_pWeights;
+
+	assert( aInputs.size() == aWeights.size() );
 
 	int const	size	= (int)aInputs.size();
 
 	for ( int i = 0; i < size; i++ )
 	{
-		m_aWeights[i] += aInputs[i] * e * rate;
+		aWeights[i] += aInputs[i] * e * rate;
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The weights are adjusted using this formula: <tt>W[i] += paChanges[i] * rate</tt>.
+//!
+//! @param	paChanges	The changes to the weights, one for each input (for example, the sum of the changes
+//!						computed for a batch of inputs).
+//! @param	rate		The learning rate
+
+void Neuron::AdjustWeights( float const * paChanges, float rate )
+{
+	Unshare();
+
+	WeightStorage &	aWeights	= *m_pWeights;
+
+	int const	size	= (int)aWeights.size();
+
+	for ( int i = 0; i < size; i++ )
+	{
+		aWeights[i] += paChanges[i] * rate;
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! If the weights are shared with another neuron, this neuron gets its own copy of them.
+//!
+//! @note	Copies of a neuron may be changed concurrently by different threads, but a neuron must not be copied while
+//!			another thread is changing it.
+
+void Neuron::Unshare()
+{
+	if ( m_pWeights.use_count() > 1 )
+	{
+		m_pWeights = std::make_shared< WeightStorage >( *m_pWeights, m_pWeights->get_allocator() );
+	}
+	else
+	{
+		// Another copy may have just given up its reference on a different thread. This fence ensures that it has
+		// finished reading the weights before they are changed.
+
+		std::atomic_thread_fence( std::memory_order_acquire );
 	}
 }
 
@@ -206,20 +282,35 @@ float Neuron::Sigmoid( float x, float * pd )
 /*																													*/
 /********************************************************************************************************************/
 
+//! Each weight is written as the shortest text that reads back as exactly the same value (see TextFormat.h), so the
+//! weights are not rounded and the precision of the stream is ignored.
+//!
 //! @param	out		The output stream.
 //! @param	n		The Neuron to output.
 
 std::ostream & operator<<( std::ostream & out, Neuron const & n )
 {
-	int const	size	= (int)n.m_aWeights.size();
+	Neuron::WeightStorage const &	aWeights	= *n.m_pWeights;
+	int const						size		= (int)aWeights.size();
 
 	out << size;
 
+	// The weights are formatted into a buffer and written together.
+
+	static thread_local std::vector< char >	aText;
+
+	aText.resize( (size_t)size * ( 1 + MAX_FLOAT_TEXT_SIZE ) );
+
+	char *	p	= aText.data();
+
 	for ( int i = 0; i < size; i++ )
 	{
-		out << ' ' << n.m_aWeights[i];
+		*p++	= ' ';
+		p		= FormatFloat( aWeights[i], p );
 	}
 
+	out.write( aText.data(), p - aText.data() );
+
 	return out;
 }
 
@@ -228,6 +319,8 @@ std::ostream & operator<<( std::ostream & out, Neuron const & n )
 /*																													*/
 /********************************************************************************************************************/
 
+//! The weights are read without using the locale of the stream (see ReadFloat()).
+//!
 //! @param	in		The input stream.
 //! @param	n		The Neuron to input.
 
@@ -237,12 +330,20 @@ std::istream & operator>>( std::istream & in, Neuron & n )
 
 	in >> size;
 
-	n.m_aWeights.resize( size );
+	if ( !in )
+	{
+		return in;
+	}
+
+	std::shared_ptr< Neuron::WeightStorage >	pWeights	=
+		std::make_shared< Neuron::WeightStorage >( size, n.m_pWeights->get_allocator() );
 
 	for ( int i = 0; i < size; i++ )
 	{
-		in >> n.m_aWeights[i];
+		ReadFloat( in, ( *pWeights )[i] );
 	}
 
+	n.m_pWeights = pWeights;
+
 	return in;
 }
@@ -13,6 +13,9 @@
 
 #include "Perceptron.h"
 
+#include "MetricsStream.h"
+
+#include <cmath>
 #include <vector>
 #include <iostream>
 #include <cassert>
@@ -72,6 +75,128 @@ Perceptron::~Perceptron()
 }
 
 
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @return		The weights in the same order as they are given to the constructor: the input weights of each unit.
+
+Neuron::WeightVector Perceptron::GetWeights() const
+{
+	int const	nOutputs	= (int)m_aOutputUnits.size();
+
+	Neuron::WeightVector	aWeights;
+	aWeights.reserve( m_nInputs * nOutputs );
+
+	for ( int i = 0; i < nOutputs; i++ )
+	{
+		Neuron::WeightStorage const &	aUnitWeights	= m_aOutputUnits[i].GetWeights();
+		aWeights.insert( aWeights.end(), aUnitWeights.begin(), aUnitWeights.end() );
+	}
+
+	return aWeights;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+void Perceptron::SetMemoryResource( std::pmr::memory_resource * pResource )
+{
+	for ( size_t i = 0; i < m_aOutputUnits.size(); i++ )
+	{
+		m_aOutputUnits[i].SetMemoryResource( pResource );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+void Perceptron::Evaluate( Neuron::InputVector const & aInputs, OutputVector & aOutputs ) const
+{
+	int const	nOutputs	= (int)m_aOutputUnits.size();
+
+	aOutputs.resize( nOutputs );
+
+	for ( int i = 0; i < nOutputs; i++ )
+	{
+		aOutputs[i] = m_aOutputUnits[i]( aInputs );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+void Perceptron::EvaluateBatch( InputBatch const & aInputs, OutputBatch & aOutputs ) const
+{
+	int const	size		= (int)aInputs.size();
+	int const	nOutputs	= (int)m_aOutputUnits.size();
+
+	aOutputs.resize( size );
+	for ( int b = 0; b < size; b++ )
+	{
+		aOutputs[b].resize( nOutputs );
+	}
+
+	for ( int i = 0; i < nOutputs; i++ )
+	{
+		Neuron const &	unit	= m_aOutputUnits[i];
+
+		for ( int b = 0; b < size; b++ )
+		{
+			aOutputs[b][i] = unit( aInputs[b] );
+		}
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+void Perceptron::EvaluateSelected( Neuron::InputVector const & aInputs, IndexVector const & aIndexes,
+								   OutputVector & aOutputs ) const
+{
+	int const	size	= (int)aIndexes.size();
+
+	aOutputs.resize( size );
+
+	for ( int k = 0; k < size; k++ )
+	{
+		aOutputs[k] = m_aOutputUnits[aIndexes[k]]( aInputs );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+void Perceptron::TopK( Neuron::InputVector const & aInputs, int k, RankedOutputVector & aBest ) const
+{
+	int const	nOutputs	= (int)m_aOutputUnits.size();
+
+	aBest.clear();
+
+	if ( nOutputs == 0 )
+	{
+		return;
+	}
+
+	for ( int i = 0; i < nOutputs; i++ )
+	{
+		AddCandidate( aBest, k, i, m_aOutputUnits[i].Input( aInputs ) );
+	}
+
+	FinishCandidates( aBest, m_aOutputUnits[0] );
+}
+
+
 /********************************************************************************************************************/
 /*																													*/
 /********************************************************************************************************************/
@@ -102,6 +227,8 @@ void Perceptron::Train( Neuron::InputVector const & aInputs, ErrorVector const &
 
 	int const	nOutputs	= (int)m_aOutputUnits.size();
 
+	UpdateVersion();
+
 	// Train each neuron.
 
 	for ( int i = 0; i < nOutputs; i++ )
@@ -109,6 +236,52 @@ void Perceptron::Train( Neuron::InputVector const & aInputs, ErrorVector const &
 		m_aOutputUnits[i].AdjustWeights( aInputs, aErrors[i], rate );
 	}
 
+	if ( m_pMetrics != 0 )
+	{
+		PublishMetrics( aInputs, aErrors, rate );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The weights of output unit @a i change by @a rate * aErrors[i] * aInputs, so the norms of the gradient and of the
+//! change are computed from the norms of the errors and the inputs without visiting the weights.
+//!
+//! @param	aInputs		The inputs the net was trained with.
+//! @param	aErrors		The errors the net was trained with.
+//! @param	rate		The learning rate.
+
+void Perceptron::PublishMetrics( Neuron::InputVector const & aInputs, ErrorVector const & aErrors, float rate ) const
+{
+	int const	nOutputs		= (int)m_aOutputs.size();
+	float		errorSquares	= 0.f;
+	float		inputSquares	= 0.f;
+	int			nSaturated		= 0;
+
+	for ( int i = 0; i < nOutputs; i++ )
+	{
+		errorSquares += aErrors[i] * aErrors[i];
+		if ( MetricsStream::IsSaturated( m_aOutputs[i] ) )
+		{
+			++nSaturated;
+		}
+	}
+
+	for ( int i = 0; i < m_nInputs; i++ )
+	{
+		inputSquares += aInputs[i] * aInputs[i];
+	}
+
+	MetricsStream::Stats	stats;
+	stats.loss				= 0.5f * errorSquares;
+	stats.gradientNorm		= std::sqrt( errorSquares * inputSquares );
+	stats.updateMagnitude	= rate * stats.gradientNorm;
+	stats.saturation		= ( nOutputs > 0 ) ? (float)nSaturated / nOutputs : 0.f;
+
+	m_pMetrics->Publish( stats );
 }
 
 
@@ -150,6 +323,11 @@ std::istream & operator>>( std::istream & in, Perceptron & p )
 	int	nOutputs;
 	in >> nOutputs;
 
+	if ( !in )
+	{
+		return in;
+	}
+
 	p.m_aOutputUnits.resize( nOutputs );
 
 	for ( int i = 0; i < nOutputs; i++ )
@@ -0,0 +1,255 @@
+/** @file *//********************************************************************************************************
+
+                                                 PredictionCache.cpp
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/PredictionCache.cpp#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#include "PredictionCache.h"
+
+#include "Fnv1a.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+//! The smallest quantized value. Smaller values are clamped to it.
+static float const	MIN_QUANTIZED	= -2147483648.f;
+
+//! The largest quantized value (the largest float that fits in an int32_t). Larger values are clamped to it.
+static float const	MAX_QUANTIZED	= 2147483520.f;
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	net			The net. It must outlive the cache.
+//! @param	capacity	The maximum number of inputs in the cache. It is rounded up to a multiple of NUM_SHARDS.
+//! @param	quantum		The inputs are rounded to multiples of this value before they are looked up, or 0 if they
+//!						must match exactly.
+
+PredictionCache::PredictionCache( NeuralNet const & net,
+								  int capacity /* = DEFAULT_CAPACITY*/,
+								  float quantum /* = 0.f*/ )
+	: m_net( net ),
+	m_shardCapacity( ( capacity + NUM_SHARDS - 1 ) / NUM_SHARDS ),
+	m_quantum( quantum )
+{
+	assert( capacity > 0 );
+	assert( quantum >= 0.f );
+
+	for ( int s = 0; s < NUM_SHARDS; s++ )
+	{
+		m_aShards[s].version = net.GetVersion();
+	}
+
+	ResetStatistics();
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+PredictionCache::~PredictionCache()
+{
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! This may be called by several threads at once. The net is evaluated without holding a lock, so a lookup in a
+//! shard is never held up by the evaluation of another input.
+//!
+//! @param	aInputs		The input values.
+//! @param	aOutputs	Where to store the output values.
+
+void PredictionCache::Evaluate( Neuron::InputVector const & aInputs, NeuralNet::OutputVector & aOutputs )
+{
+	static thread_local Key	key;
+
+	uint64_t const	hash	= MakeKey( aInputs, key );
+	uint64_t const	version	= m_net.GetVersion();
+	Shard &			shard	= m_aShards[hash % NUM_SHARDS];
+
+	{
+		std::lock_guard< std::mutex >	lock( shard.mutex );
+
+		if ( shard.version != version )
+		{
+			if ( !shard.entries.empty() )
+			{
+				shard.entries.clear();
+				shard.index.clear();
+				++shard.statistics.nInvalidations;
+			}
+
+			shard.version = version;
+		}
+
+		EntryIndex::iterator const	found	= shard.index.find( hash );
+
+		if ( found != shard.index.end() && found->second->key == key )
+		{
+			shard.entries.splice( shard.entries.begin(), shard.entries, found->second );
+			aOutputs = found->second->aOutputs;
+			++shard.statistics.nHits;
+			return;
+		}
+
+		++shard.statistics.nMisses;
+	}
+
+	m_net.Evaluate( aInputs, aOutputs );
+
+	std::lock_guard< std::mutex >	lock( shard.mutex );
+
+	if ( shard.version != version )
+	{
+		return;		// The outputs are for an older version of the net
+	}
+
+	EntryIndex::iterator const	found	= shard.index.find( hash );
+	EntryList::iterator			entry;
+
+	if ( found != shard.index.end() )
+	{
+		// The same input was added by another thread, or a different input has the same hash
+		entry = found->second;
+	}
+	else if ( (int)shard.entries.size() < m_shardCapacity )
+	{
+		entry = shard.entries.emplace( shard.entries.begin() );
+		shard.index[hash] = entry;
+	}
+	else
+	{
+		// The least recently used entry is reused for the new input, so its memory is reused too.
+
+		entry = std::prev( shard.entries.end() );
+		shard.index.erase( entry->hash );
+		shard.index[hash] = entry;
+		++shard.statistics.nEvictions;
+	}
+
+	shard.entries.splice( shard.entries.begin(), shard.entries, entry );
+	entry->hash		= hash;
+	entry->key		= key;
+	entry->aOutputs	= aOutputs;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+void PredictionCache::Clear()
+{
+	for ( int s = 0; s < NUM_SHARDS; s++ )
+	{
+		Shard &							shard	= m_aShards[s];
+		std::lock_guard< std::mutex >	lock( shard.mutex );
+
+		shard.entries.clear();
+		shard.index.clear();
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+PredictionCache::Statistics PredictionCache::GetStatistics() const
+{
+	Statistics	total	= {};
+
+	for ( int s = 0; s < NUM_SHARDS; s++ )
+	{
+		Shard const &					shard	= m_aShards[s];
+		std::lock_guard< std::mutex >	lock( shard.mutex );
+
+		total.nHits				+= shard.statistics.nHits;
+		total.nMisses			+= shard.statistics.nMisses;
+		total.nEvictions		+= shard.statistics.nEvictions;
+		total.nInvalidations	+= shard.statistics.nInvalidations;
+	}
+
+	return total;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+void PredictionCache::ResetStatistics()
+{
+	for ( int s = 0; s < NUM_SHARDS; s++ )
+	{
+		Shard &							shard	= m_aShards[s];
+		std::lock_guard< std::mutex >	lock( shard.mutex );
+
+		shard.statistics = Statistics();
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The hash is FNV-1a applied to the 32-bit values of the key rather than to its bytes, which is several times
+//! faster and mixes well enough for a hash table.
+//!
+//! @param	aInputs		The input values.
+//! @param	key			Where to store the key.
+//!
+//! @return		The hash of the key.
+
+uint64_t PredictionCache::MakeKey( Neuron::InputVector const & aInputs, Key & key ) const
+{
+	size_t const	n		= aInputs.size();
+	Fnv1a			hash;
+
+	key.resize( n );
+
+	for ( size_t i = 0; i < n; i++ )
+	{
+		uint32_t	value;
+
+		if ( m_quantum > 0.f )
+		{
+			float	q	= std::nearbyint( aInputs[i] / m_quantum );
+
+			if ( !( q > MIN_QUANTIZED ) )
+			{
+				q = MIN_QUANTIZED;		// This includes NaN
+			}
+			else if ( q > MAX_QUANTIZED )
+			{
+				q = MAX_QUANTIZED;
+			}
+
+			value = (uint32_t)(int32_t)q;
+		}
+		else
+		{
+			std::memcpy( &value, &aInputs[i], sizeof( value ) );
+		}
+
+		key[i] = value;
+		hash.AddWord( value );
+	}
+
+	return hash.GetValue() ^ ( hash.GetValue() >> 32 );
+}
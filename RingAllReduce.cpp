@@ -0,0 +1,747 @@
+/** @file *//********************************************************************************************************
+
+                                                  RingAllReduce.cpp
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/RingAllReduce.cpp#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#include "RingAllReduce.h"
+
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+#if !defined( _WIN32 )
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#if !defined( _WIN32 )
+
+//! The prefix of the address of a Unix domain socket.
+static char const	UNIX_PREFIX[]	= "unix:";
+
+//! How long to wait before trying again to connect to a rank that is not listening yet, in milliseconds.
+static int const	RETRY_INTERVAL	= 10;
+
+typedef std::chrono::steady_clock	Clock;
+
+#if defined( MSG_NOSIGNAL )
+static int const	SEND_FLAGS	= MSG_NOSIGNAL;		// A closed connection is reported as an error, not a signal
+#else
+static int const	SEND_FLAGS	= 0;
+#endif
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	deadline	The deadline.
+//!
+//! @return		The number of milliseconds until the deadline (at least 0).
+
+static int GetRemainingTime( Clock::time_point deadline )
+{
+	long long const	remaining	=
+		std::chrono::duration_cast< std::chrono::milliseconds >( deadline - Clock::now() ).count();
+
+	return ( remaining > 0 ) ? (int)remaining : 0;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	address		The address: <tt>host:port</tt> or <tt>unix:path</tt>.
+//! @param	storage		Where to store the socket address.
+//! @param	length		Where to store the length of the socket address.
+//!
+//! @return		True if the address was resolved.
+
+static bool ResolveAddress( std::string const & address, sockaddr_storage & storage, socklen_t & length )
+{
+	memset( &storage, 0, sizeof( storage ) );
+
+	if ( address.compare( 0, sizeof( UNIX_PREFIX ) - 1, UNIX_PREFIX ) == 0 )
+	{
+		std::string const	path	= address.substr( sizeof( UNIX_PREFIX ) - 1 );
+		sockaddr_un &		local	= reinterpret_cast< sockaddr_un & >( storage );
+
+		if ( path.empty() || path.size() >= sizeof( local.sun_path ) )
+		{
+			return false;
+		}
+
+		local.sun_family = AF_UNIX;
+		memcpy( local.sun_path, path.c_str(), path.size() + 1 );
+		length = (socklen_t)sizeof( local );
+		return true;
+	}
+
+	size_t const	colon	= address.rfind( ':' );
+
+	if ( colon == std::string::npos )
+	{
+		return false;
+	}
+
+	std::string const	host	= address.substr( 0, colon );
+	std::string const	port	= address.substr( colon + 1 );
+	addrinfo			hints;
+	addrinfo *			pResult	= 0;
+
+	memset( &hints, 0, sizeof( hints ) );
+	hints.ai_family		= AF_UNSPEC;
+	hints.ai_socktype	= SOCK_STREAM;
+
+	if ( getaddrinfo( host.c_str(), port.c_str(), &hints, &pResult ) != 0 || pResult == 0 )
+	{
+		return false;
+	}
+
+	memcpy( &storage, pResult->ai_addr, pResult->ai_addrlen );
+	length = (socklen_t)pResult->ai_addrlen;
+	freeaddrinfo( pResult );
+
+	return true;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Small messages are sent immediately, and the socket does not block.
+//!
+//! @param	s	A connected socket.
+
+static void ConfigureSocket( int s )
+{
+	int	on	= 1;
+	setsockopt( s, IPPROTO_TCP, TCP_NODELAY, &on, sizeof( on ) );		// Fails harmlessly on a Unix domain socket
+
+#if defined( SO_NOSIGPIPE )
+	setsockopt( s, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof( on ) );
+#endif
+
+	fcntl( s, F_SETFL, fcntl( s, F_GETFL ) | O_NONBLOCK );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	address		The address to listen on.
+//!
+//! @return		The listening socket, or -1 if it could not be opened.
+
+static int OpenListener( std::string const & address )
+{
+	sockaddr_storage	storage;
+	socklen_t			length;
+
+	if ( !ResolveAddress( address, storage, length ) )
+	{
+		return -1;
+	}
+
+	int const	s	= socket( storage.ss_family, SOCK_STREAM, 0 );
+
+	if ( s < 0 )
+	{
+		return -1;
+	}
+
+	if ( storage.ss_family == AF_UNIX )
+	{
+		unlink( reinterpret_cast< sockaddr_un & >( storage ).sun_path );	// Left over from a previous run
+	}
+	else
+	{
+		int	on	= 1;
+		setsockopt( s, SOL_SOCKET, SO_REUSEADDR, &on, sizeof( on ) );
+	}
+
+	if ( bind( s, reinterpret_cast< sockaddr * >( &storage ), length ) != 0 || listen( s, 1 ) != 0 )
+	{
+		close( s );
+		return -1;
+	}
+
+	return s;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The other rank may not be listening yet, so the connection is retried until the deadline.
+//!
+//! @param	address		The address to connect to.
+//! @param	deadline	The time at which to give up.
+//!
+//! @return		The connected socket, or -1 if it could not be connected.
+
+static int ConnectTo( std::string const & address, Clock::time_point deadline )
+{
+	sockaddr_storage	storage;
+	socklen_t			length;
+
+	if ( !ResolveAddress( address, storage, length ) )
+	{
+		return -1;
+	}
+
+	for ( ;; )
+	{
+		int const	s	= socket( storage.ss_family, SOCK_STREAM, 0 );
+
+		if ( s < 0 )
+		{
+			return -1;
+		}
+
+		if ( connect( s, reinterpret_cast< sockaddr * >( &storage ), length ) == 0 )
+		{
+			return s;
+		}
+
+		close( s );
+
+		if ( Clock::now() >= deadline )
+		{
+			return -1;
+		}
+
+		std::this_thread::sleep_for( std::chrono::milliseconds( RETRY_INTERVAL ) );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	listener	The listening socket.
+//! @param	deadline	The time at which to give up.
+//!
+//! @return		The accepted socket, or -1 if no connection was accepted.
+
+static int AcceptFrom( int listener, Clock::time_point deadline )
+{
+	pollfd	p;
+	p.fd		= listener;
+	p.events	= POLLIN;
+
+	if ( poll( &p, 1, GetRemainingTime( deadline ) ) != 1 )
+	{
+		return -1;
+	}
+
+	return accept( listener, 0, 0 );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	s			A connected, non-blocking socket.
+//! @param	pData		The data.
+//! @param	size		The size of the data.
+//! @param	deadline	The time at which to give up.
+//!
+//! @return		True if all the data was sent.
+
+static bool SendAll( int s, void const * pData, size_t size, Clock::time_point deadline )
+{
+	char const *	p	= static_cast< char const * >( pData );
+
+	while ( size > 0 )
+	{
+		ssize_t const	n	= send( s, p, size, SEND_FLAGS );
+
+		if ( n > 0 )
+		{
+			p		+= n;
+			size	-= n;
+		}
+		else
+		{
+			pollfd	wait;
+			wait.fd		= s;
+			wait.events	= POLLOUT;
+
+			if ( n == 0 || ( errno != EAGAIN && errno != EWOULDBLOCK ) ||
+				 poll( &wait, 1, GetRemainingTime( deadline ) ) != 1 )
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	s			A connected, non-blocking socket.
+//! @param	pData		Where to store the data.
+//! @param	size		The size of the data.
+//! @param	deadline	The time at which to give up.
+//!
+//! @return		True if all the data was received.
+
+static bool ReceiveAll( int s, void * pData, size_t size, Clock::time_point deadline )
+{
+	char *	p	= static_cast< char * >( pData );
+
+	while ( size > 0 )
+	{
+		ssize_t const	n	= recv( s, p, size, 0 );
+
+		if ( n > 0 )
+		{
+			p		+= n;
+			size	-= n;
+		}
+		else
+		{
+			pollfd	wait;
+			wait.fd		= s;
+			wait.events	= POLLIN;
+
+			if ( n == 0 || ( errno != EAGAIN && errno != EWOULDBLOCK ) ||
+				 poll( &wait, 1, GetRemainingTime( deadline ) ) != 1 )
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif // !defined( _WIN32 )
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	rank		The index of this process in the ring.
+//! @param	aAddresses	The address of each rank. Every rank must be given the same addresses.
+
+RingAllReduce::RingAllReduce( int rank, std::vector< std::string > const & aAddresses )
+	: m_rank( rank ),
+	m_aAddresses( aAddresses ),
+	m_listener( -1 ),
+	m_next( -1 ),
+	m_previous( -1 ),
+	m_bConnected( false ),
+	m_bFailed( false ),
+	m_bQuit( false )
+{
+	assert( rank >= 0 && rank < (int)aAddresses.size() );
+
+	m_thread = std::thread( &RingAllReduce::Run, this );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Sums that have been requested are done before the object is destroyed.
+
+RingAllReduce::~RingAllReduce()
+{
+	{
+		std::lock_guard< std::mutex >	lock( m_mutex );
+		m_bQuit = true;
+	}
+	m_changed.notify_all();
+
+	m_thread.join();
+
+	Close();
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Every rank must call this function at about the same time.
+//!
+//! @param	timeout		The time allowed for the other ranks to start and connect, in milliseconds.
+//!
+//! @return		True if the ring was connected.
+
+bool RingAllReduce::Connect( int timeout /* = DEFAULT_TIMEOUT*/ )
+{
+	int const	size	= GetSize();
+
+	if ( size == 1 )
+	{
+		m_bConnected = true;
+		return true;
+	}
+
+#if defined( _WIN32 )
+
+	return false;
+
+#else
+
+	Clock::time_point const	deadline	= Clock::now() + std::chrono::milliseconds( timeout );
+	int const				nextRank		= ( m_rank + 1 ) % size;
+	int const				previousRank	= ( m_rank + size - 1 ) % size;
+
+	// Listen before connecting, so that the connection from the previous rank waits in the backlog until it is
+	// accepted. Each rank then introduces itself to the next, so that a stray connection is not mistaken for it.
+
+	m_listener = OpenListener( m_aAddresses[m_rank] );
+	if ( m_listener < 0 )
+	{
+		return false;
+	}
+
+	m_next = ConnectTo( m_aAddresses[nextRank], deadline );
+	if ( m_next < 0 )
+	{
+		Close();
+		return false;
+	}
+	ConfigureSocket( m_next );
+
+	int32_t const	rank	= m_rank;
+
+	if ( !SendAll( m_next, &rank, sizeof( rank ), deadline ) )
+	{
+		Close();
+		return false;
+	}
+
+	m_previous = AcceptFrom( m_listener, deadline );
+	if ( m_previous < 0 )
+	{
+		Close();
+		return false;
+	}
+	ConfigureSocket( m_previous );
+
+	int32_t	introduced	= -1;
+
+	if ( !ReceiveAll( m_previous, &introduced, sizeof( introduced ), deadline ) || introduced != previousRank )
+	{
+		Close();
+		return false;
+	}
+
+	close( m_listener );
+	m_listener = -1;
+
+	if ( m_aAddresses[m_rank].compare( 0, sizeof( UNIX_PREFIX ) - 1, UNIX_PREFIX ) == 0 )
+	{
+		unlink( m_aAddresses[m_rank].c_str() + sizeof( UNIX_PREFIX ) - 1 );
+	}
+
+	m_bConnected = true;
+	return true;
+
+#endif
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	paValues	The array. Its values are replaced by their sums.
+//! @param	n			The number of values in the array. It must be the same on every rank.
+//!
+//! @return		True if the sum succeeded. If it fails, the ring can no longer be used.
+
+bool RingAllReduce::Sum( float * paValues, int n )
+{
+	return SumAsync( paValues, n ).get();
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The sum is done by a background thread after the sums requested before it.
+//!
+//! @param	paValues	The array. It must not be used until the sum is done.
+//! @param	n			The number of values in the array. It must be the same on every rank.
+//!
+//! @return		A future that becomes true when the sum is done, or false if it fails.
+
+std::future< bool > RingAllReduce::SumAsync( float * paValues, int n )
+{
+	std::future< bool >	result;
+
+	{
+		std::lock_guard< std::mutex >	lock( m_mutex );
+
+		m_jobs.push_back( Job() );
+
+		Job &	job	= m_jobs.back();
+		job.paValues	= paValues;
+		job.n			= n;
+		result			= job.result.get_future();
+	}
+
+	m_changed.notify_all();
+
+	return result;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Chunk @a c is the values from <tt>c * n / size</tt> up to <tt>( c + 1 ) * n / size</tt>.
+//!
+//! @param	paValues	The array.
+//! @param	n			The number of values in the array.
+//!
+//! @return		True if the sum succeeded.
+
+bool RingAllReduce::Reduce( float * paValues, int n )
+{
+	int const	size	= GetSize();
+
+	if ( !m_bConnected || m_bFailed )
+	{
+		return false;
+	}
+
+	if ( size == 1 )
+	{
+		return true;
+	}
+
+	std::vector< int >	aStarts( size + 1 );
+
+	for ( int c = 0; c <= size; c++ )
+	{
+		aStarts[c] = (int)( (long long)c * n / size );
+	}
+
+	// Reduce-scatter: after step s, this rank holds the sum over s + 2 ranks of chunk ( rank - s - 1 ).
+
+	for ( int s = 0; s < size - 1; s++ )
+	{
+		int const	sent		= ( m_rank - s + size ) % size;
+		int const	received	= ( m_rank - s - 1 + size ) % size;
+		int const	nSent		= aStarts[sent + 1] - aStarts[sent];
+		int const	nReceived	= aStarts[received + 1] - aStarts[received];
+
+		m_aReceived.resize( nReceived );
+
+		if ( !Exchange( paValues + aStarts[sent], nSent * sizeof( float ),
+						m_aReceived.data(), nReceived * sizeof( float ) ) )
+		{
+			m_bFailed = true;
+			return false;
+		}
+
+		float * const	paChunk	= paValues + aStarts[received];
+
+		for ( int i = 0; i < nReceived; i++ )
+		{
+			paChunk[i] += m_aReceived[i];
+		}
+	}
+
+	// All-gather: this rank starts with the complete sum of chunk ( rank + 1 ) and passes complete chunks along.
+
+	for ( int s = 0; s < size - 1; s++ )
+	{
+		int const	sent		= ( m_rank + 1 - s + size ) % size;
+		int const	received	= ( m_rank - s + size ) % size;
+
+		int const	nSent		= aStarts[sent + 1] - aStarts[sent];
+		int const	nReceived	= aStarts[received + 1] - aStarts[received];
+
+		if ( !Exchange( paValues + aStarts[sent], nSent * sizeof( float ),
+						paValues + aStarts[received], nReceived * sizeof( float ) ) )
+		{
+			m_bFailed = true;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Sending and receiving at the same time prevents a deadlock when every rank sends more than the sockets can buffer.
+//!
+//! @param	pSend			The data to send to the next rank.
+//! @param	sendSize		The size of the data to send.
+//! @param	pReceive		Where to store the data received from the previous rank.
+//! @param	receiveSize		The size of the data to receive.
+//!
+//! @return		True if the data was sent and received.
+
+bool RingAllReduce::Exchange( void const * pSend, size_t sendSize, void * pReceive, size_t receiveSize )
+{
+#if defined( _WIN32 )
+
+	return false;
+
+#else
+
+	char const *	pOut	= static_cast< char const * >( pSend );
+	char *			pIn		= static_cast< char * >( pReceive );
+
+	while ( sendSize > 0 || receiveSize > 0 )
+	{
+		pollfd	aWaits[2];
+		int		nWaits	= 0;
+
+		if ( sendSize > 0 )
+		{
+			aWaits[nWaits].fd		= m_next;
+			aWaits[nWaits].events	= POLLOUT;
+			++nWaits;
+		}
+
+		if ( receiveSize > 0 )
+		{
+			aWaits[nWaits].fd		= m_previous;
+			aWaits[nWaits].events	= POLLIN;
+			++nWaits;
+		}
+
+		if ( poll( aWaits, nWaits, DEFAULT_TIMEOUT ) <= 0 )
+		{
+			return false;		// No progress for a long time, so a rank has probably stopped
+		}
+
+		for ( int w = 0; w < nWaits; w++ )
+		{
+			if ( ( aWaits[w].revents & ( POLLERR | POLLNVAL ) ) != 0 )
+			{
+				return false;
+			}
+		}
+
+		if ( sendSize > 0 )
+		{
+			ssize_t const	n	= send( m_next, pOut, sendSize, SEND_FLAGS );
+
+			if ( n > 0 )
+			{
+				pOut		+= n;
+				sendSize	-= n;
+			}
+			else if ( n < 0 && errno != EAGAIN && errno != EWOULDBLOCK )
+			{
+				return false;
+			}
+		}
+
+		if ( receiveSize > 0 )
+		{
+			ssize_t const	n	= recv( m_previous, pIn, receiveSize, 0 );
+
+			if ( n > 0 )
+			{
+				pIn			+= n;
+				receiveSize	-= n;
+			}
+			else if ( n == 0 || ( errno != EAGAIN && errno != EWOULDBLOCK ) )
+			{
+				return false;		// The previous rank closed the connection
+			}
+		}
+	}
+
+	return true;
+
+#endif
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+void RingAllReduce::Close()
+{
+#if !defined( _WIN32 )
+	int * const	apSockets[]	= { &m_listener, &m_next, &m_previous };
+
+	for ( int i = 0; i < 3; i++ )
+	{
+		if ( *apSockets[i] >= 0 )
+		{
+			close( *apSockets[i] );
+			*apSockets[i] = -1;
+		}
+	}
+#endif
+
+	m_bConnected = false;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+void RingAllReduce::Run()
+{
+	std::unique_lock< std::mutex >	lock( m_mutex );
+
+	for ( ;; )
+	{
+		m_changed.wait( lock, [this] { return m_bQuit || !m_jobs.empty(); } );
+
+		if ( m_jobs.empty() )
+		{
+			return;		// Quitting and there is nothing left to do
+		}
+
+		Job	job	= std::move( m_jobs.front() );
+		m_jobs.pop_front();
+
+		lock.unlock();
+
+		job.result.set_value( Reduce( job.paValues, job.n ) );
+
+		lock.lock();
+	}
+}
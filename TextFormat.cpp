@@ -0,0 +1,238 @@
+/** @file *//********************************************************************************************************
+
+                                                   TextFormat.cpp
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/TextFormat.cpp#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#include "TextFormat.h"
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <cstdio>
+#include <istream>
+
+//! The size of a text below which ParseFloats() does not split it across threads.
+static size_t const	PARALLEL_THRESHOLD	= 1024 * 1024;
+
+//! The number of pieces a text is split into for each thread, so that the threads finish at about the same time.
+static int const	PIECES_PER_THREAD	= 4;
+
+//! The maximum length of the text of a float read by ReadFloat().
+static int const	MAX_TOKEN_SIZE		= 64;
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	c	A character.
+//!
+//! @return		True if the character is whitespace in the "C" locale.
+
+static bool IsSpace( int c )
+{
+	return c == ' ' || ( c >= '\t' && c <= '\r' );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	x		The float.
+//! @param	pText	Where to write the text. There must be room for MAX_FLOAT_TEXT_SIZE characters. The text is not
+//!					terminated.
+//!
+//! @return		The end of the text.
+
+char * FormatFloat( float x, char * pText )
+{
+	std::to_chars_result const	result	= std::to_chars( pText, pText + MAX_FLOAT_TEXT_SIZE, x );
+
+	assert( result.ec == std::errc() );
+
+	return result.ptr;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Leading whitespace is skipped, and the float ends at the next whitespace or at the end of the stream. The
+//! characters are taken directly from the stream's buffer.
+//!
+//! @param	in		The stream.
+//! @param	x		Where to store the float.
+//!
+//! @return		The stream. If the text is not a float (or the float is out of range), the stream's failbit is set.
+
+std::istream & ReadFloat( std::istream & in, float & x )
+{
+	std::streambuf * const	pBuffer	= in.rdbuf();
+	char					aToken[MAX_TOKEN_SIZE];
+	int						size	= 0;
+	int						c		= ( in.good() && pBuffer != 0 ) ? pBuffer->sgetc() : EOF;
+
+	while ( c != EOF && IsSpace( c ) )
+	{
+		c = pBuffer->snextc();
+	}
+
+	while ( c != EOF && !IsSpace( c ) && size < MAX_TOKEN_SIZE )
+	{
+		aToken[size++] = (char)c;
+		c = pBuffer->snextc();
+	}
+
+	std::ios_base::iostate	state	= std::ios_base::goodbit;
+
+	if ( c == EOF )
+	{
+		state |= std::ios_base::eofbit;
+	}
+
+	std::from_chars_result const	result	= std::from_chars( aToken, aToken + size, x );
+
+	if ( size == 0 || size == MAX_TOKEN_SIZE || result.ec != std::errc() || result.ptr != aToken + size )
+	{
+		state |= std::ios_base::failbit;
+	}
+
+	if ( state != std::ios_base::goodbit )
+	{
+		in.setstate( state );
+	}
+
+	return in;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	pBegin	The start of the text.
+//! @param	pEnd	The end of the text.
+//! @param	aValues	Where to store the floats. They are appended to the vector.
+//!
+//! @return		True if the text contains only floats separated by whitespace.
+
+bool ParseFloats( char const * pBegin, char const * pEnd, std::vector< float > & aValues )
+{
+	char const *	p	= pBegin;
+
+	for ( ;; )
+	{
+		while ( p < pEnd && IsSpace( *p ) )
+		{
+			++p;
+		}
+
+		if ( p == pEnd )
+		{
+			return true;
+		}
+
+		float							x;
+		std::from_chars_result const	result	= std::from_chars( p, pEnd, x );
+
+		if ( result.ec != std::errc() || ( result.ptr < pEnd && !IsSpace( *result.ptr ) ) )
+		{
+			return false;
+		}
+
+		aValues.push_back( x );
+		p = result.ptr;
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The text is split at whitespace into pieces that are parsed concurrently by the pool's threads, and the results
+//! are joined in order. A small text is parsed by the calling thread.
+//!
+//! @param	text	The text.
+//! @param	aValues	Where to store the floats. The vector is replaced.
+//! @param	pPool	The thread pool used to parse the text (or 0 if none).
+//!
+//! @return		True if the text contains only floats separated by whitespace.
+
+bool ParseFloats( std::string const & text, std::vector< float > & aValues, ThreadPool * pPool )
+{
+	char const * const	pText	= text.data();
+	size_t const		size	= text.size();
+
+	aValues.clear();
+
+	if ( pPool == 0 || size < PARALLEL_THRESHOLD )
+	{
+		aValues.reserve( size / 8 );
+		return ParseFloats( pText, pText + size, aValues );
+	}
+
+	// Each piece starts at whitespace (or at the start of the text), so no float is split between two pieces.
+
+	int const				nPieces	= pPool->GetThreadCount() * PIECES_PER_THREAD;
+	std::vector< size_t >	aStarts( nPieces + 1, size );
+
+	aStarts[0] = 0;
+
+	for ( int i = 1; i < nPieces; i++ )
+	{
+		size_t	start	= std::max( size * i / nPieces, aStarts[i - 1] );
+
+		while ( start < size && !IsSpace( pText[start] ) )
+		{
+			++start;
+		}
+
+		aStarts[i] = start;
+	}
+
+	std::vector< std::vector< float > >	aPieces( nPieces );
+	std::vector< char >					aParsed( nPieces, false );
+
+	pPool->ParallelFor( nPieces, 1, [&] ( int first, int last )
+	{
+		for ( int i = first; i < last; i++ )
+		{
+			aPieces[i].reserve( ( aStarts[i + 1] - aStarts[i] ) / 8 );
+			aParsed[i] = ParseFloats( pText + aStarts[i], pText + aStarts[i + 1], aPieces[i] );
+		}
+	} );
+
+	if ( std::find( aParsed.begin(), aParsed.end(), false ) != aParsed.end() )
+	{
+		return false;
+	}
+
+	size_t	count	= 0;
+
+	for ( int i = 0; i < nPieces; i++ )
+	{
+		count += aPieces[i].size();
+	}
+
+	aValues.reserve( count );
+
+	for ( int i = 0; i < nPieces; i++ )
+	{
+		aValues.insert( aValues.end(), aPieces[i].begin(), aPieces[i].end() );
+	}
+
+	return true;
+}
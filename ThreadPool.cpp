@@ -0,0 +1,233 @@
+/** @file *//********************************************************************************************************
+
+                                                   ThreadPool.cpp
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/ThreadPool.cpp#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cassert>
+
+//! The pool whose function the current thread is running (or 0 if none). A call to ParallelFor() from inside that
+//! function would wait forever for the call that is running it, so it is run serially instead.
+static thread_local ThreadPool const *	t_pRunningPool	= 0;
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	nThreads	The number of threads that process tiles, including the thread calling ParallelFor(). If
+//!						the value is 0, the number of hardware threads is used.
+
+ThreadPool::ThreadPool( int nThreads /* = 0*/ )
+	: m_pFunction( 0 ),
+	m_nRemaining( 0 ),
+	m_generation( 0 ),
+	m_bQuit( false )
+{
+	if ( nThreads <= 0 )
+	{
+		nThreads = std::max( (int)std::thread::hardware_concurrency(), 1 );
+	}
+
+	for ( int i = 0; i < nThreads; i++ )
+	{
+		m_apQueues.push_back( std::unique_ptr< Queue >( new Queue ) );
+		m_apQueues.back()->head = 0;
+		m_apQueues.back()->tail = 0;
+	}
+
+	// The calling thread uses the last queue, so only nThreads-1 workers are needed.
+
+	for ( int i = 0; i < nThreads - 1; i++ )
+	{
+		m_aThreads.push_back( std::thread( &ThreadPool::Run, this, i ) );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard< std::mutex >	lock( m_mutex );
+		m_bQuit = true;
+	}
+	m_start.notify_all();
+
+	for ( size_t i = 0; i < m_aThreads.size(); i++ )
+	{
+		m_aThreads[i].join();
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The range [0, @a n) is split into tiles of @a tileSize indexes (the last tile may be smaller) and @a f is called
+//! once for each tile. The calls are made concurrently on the pool's threads and the calling thread. If there is
+//! only one tile or only one thread, @a f is simply called with the whole range.
+//!
+//! A call made from inside a function that the pool is running (a nested call) also calls @a f with the whole range
+//! on the calling thread, since the pool's threads are busy with the outer call. Nested calls that alternate between
+//! pools (pool A runs a function that calls pool B, which runs a function that calls pool A) are not supported.
+//!
+//! @param	n			The number of indexes.
+//! @param	tileSize	The number of indexes in each tile.
+//! @param	f			The function to call for each tile.
+
+void ThreadPool::ParallelFor( int n, int tileSize, RangeFunction const & f )
+{
+	assert( tileSize > 0 );
+
+	if ( n <= 0 )
+	{
+		return;
+	}
+
+	if ( m_aThreads.empty() || n <= tileSize || t_pRunningPool == this )
+	{
+		f( 0, n );
+		return;
+	}
+
+	std::lock_guard< std::mutex >	callLock( m_callMutex );
+
+	int const	nTiles	= ( n + tileSize - 1 ) / tileSize;
+	int const	nQueues	= (int)m_apQueues.size();
+
+	m_pFunction = &f;
+	m_nRemaining = nTiles;
+
+	// Deal the tiles out in contiguous runs so that neighboring tiles are usually processed by the same thread.
+
+	for ( int q = 0; q < nQueues; q++ )
+	{
+		Queue &		queue	= *m_apQueues[q];
+		int const	first	= nTiles * q / nQueues;
+		int const	last	= nTiles * ( q + 1 ) / nQueues;
+
+		std::lock_guard< std::mutex >	lock( queue.mutex );
+
+		queue.aTiles.resize( last - first );
+		for ( int t = first; t < last; t++ )
+		{
+			Tile &	tile	= queue.aTiles[t - first];
+
+			tile.first	= t * tileSize;
+			tile.last	= std::min( tile.first + tileSize, n );
+		}
+		queue.head	= 0;
+		queue.tail	= last - first;
+	}
+
+	{
+		std::lock_guard< std::mutex >	lock( m_mutex );
+		++m_generation;
+	}
+	m_start.notify_all();
+
+	// Help out until there is nothing left to take, and then wait for the workers to finish.
+
+	while ( ProcessTile( nQueues - 1 ) )
+	{
+	}
+
+	std::unique_lock< std::mutex >	lock( m_mutex );
+	m_finished.wait( lock, [this] { return m_nRemaining == 0; } );
+
+	m_pFunction = 0;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	index	Index of the worker's queue.
+
+void ThreadPool::Run( int index )
+{
+	unsigned	generation	= 0;
+
+	for ( ;; )
+	{
+		{
+			std::unique_lock< std::mutex >	lock( m_mutex );
+			m_start.wait( lock, [this, generation] { return m_bQuit || m_generation != generation; } );
+			if ( m_bQuit )
+			{
+				return;
+			}
+			generation = m_generation;
+		}
+
+		while ( ProcessTile( index ) )
+		{
+		}
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The tile is taken from the back of the thread's own queue. If that queue is empty, a tile is stolen from the
+//! front of another queue.
+//!
+//! @param	index	Index of the calling thread's queue.
+//!
+//! @return		false, if there were no tiles left to process.
+
+bool ThreadPool::ProcessTile( int index )
+{
+	int const	nQueues	= (int)m_apQueues.size();
+	Tile		tile;
+	bool		found	= false;
+
+	for ( int i = 0; i < nQueues && !found; i++ )
+	{
+		Queue &							queue	= *m_apQueues[( index + i ) % nQueues];
+		std::lock_guard< std::mutex >	lock( queue.mutex );
+
+		if ( queue.head < queue.tail )
+		{
+			tile = ( i == 0 ) ? queue.aTiles[--queue.tail] : queue.aTiles[queue.head++];
+			found = true;
+		}
+	}
+
+	if ( !found )
+	{
+		return false;
+	}
+
+	ThreadPool const * const	pOuterPool	= t_pRunningPool;
+
+	t_pRunningPool = this;
+	( *m_pFunction )( tile.first, tile.last );
+	t_pRunningPool = pOuterPool;
+
+	if ( --m_nRemaining == 0 )
+	{
+		std::lock_guard< std::mutex >	lock( m_mutex );
+		m_finished.notify_one();
+	}
+
+	return true;
+}
@@ -0,0 +1,275 @@
+/** @file *//********************************************************************************************************
+
+                                                    Validator.cpp
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/Validator.cpp#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#include "Validator.h"
+
+#include "MultilayerFeedForward.h"
+
+#include <algorithm>
+#include <cassert>
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	aInputs		The inputs of the validation set.
+//! @param	aTargets	The expected outputs of the validation set. aTargets[i] is the expected output for aInputs[i].
+//! @param	criterion	How a net is scored.
+//! @param	interval	The number of training steps between snapshots.
+//! @param	patience	The number of validations without improvement after which training should stop, or 0 if
+//!						training should not be stopped early.
+//! @param	pPool		The thread pool used to evaluate the validation set in parallel (or 0 if none). The pool
+//!						should not be used for the training, since calls to ThreadPool::ParallelFor() are serialized.
+
+Validator::Validator( NeuralNet::InputBatch const & aInputs,
+					  NeuralNet::OutputBatch const & aTargets,
+					  Criterion criterion /* = MEAN_SQUARED_ERROR*/,
+					  int interval /* = 1*/,
+					  int patience /* = DEFAULT_PATIENCE*/,
+					  ThreadPool * pPool /* = 0*/ )
+	: m_aInputs( aInputs ),
+	m_aTargets( aTargets ),
+	m_criterion( criterion ),
+	m_interval( interval ),
+	m_patience( patience ),
+	m_evaluator( pPool ),
+	m_pendingStep( 0 ),
+	m_bValidating( false ),
+	m_bQuit( false ),
+	m_nSinceBest( 0 ),
+	m_nSkipped( 0 )
+{
+	assert( aInputs.size() == aTargets.size() );
+	assert( interval > 0 );
+
+	m_thread = std::thread( &Validator::Run, this );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! A snapshot waiting to be validated is validated before the validator is destroyed.
+
+Validator::~Validator()
+{
+	{
+		std::lock_guard< std::mutex >	lock( m_mutex );
+		m_bQuit = true;
+	}
+	m_changed.notify_all();
+
+	m_thread.join();
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+void Validator::Wait()
+{
+	std::unique_lock< std::mutex >	lock( m_mutex );
+
+	m_changed.wait( lock, [this] { return m_pPending == 0 && !m_bValidating; } );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+bool Validator::ShouldStop() const
+{
+	std::lock_guard< std::mutex >	lock( m_mutex );
+
+	return m_patience > 0 && m_nSinceBest >= m_patience;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+Validator::Result Validator::GetBestResult() const
+{
+	std::lock_guard< std::mutex >	lock( m_mutex );
+
+	return m_best;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The snapshot does not share the settings of the net that are not needed to evaluate it (such as a thread pool).
+
+std::shared_ptr< NeuralNet const > Validator::GetBest() const
+{
+	std::lock_guard< std::mutex >	lock( m_mutex );
+
+	return m_pBest;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+Validator::Result Validator::GetLatestResult() const
+{
+	std::lock_guard< std::mutex >	lock( m_mutex );
+
+	return m_latest;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+int Validator::GetSkippedCount() const
+{
+	std::lock_guard< std::mutex >	lock( m_mutex );
+
+	return m_nSkipped;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The validation set is measured by an Evaluator, so the blocks of the validation set are evaluated in parallel if
+//! there is a thread pool, and the score does not depend on the number of threads.
+//!
+//! @param	net		The net.
+//!
+//! @return		The score. A lower score is better.
+
+float Validator::Score( NeuralNet const & net ) const
+{
+	Evaluator::Metrics const	metrics	= m_evaluator.Evaluate( net, m_aInputs, m_aTargets );
+
+	if ( m_criterion == CLASSIFICATION_ERROR )
+	{
+		long long const	nErrors	= metrics.nSamples - metrics.nCorrect;
+
+		return ( metrics.nSamples > 0 ) ? (float)( (double)nErrors / (double)metrics.nSamples ) : 0.f;
+	}
+
+	return metrics.GetMeanSquaredError();
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! A snapshot keeps the net's thread pool, but the validator evaluates the blocks of the validation set in parallel
+//! instead of the units of each layer. Evaluating the units in parallel as well would compete with the training for
+//! the net's pool (or run serially anyway, if it is the validator's pool).
+//!
+//! The snapshot keeps the net's kernels. Choosing new ones with SetThreadPool() could make the net's autotuner time
+//! them on the training thread.
+//!
+//! @param	net		The snapshot.
+
+void Validator::Detach( MultilayerFeedForward & net )
+{
+	net.ClearThreadPool();
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	pSnapshot	The snapshot.
+//! @param	step		The training step at which the snapshot was made.
+
+void Validator::Enqueue( Snapshot const & pSnapshot, long long step )
+{
+	Snapshot	pReplaced	= pSnapshot;
+
+	{
+		std::lock_guard< std::mutex >	lock( m_mutex );
+
+		std::swap( m_pPending, pReplaced );	// The replaced snapshot (if any) is destroyed after the lock is released
+		m_pendingStep = step;
+
+		if ( pReplaced != 0 )
+		{
+			++m_nSkipped;
+		}
+	}
+
+	m_changed.notify_all();
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+void Validator::Run()
+{
+	std::unique_lock< std::mutex >	lock( m_mutex );
+
+	for ( ;; )
+	{
+		m_changed.wait( lock, [this] { return m_bQuit || m_pPending != 0; } );
+
+		if ( m_pPending == 0 )
+		{
+			return;		// Quitting and there is nothing left to validate
+		}
+
+		Snapshot		pSnapshot;
+		long long const	step		= m_pendingStep;
+
+		std::swap( pSnapshot, m_pPending );
+		m_bValidating = true;
+
+		lock.unlock();
+
+		float const	score	= Score( *pSnapshot );
+
+		lock.lock();
+
+		m_latest = Result( step, score );
+
+		if ( score < m_best.score )
+		{
+			m_best			= m_latest;
+			m_nSinceBest	= 0;
+			std::swap( m_pBest, pSnapshot );
+		}
+		else
+		{
+			++m_nSinceBest;
+		}
+
+		m_bValidating = false;
+		m_changed.notify_all();
+
+		// The snapshot that is no longer needed (if any) is released without holding the lock.
+
+		lock.unlock();
+		pSnapshot.reset();
+		lock.lock();
+	}
+}
@@ -0,0 +1,124 @@
+/** @file *//********************************************************************************************************
+
+                                                  ActivationCache.h
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/ActivationCache.h#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#pragma once
+
+#include "NeuralNet.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class MultilayerFeedForward;
+class ThreadPool;
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Holds the outputs of the hidden units of a net for every sample of a data set.
+//
+//! When the hidden layer of a net is frozen (see MultilayerFeedForward::SetFrozen()), the outputs of the hidden units
+//! for a sample never change, so they can be computed once and reused in every epoch. Training the output layer from
+//! the cached outputs skips the hidden layer entirely, which is usually most of the cost of an epoch.
+//!
+//! The outputs are kept in memory, or in a file that is mapped into memory so that a data set larger than the memory
+//! can be cached and the cache can be reused by later runs. A file records a fingerprint of the hidden layer and the
+//! data set, and it is rejected if either has changed since the file was built.
+//!
+//! For example:
+//!
+//! @code
+//!		net.SetFrozen( MultilayerFeedForward::HIDDEN_LAYER, true );
+//!
+//!		ActivationCache	cache;
+//!		if ( !cache.Open( net, aInputs, path ) && !cache.Build( net, aInputs, path, &pool ) )
+//!		{
+//!			... fail ...
+//!		}
+//!
+//!		for ( ... each epoch ... )
+//!		{
+//!			for ( int i = 0; i < cache.GetCount(); i++ )
+//!			{
+//!				NeuralNet::OutputVector const &	aOutputs	= net.EvaluateFromHidden( cache.Get( i ) );
+//!				... compute the errors ...
+//!				net.TrainOutputs( aErrors, rate );
+//!			}
+//!		}
+//! @endcode
+//!
+//! @note	A file is only readable on a machine with the same representation of @c float.
+
+class ActivationCache
+{
+public:
+
+	//! Constructor
+	ActivationCache();
+
+	//! Destructor
+	~ActivationCache();
+
+	//! Computes the outputs of the hidden units for a data set.
+	bool Build( MultilayerFeedForward const & net,
+				NeuralNet::InputBatch const & aInputs,
+				std::string const & path = std::string(),
+				ThreadPool * pPool = 0 );
+
+	//! Opens a file built previously for the same hidden layer and data set.
+	bool Open( MultilayerFeedForward const & net, NeuralNet::InputBatch const & aInputs, std::string const & path );
+
+	//! Releases the cached outputs.
+	void Close();
+
+	//! Returns the number of samples.
+	int GetCount() const								{ return m_nSamples; }
+
+	//! Returns the number of hidden outputs for each sample.
+	int GetWidth() const								{ return m_width; }
+
+	//! Returns the hidden outputs for a sample.
+	float const * Get( int i ) const					{ return m_paValues + (size_t)i * m_width; }
+
+private:
+
+	// Prevent copying
+	ActivationCache( ActivationCache const & );
+	ActivationCache & operator=( ActivationCache const & );
+
+	//! Returns a hash of the sizes and weights of the hidden layer and of the data set.
+	static uint64_t Fingerprint( MultilayerFeedForward const & net, NeuralNet::InputBatch const & aInputs );
+
+	//! Computes the hidden outputs for a range of samples.
+	static void Compute( MultilayerFeedForward const & net,
+						 NeuralNet::InputBatch const & aInputs,
+						 int first,
+						 int last,
+						 float * paValues,
+						 ThreadPool * pPool );
+
+	//! Writes the hidden outputs for a data set to a file.
+	static bool Write( MultilayerFeedForward const & net,
+					   NeuralNet::InputBatch const & aInputs,
+					   std::string const & path,
+					   ThreadPool * pPool );
+
+	std::vector< float >	m_aValues;		//!< The outputs, if they are held in memory.
+	void *					m_pMapping;		//!< The mapped file (or 0 if none).
+	size_t					m_mappingSize;	//!< The size of the mapped file.
+	float const *			m_paValues;		//!< The outputs of the first sample.
+	int						m_nSamples;		//!< The number of samples.
+	int						m_width;		//!< The number of outputs for each sample.
+};
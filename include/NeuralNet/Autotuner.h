@@ -0,0 +1,96 @@
+/** @file *//********************************************************************************************************
+
+                                                     Autotuner.h
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/Autotuner.h#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#pragma once
+
+#include "Kernels.h"
+
+#include <map>
+#include <mutex>
+#include <string>
+
+class ThreadPool;
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Chooses the fastest kernel configuration for each layer shape on the current processor.
+//
+//! The first time a shape is requested, every candidate configuration is timed on a layer of that shape and the
+//! fastest is remembered. If a thread pool is given, the tile size used to split the layer across the pool's threads
+//! is tuned as well. The results can be stored in a cache file so that later runs on the same machine do not need to
+//! tune again. The cache is specific to the machine it was made on and should not be shared between machines.
+//!
+//! When tuning is disabled, shapes that are not in the cache get a fixed configuration that depends only on the
+//! shape, so the results are reproducible.
+//!
+//! Get() may be called by several threads concurrently.
+
+class Autotuner
+{
+public:
+
+	//! Constructor
+	explicit Autotuner( std::string const & cachePath = std::string() );
+
+	//! Destructor
+	~Autotuner();
+
+	//! Enables or disables tuning.
+	void SetTuning( bool enabled );
+
+	//! Returns true if tuning is enabled.
+	bool IsTuning() const;
+
+	//! Returns the configuration to use for a layer with the given shape.
+	KernelConfig Get( int nUnits, int nInputs, ThreadPool * pPool = 0 );
+
+	//! Writes the tuned configurations to the cache file.
+	bool Save() const;
+
+	//! Returns the configuration used for a shape that has not been tuned.
+	static KernelConfig GetDefault( int nUnits, int nInputs );
+
+private:
+
+	// Prevent copying
+	Autotuner( Autotuner const & );
+	Autotuner & operator=( Autotuner const & );
+
+	//! The shape of a layer and the number of threads it is split across.
+	struct Shape
+	{
+		int	nUnits;		//!< The number of units.
+		int	nInputs;	//!< The number of inputs to each unit.
+		int	nThreads;	//!< The number of threads.
+
+		//! Orders shapes (for use as a key).
+		bool operator<( Shape const & b ) const;
+	};
+
+	typedef std::map< Shape, KernelConfig >	ConfigMap;
+
+	//! Reads the tuned configurations from the cache file.
+	bool Load();
+
+	//! Finds the fastest configuration for a shape.
+	static KernelConfig Tune( int nUnits, int nInputs, ThreadPool * pPool );
+
+	std::string			m_cachePath;	//!< The cache file, or empty if there is none.
+	mutable std::mutex	m_saveMutex;	//!< Serializes writes of the cache file.
+	bool				m_bTuning;		//!< True if shapes that are not in the cache are tuned.
+	mutable std::mutex	m_mutex;		//!< Guards the state below.
+	ConfigMap			m_configs;		//!< The configuration for each shape seen so far.
+};
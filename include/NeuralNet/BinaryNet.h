@@ -0,0 +1,105 @@
+/** @file *//********************************************************************************************************
+
+                                                     BinaryNet.h
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/BinaryNet.h#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#pragma once
+
+#include "NeuralNet.h"
+
+#include <cstdint>
+#include <vector>
+
+class MultilayerFeedForward;
+class Perceptron;
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! A binarized version of a trained neural net, for fast inference with binary inputs.
+//
+//! Each weight is replaced by its sign and stored as a single bit, and the inputs and the outputs of every unit are
+//! single bits, 64 to a word. The combined input of a unit is then computed with bitwise operations and population
+//! counts instead of multiplications, and the activation function is the step function (or the sign function)
+//! applied to it. The weights take 1/32 of the memory that they take in the original net.
+//!
+//! Two encodings of the bits are supported:
+//!		- ZERO_ONE: a bit represents 0 or 1, and a unit's output is Step() of its combined input. The combined input
+//!		  is <tt>popcount(x & w) - popcount(x & ~w)</tt>.
+//!		- MINUS_ONE_ONE: a bit represents -1 or 1, and a unit's output is Sign() of its combined input. The combined
+//!		  input is <tt>popcount(~(x ^ w)) - popcount(x ^ w)</tt> (XNOR and popcount).
+//!
+//! The binarized net approximates the original: an output bit is 1 where the original net's output would be at
+//! least .5 if its weights were replaced by their signs.
+
+class BinaryNet
+{
+public:
+
+	//! A word of bits.
+	typedef uint64_t				Word;
+
+	//! A vector of bits, packed into words. Bit @a i is bit (@a i % 64) of word (@a i / 64).
+	typedef std::vector< Word >		BitVector;
+
+	//! The meaning of the bits.
+	enum Encoding
+	{
+		ZERO_ONE,			//!< 0 represents 0 and 1 represents 1.
+		MINUS_ONE_ONE		//!< 0 represents -1 and 1 represents 1.
+	};
+
+	//! Constructor
+	BinaryNet( Perceptron const & p, Encoding encoding = ZERO_ONE );
+
+	//! Constructor
+	BinaryNet( MultilayerFeedForward const & mff, Encoding encoding = ZERO_ONE );
+
+	//! Destructor
+	~BinaryNet();
+
+	//! Returns the number of inputs.
+	int GetInputCount() const				{ return m_aLayers.front().nInputs; }
+
+	//! Returns the number of outputs.
+	int GetOutputCount() const				{ return m_aLayers.back().nUnits; }
+
+	//! Packs input values into bits.
+	void Pack( Neuron::InputVector const & aInputs, BitVector & aBits ) const;
+
+	//! Computes the output bits for the given input bits.
+	void Evaluate( BitVector const & aInputs, BitVector & aOutputs ) const;
+
+	//! Computes the outputs for the given input values.
+	void Evaluate( Neuron::InputVector const & aInputs, NeuralNet::OutputVector & aOutputs ) const;
+
+private:
+
+	//! A layer of binarized units.
+	struct Layer
+	{
+		int			nInputs;		//!< The number of inputs to each unit.
+		int			nUnits;			//!< The number of units.
+		int			nWords;			//!< The number of words holding the bits of each unit's weights.
+		BitVector	aWeights;		//!< The sign bits of the weights, indexed by [unit][word].
+	};
+
+	//! Adds a layer built from the signs of the weights of a set of units.
+	void AddLayer( Neuron::WeightVector const & aWeights, int first, int nInputs, int nUnits );
+
+	//! Computes the output bits of a layer.
+	void EvaluateLayer( Layer const & layer, Word const * paInputs, Word * paOutputs ) const;
+
+	Encoding				m_encoding;		//!< The meaning of the bits.
+	std::vector< Layer >	m_aLayers;		//!< The layers, from input to output.
+};
@@ -0,0 +1,110 @@
+/** @file *//********************************************************************************************************
+
+                                                     CacheFile.h
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/CacheFile.h#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! A file holding a row of floats for each sample of a data set.
+//
+//! The file starts with a header that records what the file holds (its signature), a fingerprint of the data it was
+//! computed from, and its dimensions. A file is only accepted if all of these match and its size is right, so a file
+//! that is stale, was written by something else, or is incomplete is never used.
+//!
+//! A file is written under a temporary name and renamed when it is complete, so an interrupted write never leaves a
+//! file that could be mistaken for a complete one. The file is not flushed to the disk.
+//!
+//! For example:
+//!
+//! @code
+//!		CacheFile	file;
+//!
+//!		if ( file.Open( path, SIGNATURE, fingerprint, width ) )
+//!		{
+//!			... file.Read( ... ) ...
+//!		}
+//!		else if ( file.Create( path, SIGNATURE, fingerprint, nSamples, width ) )
+//!		{
+//!			... file.Write( ... ) ...
+//!			file.Commit();
+//!		}
+//! @endcode
+//!
+//! @note	A file is only readable on a machine with the same representation of @c float.
+
+class CacheFile
+{
+public:
+
+	//! The header of a file. The rows follow it, one sample after another.
+	struct Header
+	{
+		char		signature[32];	//!< Identifies the contents of the file.
+		uint64_t	fingerprint;	//!< The fingerprint of the data the file was computed from.
+		uint64_t	nSamples;		//!< The number of samples.
+		uint64_t	width;			//!< The number of floats for each sample.
+		uint64_t	reserved;		//!< Pads the header so that the rows are aligned.
+	};
+
+	//! Constructor
+	CacheFile();
+
+	//! Destructor
+	~CacheFile();
+
+	//! Opens a complete file for reading, positioned at the first row.
+	bool Open( std::string const & path, char const * signature, uint64_t fingerprint, int width );
+
+	//! Creates a file for writing, positioned at the first row.
+	bool Create( std::string const & path, char const * signature, uint64_t fingerprint, int nSamples, int width );
+
+	//! Reads floats from the file.
+	bool Read( float * paValues, size_t count );
+
+	//! Writes floats to the file.
+	bool Write( float const * paValues, size_t count );
+
+	//! Closes a file being written and gives it its real name.
+	bool Commit();
+
+	//! Closes the file. A file being written is discarded.
+	void Close();
+
+	//! Returns true if the file is open.
+	bool IsOpen() const									{ return m_pFile != 0; }
+
+	//! Returns true if a header is valid and matches the expected contents and the size of the file.
+	static bool IsValid( Header const & header,
+						 char const * signature,
+						 uint64_t fingerprint,
+						 int width,
+						 uint64_t size );
+
+private:
+
+	// Prevent copying
+	CacheFile( CacheFile const & );
+	CacheFile & operator=( CacheFile const & );
+
+	FILE *		m_pFile;		//!< The file (or 0 if none).
+	std::string	m_path;			//!< The path of the file.
+	std::string	m_tempPath;		//!< The temporary path of a file being written, or an empty string if it is read.
+};
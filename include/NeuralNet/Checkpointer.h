@@ -0,0 +1,171 @@
+/** @file *//********************************************************************************************************
+
+                                                   Checkpointer.h
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/Checkpointer.h#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Saves checkpoints of a net being trained without stopping the training.
+//
+//! Save() makes a copy of the net, which is cheap because the copy shares the weights with the original until the
+//! original is trained (see Neuron). The copy is then serialized, checksummed and written to disk by a background
+//! thread while the training continues. A checkpoint file is written under a temporary name, flushed to the disk,
+//! and then renamed, so a checkpoint file is always complete. The newest checkpoints are kept and older ones are
+//! deleted.
+//!
+//! A checkpoint includes the training state (the step and the learning rate) so that training can be resumed from
+//! it with Restore().
+//!
+//! Checkpoint files are named <em>prefix</em>-<em>step</em>.ckpt, where the step is padded with zeros.
+
+class Checkpointer
+{
+public:
+
+	//! The state of the training, saved with the net.
+	struct TrainingState
+	{
+		long long	step;		//!< The number of training steps done.
+		float		rate;		//!< The current learning rate.
+
+		//! Constructor
+		TrainingState( long long step_ = 0, float rate_ = 0.f ) : step( step_ ), rate( rate_ ) {}
+	};
+
+	//! The default number of checkpoints kept.
+	static int const	DEFAULT_KEPT	= 3;
+
+	//! Constructor
+	Checkpointer( std::string const & prefix, int nKept = DEFAULT_KEPT );
+
+	//! Destructor
+	~Checkpointer();
+
+	//! Saves a checkpoint of a net in the background.
+	template< class Net >
+	void Save( Net const & net, TrainingState const & state );
+
+	//! Waits until every checkpoint requested so far has been written.
+	void Wait();
+
+	//! Returns the number of checkpoints that could not be written.
+	int GetFailureCount() const;
+
+	//! Restores a net and the training state from the newest valid checkpoint.
+	template< class Net >
+	bool Restore( Net & net, TrainingState & state ) const;
+
+private:
+
+	// Prevent copying
+	Checkpointer( Checkpointer const & );
+	Checkpointer & operator=( Checkpointer const & );
+
+	//! A function that writes a net to a stream.
+	typedef std::function< void ( std::ostream & out ) >	Writer;
+
+	//! A function that reads a net from a stream and returns true if it succeeded.
+	typedef std::function< bool ( std::istream & in ) >		Reader;
+
+	//! A checkpoint waiting to be written.
+	struct Job
+	{
+		Writer			write;		//!< Writes the snapshot of the net.
+		TrainingState	state;		//!< The training state.
+	};
+
+	//! Queues a checkpoint to be written.
+	void Enqueue( Writer const & write, TrainingState const & state );
+
+	//! Reads the newest valid checkpoint.
+	bool Load( Reader const & read, TrainingState & state ) const;
+
+	//! Writes a checkpoint file.
+	bool WriteCheckpoint( Job const & job ) const;
+
+	//! Deletes all but the newest checkpoints.
+	void Prune() const;
+
+	//! Returns the names of the checkpoint files, newest first.
+	std::vector< std::string > ListCheckpoints() const;
+
+	//! The main loop of the background thread.
+	void Run();
+
+	std::string					m_prefix;		//!< The path and name prefix of the checkpoint files.
+	int							m_nKept;		//!< The number of checkpoints kept.
+	mutable std::mutex			m_mutex;		//!< Guards the state below.
+	std::condition_variable		m_changed;		//!< Signals a change in the state below.
+	Job							m_pending;		//!< The checkpoint waiting to be written.
+	bool						m_bPending;		//!< True if m_pending holds a checkpoint.
+	bool						m_bWriting;		//!< True if the background thread is writing a checkpoint.
+	bool						m_bQuit;		//!< True if the background thread should exit.
+	int							m_nFailures;	//!< The number of checkpoints that could not be written.
+	std::thread					m_thread;		//!< The background thread.
+};
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Only a copy of the net is made on the calling thread. If a previous checkpoint is still waiting to be written,
+//! it is replaced by this one, so no more than two snapshots are held even if the disk is slow.
+//!
+//! @param	net		The net. @a Net must be copyable and have an operator<<.
+//! @param	state	The training state to save with the net.
+
+template< class Net >
+void Checkpointer::Save( Net const & net, TrainingState const & state )
+{
+	std::shared_ptr< Net const > const	pSnapshot	= std::make_shared< Net const >( net );
+
+	Enqueue( [pSnapshot] ( std::ostream & out ) { out << *pSnapshot; }, state );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Checkpoints that are incomplete or fail their checksum are skipped, so training resumes from the newest checkpoint
+//! that is intact.
+//!
+//! @param	net		The net to restore. @a Net must have an operator>>. Settings that are not serialized (such as a
+//!					thread pool) are kept.
+//! @param	state	Where to store the training state.
+//!
+//! @return		True if a checkpoint was restored.
+
+template< class Net >
+bool Checkpointer::Restore( Net & net, TrainingState & state ) const
+{
+	return Load( [&net] ( std::istream & in ) -> bool
+	{
+		in >> net;
+		return !in.fail();
+	}, state );
+}
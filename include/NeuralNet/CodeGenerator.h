@@ -0,0 +1,56 @@
+/** @file *//********************************************************************************************************
+
+                                                   CodeGenerator.h
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/CodeGenerator.h#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#pragma once
+
+#include <iosfwd>
+#include <string>
+
+class MultilayerFeedForward;
+class Perceptron;
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @name Ahead-of-time code generation
+//
+//! These functions write a self-contained C++ header that evaluates a trained net. The weights are stored in
+//! aligned <tt>inline constexpr</tt> arrays (so a program has one copy of them, however many files include the
+//! header) and the evaluation function is specialized for the net's topology, so a program that includes the header
+//! needs neither the library nor a model file, and does no heap allocation to evaluate the net.
+//!
+//! Everything in the header is placed in a namespace given by @a name, which must be a valid C++ identifier and not
+//! a keyword (see IsValidName()). The namespace contains the constants @c NUM_INPUTS and @c NUM_OUTPUTS (and
+//! @c NUM_HIDDEN for a MultilayerFeedForward), the weight arrays, and this function:
+//!
+//! @code
+//!		inline void Evaluate( float const * paInputs, float * paOutputs );
+//! @endcode
+//!
+//! The weights are written with enough digits to be reproduced exactly, and the sums are computed in the same
+//! order as the library computes them, so the generated function's outputs match the library's. A net with a weight
+//! that is not finite cannot be written. The header requires C++17.
+//@{
+
+//! Returns true if @a name can be used as the name of the generated code.
+bool IsValidName( std::string const & name );
+
+//! Writes a header that evaluates a Perceptron.
+bool GenerateHeader( std::ostream & out, Perceptron const & p, std::string const & name );
+
+//! Writes a header that evaluates a MultilayerFeedForward.
+bool GenerateHeader( std::ostream & out, MultilayerFeedForward const & mff, std::string const & name );
+
+//@}
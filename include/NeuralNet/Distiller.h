@@ -0,0 +1,117 @@
+/** @file *//********************************************************************************************************
+
+                                                     Distiller.h
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/Distiller.h#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#pragma once
+
+#include "NeuralNet.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+
+class MultilayerFeedForward;
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Trains a small net (the student) to reproduce the outputs of a large trained net (the teacher).
+//
+//! The student is trained on the teacher's outputs (the soft targets) instead of the original targets. The soft
+//! targets carry more information per sample than the original targets (for example, how close a sample is to each
+//! class), so a student trained on them usually keeps most of the teacher's accuracy with far fewer units, and it is
+//! much cheaper to evaluate.
+//!
+//! The soft targets are computed a block of samples at a time with NeuralNet::EvaluateBatch() by a background thread,
+//! which stays a few blocks ahead of the student's training. If a cache file is set, the soft targets are written to
+//! it during the first epoch and read from it in later epochs (and in later runs, if the teacher and the data set have
+//! not changed), so the teacher is evaluated only once.
+//!
+//! The soft targets may be blended with the original (hard) targets. For example:
+//!
+//! @code
+//!		MultilayerFeedForward	student( nInputs, nSmallHidden, nOutputs );
+//!		Distiller				distiller( teacher, student, aInputs );
+//!
+//!		distiller.SetHardTargets( aTargets, 0.1f );
+//!		distiller.SetCache( path );
+//!
+//!		for ( ... each epoch ... )
+//!		{
+//!			float const	loss	= distiller.Train( rate );
+//!		}
+//! @endcode
+
+class Distiller
+{
+public:
+
+	//! The default number of samples whose soft targets are computed together.
+	static int const	DEFAULT_BLOCK_SIZE	= 256;
+
+	//! Constructor
+	Distiller( MultilayerFeedForward const & teacher,
+			   NeuralNet & student,
+			   NeuralNet::InputBatch const & aInputs,
+			   int blockSize = DEFAULT_BLOCK_SIZE );
+
+	//! Destructor
+	~Distiller();
+
+	//! Blends the original targets with the soft targets.
+	void SetHardTargets( NeuralNet::OutputBatch const & aTargets, float weight );
+
+	//! Sets the file caching the soft targets.
+	bool SetCache( std::string const & path );
+
+	//! Trains the student for one epoch.
+	float Train( float rate );
+
+private:
+
+	// Prevent copying
+	Distiller( Distiller const & );
+	Distiller & operator=( Distiller const & );
+
+	//! The soft targets of a block of samples.
+	struct Block
+	{
+		int						first;		//!< The first sample in the block.
+		NeuralNet::OutputBatch	aOutputs;	//!< The soft targets of the samples in the block.
+	};
+
+	//! Returns a hash of the teacher and the data set.
+	uint64_t Fingerprint() const;
+
+	//! Returns true if the cache file is complete and matches the teacher and the data set.
+	bool IsCacheValid() const;
+
+	//! The main loop of the background thread. It computes (or reads) the soft targets for one epoch.
+	void Produce();
+
+	MultilayerFeedForward const &	m_teacher;			//!< The teacher.
+	NeuralNet &						m_student;			//!< The student.
+	NeuralNet::InputBatch const &	m_aInputs;			//!< The inputs of the data set.
+	int								m_blockSize;		//!< The number of samples in a block.
+	NeuralNet::OutputBatch const *	m_paHardTargets;	//!< The original targets (or 0 if none).
+	float							m_hardWeight;		//!< The weight of the original targets in the blend.
+	std::string						m_path;				//!< The cache file (or an empty string if none).
+	uint64_t						m_fingerprint;		//!< The fingerprint of the teacher and the data set.
+	bool							m_bCached;			//!< True if the cache file holds all the soft targets.
+	std::mutex						m_mutex;			//!< Guards the state below.
+	std::condition_variable			m_changed;			//!< Signals a change in the state below.
+	std::deque< Block >				m_blocks;			//!< The blocks computed and waiting to be trained.
+};
@@ -0,0 +1,81 @@
+/** @file *//********************************************************************************************************
+
+                                                DistributedTrainer.h
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/DistributedTrainer.h#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#pragma once
+
+#include "MultilayerFeedForward.h"
+
+class RingAllReduce;
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Trains copies of a net in several processes as if they were one net (data-parallel training).
+//
+//! Each process (a worker) has its own copy of the net and its own shard of the training data. In each step, every
+//! worker computes the changes to the weights for a batch from its shard, the changes are summed across the workers
+//! with a RingAllReduce, and every worker applies the same summed changes, so the copies stay identical.
+//!
+//! The communication overlaps the backward pass: the changes to the output weights are sent while the changes to the
+//! hidden weights are being computed, and then the changes to the hidden weights are sent.
+//!
+//! For example, in each worker:
+//!
+//! @code
+//!		RingAllReduce			ring( rank, aAddresses );
+//!		MultilayerFeedForward	net( nInputs, nHidden, nOutputs );
+//!		DistributedTrainer		trainer( net, ring );
+//!
+//!		if ( !ring.Connect() || !trainer.Synchronize() )
+//!		{
+//!			... fail ...
+//!		}
+//!
+//!		for ( ... each batch in this worker's shard ... )
+//!		{
+//!			trainer.Train( aInputs, aTargets, rate );
+//!		}
+//! @endcode
+
+class DistributedTrainer
+{
+public:
+
+	//! Constructor
+	DistributedTrainer( MultilayerFeedForward & net, RingAllReduce & ring );
+
+	//! Destructor
+	~DistributedTrainer();
+
+	//! Copies the weights of the net in the first worker to the nets in all the workers.
+	bool Synchronize();
+
+	//! Trains the net with a batch from each worker.
+	bool Train( NeuralNet::InputBatch const & aInputs, NeuralNet::OutputBatch const & aTargets, float rate );
+
+	//! Returns the mean loss of the samples in the most recent step of all the workers.
+	float GetLoss() const								{ return m_loss; }
+
+private:
+
+	// Prevent copying
+	DistributedTrainer( DistributedTrainer const & );
+	DistributedTrainer & operator=( DistributedTrainer const & );
+
+	MultilayerFeedForward &				m_net;			//!< The net being trained.
+	RingAllReduce &						m_ring;			//!< Sums the changes across the workers.
+	MultilayerFeedForward::Gradients	m_gradients;	//!< The changes computed in the most recent step.
+	float								m_loss;			//!< The mean loss in the most recent step.
+};
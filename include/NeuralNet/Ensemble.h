@@ -0,0 +1,94 @@
+/** @file *//********************************************************************************************************
+
+                                                     Ensemble.h
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/Ensemble.h#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#pragma once
+
+#include "Neuron.h"
+
+#include <vector>
+
+class MultilayerFeedForward;
+class Perceptron;
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! A collection of independent neural nets with the same topology that are evaluated and trained together.
+//
+//! The weights of the nets are stored interleaved: all the nets' values of a given weight are adjacent in memory. As
+//! a result, the innermost loop of every computation runs across the nets with unit stride and no dependencies, so
+//! the compiler can vectorize it and each SIMD lane processes a different net. This avoids the virtual dispatch and
+//! scattered memory accesses of evaluating thousands of small nets one at a time.
+//!
+//! An ensemble with no hidden units is a collection of Perceptrons, and one with hidden units is a collection of
+//! MultilayerFeedForward nets. Each net gets its own inputs, and the inputs, outputs and errors are all interleaved
+//! the same way as the weights: value @a k of net @a m is at index <tt>k * nModels + m</tt>.
+
+class Ensemble
+{
+public:
+
+	//! A vector of interleaved values.
+	typedef std::vector< float >	ValueVector;
+
+	//! Constructor
+	Ensemble( int nModels, int nInputs, int nHidden, int nOutputs );
+
+	//! Destructor
+	~Ensemble();
+
+	//! Returns the number of nets in the ensemble.
+	int GetModelCount() const				{ return m_nModels; }
+
+	//! Sets the weights of one of the nets from a Perceptron.
+	void Set( int model, Perceptron const & p );
+
+	//! Sets the weights of one of the nets from a MultilayerFeedForward.
+	void Set( int model, MultilayerFeedForward const & mff );
+
+	//! Returns the weights of one of the nets.
+	Neuron::WeightVector GetWeights( int model ) const;
+
+	//! Computes the outputs of every net.
+	ValueVector const & operator()( ValueVector const & aInputs );
+
+	//! Trains every net by applying error values.
+	void Train( ValueVector const & aInputs, ValueVector const & aErrors, float rate );
+
+private:
+
+	//! Sets the weights of one of the nets.
+	void SetWeights( int model, Neuron::WeightVector const & aWeights );
+
+	//! Computes the outputs of a layer.
+	void ForwardLayer( ValueVector const & aWeights, int nUnits, int nInputs, float const * paInputs, float * paOutputs,
+					   float * paGradients );
+
+	//! Adjusts the weights of a layer.
+	void AdjustLayer( ValueVector & aWeights, int nUnits, int nInputs, float const * paInputs, float const * paErrors,
+					  float rate );
+
+	int				m_nModels;				//!< The number of nets.
+	int				m_nInputs;				//!< The number of inputs to each net.
+	int				m_nHidden;				//!< The number of hidden units in each net (0 if they are Perceptrons).
+	int				m_nOutputs;				//!< The number of outputs from each net.
+	ValueVector		m_aHiddenWeights;		//!< The hidden units' weights, indexed by [unit][input][net].
+	ValueVector		m_aHiddenOutputs;		//!< The outputs from the hidden units, indexed by [unit][net].
+	ValueVector		m_aHiddenGradients;		//!< The gradients of the hidden units' outputs, indexed by [unit][net].
+	ValueVector		m_aOutputWeights;		//!< The output units' weights, indexed by [unit][input][net].
+	ValueVector		m_aOutputs;				//!< The outputs, indexed by [unit][net].
+	ValueVector		m_aOutputGradients;		//!< The gradients of the outputs, indexed by [unit][net].
+	ValueVector		m_aSums;				//!< Scratch space for the combined inputs of one unit of each net.
+};
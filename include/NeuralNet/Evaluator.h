@@ -0,0 +1,127 @@
+/** @file *//********************************************************************************************************
+
+                                                     Evaluator.h
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/Evaluator.h#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#pragma once
+
+#include "NeuralNet.h"
+
+#include <vector>
+
+class ThreadPool;
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Measures a net over a whole data set in one parallel pass.
+//
+//! The data set is split into blocks of samples, and each block is evaluated with one call to
+//! NeuralNet::EvaluateBatch(). The blocks are spread over the threads of a thread pool, if one is given. The metrics
+//! (the loss, the accuracy, a confusion matrix and calibration statistics) are computed from each block's outputs
+//! as soon as the block has been evaluated, so the outputs of the whole data set are never stored.
+//!
+//! The metrics of each block are computed separately and merged in the order of the blocks, so the results do not
+//! depend on the number of threads.
+//!
+//! For example:
+//!
+//! @code
+//!		Evaluator				evaluator( &pool );
+//!		Evaluator::Metrics		metrics		= evaluator.Evaluate( net, aInputs, aTargets );
+//!
+//!		printf( "accuracy %f, calibration error %f\n", metrics.GetAccuracy(), metrics.GetCalibrationError() );
+//! @endcode
+//!
+//! @note	For classification, the class of a sample is the index of its largest target, the predicted class is the
+//!			index of its largest output, and the confidence of a prediction is the largest output.
+
+class Evaluator
+{
+public:
+
+	//! The default number of samples evaluated together.
+	static int const	DEFAULT_BLOCK_SIZE	= 256;
+
+	//! The default number of bins used to measure the calibration.
+	static int const	DEFAULT_BIN_COUNT	= 10;
+
+	//! The predictions whose confidence falls in a range.
+	struct CalibrationBin
+	{
+		long long	nSamples;		//!< The number of predictions in the bin.
+		long long	nCorrect;		//!< The number of correct predictions in the bin.
+		double		confidence;		//!< The sum of the confidences of the predictions in the bin.
+	};
+
+	//! The metrics of a net over a data set.
+	struct Metrics
+	{
+		int								nOutputs;		//!< The number of outputs of the net.
+		long long						nSamples;		//!< The number of samples.
+		long long						nCorrect;		//!< The number of samples whose class was predicted.
+		double							squaredError;	//!< The sum of the squared errors of all the outputs.
+		std::vector< long long >		aConfusion;		//!< The confusion matrix, one row for each class.
+		std::vector< CalibrationBin >	aBins;			//!< The calibration bins, in order of confidence.
+
+		//! Constructor
+		Metrics( int nOutputs_ = 0, int nBins = DEFAULT_BIN_COUNT );
+
+		//! Adds the metrics of other samples.
+		void Merge( Metrics const & other );
+
+		//! Returns the mean of the squared errors of all the outputs.
+		float GetMeanSquaredError() const;
+
+		//! Returns the fraction of the samples whose class was predicted.
+		float GetAccuracy() const;
+
+		//! Returns the number of samples of class @a actual that were predicted to be of class @a predicted.
+		long long GetConfusion( int actual, int predicted ) const
+		{
+			return aConfusion[(size_t)actual * nOutputs + predicted];
+		}
+
+		//! Returns the expected calibration error.
+		float GetCalibrationError() const;
+	};
+
+	//! Constructor
+	Evaluator( ThreadPool * pPool = 0, int blockSize = DEFAULT_BLOCK_SIZE, int nBins = DEFAULT_BIN_COUNT );
+
+	//! Destructor
+	~Evaluator();
+
+	//! Measures a net over a data set.
+	Metrics Evaluate( NeuralNet const & net,
+					  NeuralNet::InputBatch const & aInputs,
+					  NeuralNet::OutputBatch const & aTargets ) const;
+
+private:
+
+	// Prevent copying
+	Evaluator( Evaluator const & );
+	Evaluator & operator=( Evaluator const & );
+
+	//! Measures a net over a block of samples.
+	void EvaluateBlock( NeuralNet const & net,
+						NeuralNet::InputBatch const & aInputs,
+						NeuralNet::OutputBatch const & aTargets,
+						int first,
+						int last,
+						Metrics & metrics ) const;
+
+	ThreadPool *	m_pPool;		//!< The thread pool evaluating the blocks (or 0 if none).
+	int				m_blockSize;	//!< The number of samples in a block.
+	int				m_nBins;		//!< The number of calibration bins.
+};
@@ -0,0 +1,105 @@
+/** @file *//********************************************************************************************************
+
+                                                       Fnv1a.h
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/Fnv1a.h#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Computes a 64-bit FNV-1a hash.
+//
+//! The hash is not cryptographic. It is used to detect files that are damaged or were written for different data, and
+//! to look up values in hash tables.
+//!
+//! For example:
+//!
+//! @code
+//!		Fnv1a	hash;
+//!
+//!		hash.Add( &nInputs, sizeof( nInputs ) );
+//!		hash.Add( aWeights.data(), aWeights.size() * sizeof( float ) );
+//!		return hash.GetValue();
+//! @endcode
+
+class Fnv1a
+{
+public:
+
+	//! Constructor
+	Fnv1a()												: m_value( OFFSET_BASIS ) {}
+
+	//! Adds bytes to the hash.
+	void Add( void const * pData, size_t size );
+
+	//! Adds a 32-bit value to the hash as a single unit rather than as 4 bytes.
+	void AddWord( uint32_t value )						{ m_value = ( m_value ^ value ) * PRIME; }
+
+	//! Returns the hash of the data added so far.
+	uint64_t GetValue() const							{ return m_value; }
+
+	//! Returns the hash of a block of bytes.
+	static uint64_t Hash( void const * pData, size_t size );
+
+private:
+
+	//! The initial value of the hash.
+	static uint64_t const	OFFSET_BASIS	= 14695981039346656037ULL;
+
+	//! The multiplier applied after each unit is added.
+	static uint64_t const	PRIME			= 1099511628211ULL;
+
+	uint64_t	m_value;	//!< The hash of the data added so far.
+};
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	pData	The bytes.
+//! @param	size	The number of bytes.
+
+inline void Fnv1a::Add( void const * pData, size_t size )
+{
+	unsigned char const *	pBytes	= static_cast< unsigned char const * >( pData );
+
+	for ( size_t i = 0; i < size; i++ )
+	{
+		m_value ^= pBytes[i];
+		m_value *= PRIME;
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	pData	The bytes.
+//! @param	size	The number of bytes.
+//!
+//! @return		The 64-bit FNV-1a hash of the bytes.
+
+inline uint64_t Fnv1a::Hash( void const * pData, size_t size )
+{
+	Fnv1a	hash;
+
+	hash.Add( pData, size );
+
+	return hash.GetValue();
+}
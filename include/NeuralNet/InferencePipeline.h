@@ -0,0 +1,123 @@
+/** @file *//********************************************************************************************************
+
+                                                 InferencePipeline.h
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/InferencePipeline.h#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#pragma once
+
+#include "NeuralNet.h"
+#include "SpscRing.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+class MultilayerFeedForward;
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Evaluates a stream of inputs with each layer of a net on its own core.
+//
+//! The pipeline has a stage for each layer of a MultilayerFeedForward, and each stage runs on its own thread,
+//! optionally pinned to a core. While the output stage evaluates one input, the hidden stage evaluates the next, so
+//! each core only uses the weights of its own layer and keeps them in its cache. When the weights of the whole net do
+//! not fit in one core's cache but the weights of each layer do, this gives much more throughput than evaluating
+//! every layer on every core.
+//!
+//! The inputs, the outputs of the hidden units and the outputs are held in a fixed set of slots, and the slots are
+//! passed from stage to stage through lock-free single-producer, single-consumer rings (see SpscRing), so no memory
+//! is allocated and no lock is taken after construction. The outputs come out in the same order as the inputs went
+//! in.
+//!
+//! One thread (the producer) calls Push() and one thread (the consumer) calls Pop(). They may be the same thread. For
+//! example:
+//!
+//! @code
+//!		InferencePipeline	pipeline( net );
+//!
+//!		// Producer
+//!		while ( !pipeline.Push( aInputs ) )
+//!		{
+//!			... the pipeline is full, so wait or do something else ...
+//!		}
+//!
+//!		// Consumer
+//!		while ( !pipeline.Pop( aOutputs ) )
+//!		{
+//!			... no outputs are ready yet, so wait or do something else ...
+//!		}
+//! @endcode
+//!
+//! @note	Idle stages poll their rings, yielding the processor and then sleeping briefly, so a pipeline is meant for
+//!			a steady stream of inputs.
+
+class InferencePipeline
+{
+public:
+
+	//! The default number of inputs in the pipeline at once.
+	static int const	DEFAULT_CAPACITY	= 64;
+
+	//! Constructor
+	InferencePipeline( MultilayerFeedForward const & net,
+					   int capacity = DEFAULT_CAPACITY,
+					   std::vector< int > const & aCores = std::vector< int >() );
+
+	//! Destructor
+	~InferencePipeline();
+
+	//! Adds an input to the pipeline. Only the producer thread may call this.
+	bool Push( Neuron::InputVector const & aInputs );
+
+	//! Removes the outputs of the oldest input from the pipeline. Only the consumer thread may call this.
+	bool Pop( NeuralNet::OutputVector & aOutputs );
+
+	//! Returns the maximum number of inputs in the pipeline at once.
+	int GetCapacity() const								{ return (int)m_aSlots.size(); }
+
+private:
+
+	// Prevent copying
+	InferencePipeline( InferencePipeline const & );
+	InferencePipeline & operator=( InferencePipeline const & );
+
+	//! The stages.
+	enum Stage
+	{
+		HIDDEN_STAGE,		//!< Computes the outputs of the hidden units.
+		OUTPUT_STAGE,		//!< Computes the outputs.
+
+		NUM_STAGES
+	};
+
+	//! The values for one input. A slot is used by one stage at a time.
+	struct alignas( 64 ) Slot
+	{
+		Neuron::InputVector		aInputs;			//!< The inputs.
+		NeuralNet::OutputVector	aHiddenOutputs;		//!< The outputs of the hidden units.
+		NeuralNet::OutputVector	aOutputs;			//!< The outputs.
+	};
+
+	//! The main loop of a stage's thread.
+	void Run( Stage stage );
+
+	MultilayerFeedForward const &	m_net;			//!< The net.
+	std::vector< Slot >				m_aSlots;		//!< The slots.
+	SpscRing< int >					m_free;			//!< The free slots, from the consumer to the producer.
+	SpscRing< int >					m_inputs;		//!< The slots holding inputs, to the hidden stage.
+	SpscRing< int >					m_hidden;		//!< The slots holding hidden outputs, to the output stage.
+	SpscRing< int >					m_outputs;		//!< The slots holding outputs, to the consumer.
+	std::atomic< bool >				m_bQuit;		//!< True if the stages should exit.
+	std::vector< std::thread >		m_aThreads;		//!< The thread of each stage.
+};
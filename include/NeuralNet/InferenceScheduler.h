@@ -0,0 +1,118 @@
+/** @file *//********************************************************************************************************
+
+                                                InferenceScheduler.h
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/InferenceScheduler.h#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#pragma once
+
+#include "NeuralNet.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Serves evaluation requests from many threads by combining them into batches.
+//
+//! Callers submit single inputs and receive the outputs through a future or a callback. Requests are queued and
+//! worker threads evaluate them in batches with NeuralNet::EvaluateBatch(). A batch is started when the queue
+//! holds the maximum number of requests, or when the oldest request has waited for the maximum delay, whichever
+//! happens first. Batching trades a bounded increase in latency for much higher throughput, since each unit's
+//! weights are loaded once per batch rather than once per request.
+//!
+//! The scheduler records the time each request spends in the queue and the size of each batch.
+
+class InferenceScheduler
+{
+public:
+
+	//! A function that receives the outputs of a request.
+	typedef std::function< void ( NeuralNet::OutputVector const & aOutputs ) >	Callback;
+
+	//! A histogram with power-of-two buckets.
+	struct Histogram
+	{
+		std::vector< long >	aCounts;	//!< aCounts[0] is the number of values less than 1, and aCounts[k] is the
+										//!< number of values in the range [2^(k-1), 2^k).
+		long				count;		//!< The number of values.
+		double				sum;		//!< The sum of the values.
+
+		//! Constructor
+		Histogram() : count( 0 ), sum( 0. ) {}
+
+		//! Adds a value to the histogram.
+		void Add( double value );
+	};
+
+	//! Statistics about the requests processed so far.
+	struct Statistics
+	{
+		Histogram	queueDelays;	//!< The time each request spent in the queue, in microseconds.
+		Histogram	batchSizes;		//!< The number of requests in each batch.
+	};
+
+	//! Constructor
+	InferenceScheduler( NeuralNet const & net, int maxBatchSize, std::chrono::microseconds maxDelay, int nThreads = 1 );
+
+	//! Destructor
+	~InferenceScheduler();
+
+	//! Submits a request and returns a future for the outputs.
+	std::future< NeuralNet::OutputVector > Submit( Neuron::InputVector const & aInputs );
+
+	//! Submits a request whose outputs are passed to a callback.
+	void Submit( Neuron::InputVector const & aInputs, Callback const & callback );
+
+	//! Returns the statistics about the requests processed so far.
+	Statistics GetStatistics() const;
+
+private:
+
+	// Prevent copying
+	InferenceScheduler( InferenceScheduler const & );
+	InferenceScheduler & operator=( InferenceScheduler const & );
+
+	typedef std::chrono::steady_clock	Clock;
+
+	//! A queued request.
+	struct Request
+	{
+		Neuron::InputVector						aInputs;	//!< The inputs.
+		std::promise< NeuralNet::OutputVector >	promise;	//!< Receives the outputs if there is no callback.
+		Callback								callback;	//!< Receives the outputs (if not empty).
+		Clock::time_point						arrival;	//!< When the request was submitted.
+	};
+
+	//! Adds a request to the queue.
+	void Enqueue( Request & request );
+
+	//! The main loop of a worker thread.
+	void Run();
+
+	NeuralNet const &				m_net;				//!< The net evaluating the requests.
+	int								m_maxBatchSize;		//!< The maximum number of requests in a batch.
+	std::chrono::microseconds		m_maxDelay;			//!< The longest a request waits for a batch to fill.
+	std::vector< std::thread >		m_aThreads;			//!< The worker threads.
+	mutable std::mutex				m_mutex;			//!< Guards the state below.
+	std::condition_variable			m_ready;			//!< Signals the workers that requests are waiting.
+	std::deque< Request >			m_queue;			//!< The waiting requests.
+	Statistics						m_statistics;		//!< The statistics.
+	bool							m_bQuit;			//!< True if the workers should exit.
+};
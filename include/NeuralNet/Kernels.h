@@ -0,0 +1,59 @@
+/** @file *//********************************************************************************************************
+
+                                                      Kernels.h
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/Kernels.h#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+class Neuron;
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! A configuration of the kernel that computes the combined inputs of a layer's units.
+//
+//! The fastest configuration depends on the shape of the layer and on the processor, so it is usually chosen by an
+//! Autotuner. The default configuration computes each sum in the same order as Neuron::Input().
+
+struct KernelConfig
+{
+	int		unroll;		//!< The number of partial sums kept for each unit (1, 4 or 8).
+	int		unitBlock;	//!< The number of units whose sums are computed together (1, 2 or 4).
+	int		tileSize;	//!< The number of units in each tile when a layer is split across threads, or 0 for the
+						//!< default tile size.
+
+	//! Constructor
+	KernelConfig( int unroll_ = 1, int unitBlock_ = 1, int tileSize_ = 0 )
+		: unroll( unroll_ ),
+		unitBlock( unitBlock_ ),
+		tileSize( tileSize_ )
+	{
+	}
+
+	//! Returns true if the configuration is supported.
+	bool IsValid() const;
+
+	//! Returns every supported kernel configuration (with the default tile size).
+	static std::vector< KernelConfig > GetCandidates();
+};
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Computes the combined inputs of a range of units.
+void ComputeSums( KernelConfig const & config, Neuron const * paUnits, int nUnits, float const * paInputs,
+				  float * paSums );
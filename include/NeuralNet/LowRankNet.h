@@ -0,0 +1,161 @@
+/** @file *//********************************************************************************************************
+
+                                                    LowRankNet.h
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/LowRankNet.h#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#pragma once
+
+#include "MultilayerFeedForward.h"
+#include "NeuralNet.h"
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! A compressed version of a trained MultilayerFeedForward, for faster inference.
+//
+//! The weights of a layer form a matrix with a row for each unit and a column for each input. When the rows are
+//! nearly linearly dependent (as they often are in wide layers), the matrix is close to the product of two thin
+//! matrices: a projection of the inputs onto a few directions, and the weights of the units for the projected
+//! inputs. A layer with @a m units, @a n inputs and rank @a r then takes <em>r</em>(<em>m</em> + <em>n</em>)
+//! multiplications and weights instead of <em>mn</em>.
+//!
+//! The factors are computed with a truncated singular value decomposition, which is the most accurate product of
+//! the given rank. The rank of each layer is chosen separately, either to keep the error in the weights under a
+//! target or to reach a target speedup. A layer is only factorized if that makes it smaller; otherwise it is copied.
+//!
+//! The compressed net can be trained briefly (fine-tuned) to recover some of the accuracy lost in the compression.
+//! Training changes both factors of a factorized layer, and keeps the rank.
+//!
+//! @note	The decomposition takes time proportional to the cube of the smaller dimension of each layer, so it is
+//!			meant to be done once, after training.
+
+class LowRankNet : public NeuralNet
+{
+	friend std::ostream & operator<<( std::ostream & out, LowRankNet const & net );
+	friend std::istream & operator>>( std::istream & in, LowRankNet & net );
+
+public:
+
+	//! How the rank of each layer is chosen.
+	enum Criterion
+	{
+		MAX_ERROR,			//!< The smallest rank whose relative error (in the Frobenius norm) is within the target.
+		MIN_SPEEDUP			//!< The largest rank that reduces the number of multiplications by the target factor.
+	};
+
+	//! Constructor
+	LowRankNet();
+
+	//! Constructor
+	LowRankNet( MultilayerFeedForward const & mff, Criterion criterion, float target );
+
+	//! Copy constructor. The weights are shared until one of the nets is trained.
+	LowRankNet( LowRankNet const & ) = default;
+
+	//! Move constructor
+	LowRankNet( LowRankNet && ) = default;
+
+	//! Destructor
+	~LowRankNet();
+
+	//! Assignment operator. The weights are shared until one of the nets is trained.
+	LowRankNet & operator=( LowRankNet const & ) = default;
+
+	//! Move assignment operator
+	LowRankNet & operator=( LowRankNet && ) = default;
+
+	//! Returns the rank of a layer, or 0 if it is not factorized.
+	int GetRank( MultilayerFeedForward::Layer layer ) const
+	{
+		return (int)GetLayer( layer ).aProjection.size();
+	}
+
+	//! Returns the relative error in the weights of a layer introduced by the factorization.
+	float GetError( MultilayerFeedForward::Layer layer ) const		{ return GetLayer( layer ).error; }
+
+	//! Returns the number of weights (and the number of multiplications in an evaluation).
+	int GetWeightCount() const;
+
+	//! @name Overrides NeuralNet
+	//@{
+	virtual OutputVector const & operator()( Neuron::InputVector const & aInputs );
+	virtual void Evaluate( Neuron::InputVector const & aInputs, OutputVector & aOutputs ) const;
+	virtual void EvaluateSelected( Neuron::InputVector const & aInputs, IndexVector const & aIndexes,
+								   OutputVector & aOutputs ) const;
+	virtual void TopK( Neuron::InputVector const & aInputs, int k, RankedOutputVector & aBest ) const;
+	virtual void SetMemoryResource( std::pmr::memory_resource * pResource );
+	virtual void Train( Neuron::InputVector const & aInputs, ErrorVector const & aErrors, float rate );
+	//@}
+
+private:
+
+	//! A vector of units.
+	typedef std::vector< Neuron >	UnitVector;
+
+	//! A vector of gradient values.
+	typedef std::vector< float >	GradientVector;
+
+	//! A layer, possibly factorized.
+	struct Layer
+	{
+		UnitVector	aProjection;	//!< The directions the inputs are projected onto (empty if not factorized).
+		UnitVector	aUnits;			//!< The units. Their inputs are the projected inputs if the layer is factorized.
+		float		error;			//!< The relative error in the weights introduced by the factorization.
+
+		//! Constructor
+		Layer() : error( 0.f ) {}
+	};
+
+	//! Returns a layer.
+	Layer const & GetLayer( MultilayerFeedForward::Layer layer ) const
+	{
+		return ( layer == MultilayerFeedForward::HIDDEN_LAYER ) ? m_hidden : m_output;
+	}
+
+	//! Factorizes the weights of a layer.
+	static void Factorize( float const * paWeights, int nUnits, int nInputs, Criterion criterion, float target,
+						   Layer & layer );
+
+	//! Computes the combined inputs of the units of a layer.
+	static void ComputeLayerSums( Layer const & layer, float const * paInputs, OutputVector & aProjected,
+								  OutputVector & aSums );
+
+	//! Adjusts the weights of a layer and computes the error terms of its inputs.
+	void BackPropagate( Layer & layer, Neuron::InputVector const & aInputs, OutputVector const & aProjected,
+						GradientVector const & aDeltas, GradientVector * paInputDeltas, float rate );
+
+	//! Computes the outputs of the hidden units.
+	void EvaluateHidden( Neuron::InputVector const & aInputs, OutputVector & aHiddenOutputs ) const;
+
+	Layer					m_hidden;				//!< The hidden layer.
+	Layer					m_output;				//!< The output layer.
+	Neuron::InputVector		m_aInputs;				//!< The most recent inputs.
+	OutputVector			m_aHiddenProjected;		//!< The projected inputs of the hidden layer.
+	OutputVector			m_aHiddenOutputs;		//!< The outputs from the hidden units.
+	GradientVector			m_aHiddenGradients;		//!< The gradients of the outputs from the hidden units.
+	OutputVector			m_aOutputProjected;		//!< The projected inputs of the output layer.
+	GradientVector			m_aOutputGradients;		//!< The gradients of the outputs from the output units.
+	GradientVector			m_aPropagated;			//!< The error terms propagated back to the hidden outputs.
+	GradientVector			m_aProjectedDeltas;		//!< The error terms of the projected inputs of a layer.
+};
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Inserts a LowRankNet into a stream.
+std::ostream & operator<<( std::ostream & out, LowRankNet const & net );
+
+//! Extracts a LowRankNet from a stream.
+std::istream & operator>>( std::istream & in, LowRankNet & net );
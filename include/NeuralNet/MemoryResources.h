@@ -0,0 +1,213 @@
+/** @file *//********************************************************************************************************
+
+                                                  MemoryResources.h
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/MemoryResources.h#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Memory resources for the weights of a net
+//
+//! The weights of every Neuron are allocated from a std::pmr::memory_resource. A net's weights are moved into a
+//! resource with NeuralNet::SetMemoryResource(). These resources control the placement of the weights:
+//!
+//!		- AlignedResource aligns every allocation to a cache line (or more).
+//!		- PageResource allocates whole pages, optionally huge pages, optionally bound to a NUMA node.
+//!		- ArenaResource packs many small allocations into large chunks from another resource, so that the weights of
+//!		  all the units of a net share a few (huge) pages.
+//!
+//! For example, to place a read-only copy of a net in huge pages on each NUMA node:
+//!
+//! @code
+//!		PageResource			pages( PageResource::TRANSPARENT_HUGE_PAGES, node );
+//!		ArenaResource			arena( &pages );
+//!		MultilayerFeedForward	replica( net );
+//!
+//!		replica.SetMemoryResource( &arena );
+//! @endcode
+//!
+//! A thread then uses the replica for the node it is running on (see PageResource::GetCurrentNode()).
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! A memory resource that aligns every allocation.
+
+class AlignedResource : public std::pmr::memory_resource
+{
+public:
+
+	//! The default alignment (a cache line).
+	static size_t const	DEFAULT_ALIGNMENT	= 64;
+
+	//! Constructor
+	explicit AlignedResource( size_t alignment = DEFAULT_ALIGNMENT,
+							  std::pmr::memory_resource * pUpstream = std::pmr::new_delete_resource() );
+
+	//! Destructor
+	virtual ~AlignedResource();
+
+protected:
+
+	//! @name Overrides std::pmr::memory_resource
+	//@{
+	virtual void * do_allocate( size_t bytes, size_t alignment );
+	virtual void do_deallocate( void * p, size_t bytes, size_t alignment );
+	virtual bool do_is_equal( std::pmr::memory_resource const & other ) const noexcept;
+	//@}
+
+private:
+
+	// Prevent copying
+	AlignedResource( AlignedResource const & );
+	AlignedResource & operator=( AlignedResource const & );
+
+	size_t						m_alignment;	//!< The minimum alignment of an allocation.
+	std::pmr::memory_resource *	m_pUpstream;	//!< The resource that provides the memory.
+};
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! A memory resource that allocates whole pages directly from the operating system.
+//
+//! Allocations are rounded up to a whole number of pages, so this resource is meant for large allocations. It is
+//! usually the upstream resource of an ArenaResource.
+//!
+//! Huge pages reduce the number of TLB misses when streaming through large arrays of weights. Transparent huge pages
+//! are requested with @c madvise() and are used if the system allows it. Explicit huge pages come from the system's
+//! reserved pool (@c MAP_HUGETLB); if none are available, transparent huge pages are used instead.
+//!
+//! If a NUMA node is given, the pages are bound to that node, so that threads running on the node do not read the
+//! memory across the interconnect.
+//!
+//! @note	Huge pages and NUMA binding are supported on Linux. On other systems, the memory is only page-aligned.
+
+class PageResource : public std::pmr::memory_resource
+{
+public:
+
+	//! The use of huge pages.
+	enum HugePages
+	{
+		NO_HUGE_PAGES,				//!< Normal pages are used.
+		TRANSPARENT_HUGE_PAGES,		//!< Transparent huge pages are requested.
+		EXPLICIT_HUGE_PAGES			//!< Huge pages are allocated from the system's reserved pool.
+	};
+
+	//! Indicates that the memory is not bound to a NUMA node.
+	static int const	ANY_NODE	= -1;
+
+	//! Constructor
+	explicit PageResource( HugePages hugePages = NO_HUGE_PAGES, int node = ANY_NODE );
+
+	//! Destructor
+	virtual ~PageResource();
+
+	//! Returns the NUMA node of the processor running the calling thread.
+	static int GetCurrentNode();
+
+protected:
+
+	//! @name Overrides std::pmr::memory_resource
+	//@{
+	virtual void * do_allocate( size_t bytes, size_t alignment );
+	virtual void do_deallocate( void * p, size_t bytes, size_t alignment );
+	virtual bool do_is_equal( std::pmr::memory_resource const & other ) const noexcept;
+	//@}
+
+private:
+
+	// Prevent copying
+	PageResource( PageResource const & );
+	PageResource & operator=( PageResource const & );
+
+	//! Returns the number of bytes actually allocated for an allocation of the given size.
+	size_t GetMappedSize( size_t bytes ) const;
+
+	HugePages	m_hugePages;	//!< The use of huge pages.
+	int			m_node;			//!< The NUMA node that the memory is bound to, or ANY_NODE.
+};
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! A memory resource that carves allocations out of large chunks.
+//
+//! Allocations are taken from the current chunk in order, and a new chunk is allocated from the upstream resource
+//! when the current chunk is full. Memory is not reused when it is deallocated; it is returned to the upstream
+//! resource when the arena is destroyed. This suits the weights of a net that is not trained, which are allocated
+//! once and kept until the net is destroyed. Each time a unit is trained, its weights may be copied into new memory,
+//! so an arena holding the weights of a net that is being trained grows without limit.
+//!
+//! The arena may be used by several threads concurrently.
+
+class ArenaResource : public std::pmr::memory_resource
+{
+public:
+
+	//! The default size of a chunk (the size of a huge page).
+	static size_t const	DEFAULT_CHUNK_SIZE	= 2 * 1024 * 1024;
+
+	//! Constructor
+	explicit ArenaResource( std::pmr::memory_resource * pUpstream = std::pmr::get_default_resource(),
+							size_t chunkSize = DEFAULT_CHUNK_SIZE,
+							size_t alignment = AlignedResource::DEFAULT_ALIGNMENT );
+
+	//! Destructor
+	virtual ~ArenaResource();
+
+protected:
+
+	//! @name Overrides std::pmr::memory_resource
+	//@{
+	virtual void * do_allocate( size_t bytes, size_t alignment );
+	virtual void do_deallocate( void * p, size_t bytes, size_t alignment );
+	virtual bool do_is_equal( std::pmr::memory_resource const & other ) const noexcept;
+	//@}
+
+private:
+
+	// Prevent copying
+	ArenaResource( ArenaResource const & );
+	ArenaResource & operator=( ArenaResource const & );
+
+	//! A chunk allocated from the upstream resource.
+	struct Chunk
+	{
+		void *	p;			//!< The memory.
+		size_t	size;		//!< The size of the chunk.
+		size_t	alignment;	//!< The alignment it was allocated with.
+	};
+
+	std::pmr::memory_resource *	m_pUpstream;	//!< The resource that provides the chunks.
+	size_t						m_chunkSize;	//!< The normal size of a chunk.
+	size_t						m_alignment;	//!< The minimum alignment of an allocation.
+	std::mutex					m_mutex;		//!< Guards the state below.
+	std::vector< Chunk >		m_aChunks;		//!< The chunks allocated so far.
+	char *						m_pNext;		//!< The next free byte in the current chunk.
+	char *						m_pEnd;			//!< The end of the current chunk.
+};
@@ -0,0 +1,139 @@
+/** @file *//********************************************************************************************************
+
+                                                   MetricsStream.h
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/MetricsStream.h#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#pragma once
+
+#include "SpscRing.h"
+
+#include <atomic>
+#include <functional>
+#include <iosfwd>
+#include <thread>
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Collects statistics from a net being trained without slowing the training.
+//
+//! A net publishes statistics about each training step to the stream (see NeuralNet::SetMetrics()). Publishing only
+//! copies the statistics into a lock-free ring, so the training thread never waits for a lock or for I/O. A
+//! background thread takes the statistics from the ring, combines the statistics of a number of steps into a summary,
+//! and passes the summary to an exporter, which may write it to a log, a file, or a monitoring system.
+//!
+//! If the background thread falls behind, the statistics of a step are dropped rather than making the training
+//! wait. The number of dropped steps is included in the summaries.
+//!
+//! @note	Statistics may be published by only one thread at a time, so a stream must not be shared by nets that are
+//!			trained concurrently.
+
+class MetricsStream
+{
+public:
+
+	//! The statistics of one training step.
+	struct Stats
+	{
+		float	loss;				//!< Half the sum of the squared errors.
+		float	gradientNorm;		//!< The Euclidean norm of the gradient of the loss with respect to the weights.
+		float	updateMagnitude;	//!< The Euclidean norm of the change to the weights.
+		float	saturation;			//!< The fraction of units whose outputs are in the flat tails of the sigmoid.
+
+		//! Constructor
+		Stats() : loss( 0.f ), gradientNorm( 0.f ), updateMagnitude( 0.f ), saturation( 0.f ) {}
+	};
+
+	//! The combined statistics of a number of consecutive steps.
+	struct Summary
+	{
+		long long	firstStep;				//!< The first step in the summary.
+		long long	lastStep;				//!< The last step in the summary.
+		int			nSteps;					//!< The number of steps whose statistics were received.
+		int			nDropped;				//!< The number of steps whose statistics were dropped.
+		float		meanLoss;				//!< The mean loss.
+		float		maxLoss;				//!< The largest loss.
+		float		meanGradientNorm;		//!< The mean gradient norm.
+		float		maxGradientNorm;		//!< The largest gradient norm.
+		float		meanUpdateMagnitude;	//!< The mean update magnitude.
+		float		meanSaturation;			//!< The mean saturation.
+	};
+
+	//! A function that exports a summary. It is called by the background thread.
+	typedef std::function< void ( Summary const & summary ) >	Exporter;
+
+	//! The default number of steps in a summary.
+	static int const	DEFAULT_STEPS_PER_SUMMARY	= 1000;
+
+	//! The default capacity of the ring.
+	static int const	DEFAULT_CAPACITY			= 4096;
+
+	//! The outputs of a saturated unit are within this distance of 0 or 1.
+	static float const	SATURATION_LIMIT;
+
+	//! Constructor
+	explicit MetricsStream( Exporter const & exporter, int stepsPerSummary = DEFAULT_STEPS_PER_SUMMARY,
+							int capacity = DEFAULT_CAPACITY );
+
+	//! Destructor
+	~MetricsStream();
+
+	//! Publishes the statistics of the next training step. Only the training thread may call this.
+	void Publish( Stats const & stats );
+
+	//! Returns true if the output of a sigmoid unit is saturated.
+	static bool IsSaturated( float output );
+
+private:
+
+	// Prevent copying
+	MetricsStream( MetricsStream const & );
+	MetricsStream & operator=( MetricsStream const & );
+
+	//! The statistics of a step and the number of the step.
+	struct Record
+	{
+		long long	step;		//!< The number of the step.
+		Stats		stats;		//!< The statistics.
+	};
+
+	//! The main loop of the background thread.
+	void Run();
+
+	//! Adds the statistics of a step to the summary.
+	void Accumulate( Record const & record );
+
+	//! Passes the summary to the exporter and starts a new summary.
+	void Export();
+
+	Exporter					m_exporter;				//!< Exports the summaries.
+	int							m_stepsPerSummary;		//!< The number of steps in a summary.
+	SpscRing< Record >			m_ring;					//!< The statistics waiting for the background thread.
+	std::atomic< long long >	m_nextStep;				//!< The number of the next step published.
+	std::atomic< bool >			m_bQuit;				//!< True if the background thread should exit.
+	long long					m_expectedStep;			//!< The step after the last one received.
+	Summary						m_summary;				//!< The summary being accumulated.
+	double						m_totalLoss;			//!< The sum of the losses in the summary.
+	double						m_totalGradientNorm;	//!< The sum of the gradient norms in the summary.
+	double						m_totalUpdateMagnitude;	//!< The sum of the update magnitudes in the summary.
+	double						m_totalSaturation;		//!< The sum of the saturations in the summary.
+	std::thread					m_thread;				//!< The background thread.
+};
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Inserts a summary into a stream.
+std::ostream & operator<<( std::ostream & out, MetricsStream::Summary const & summary );
@@ -0,0 +1,168 @@
+/** @file *//********************************************************************************************************
+
+                                                    ModelHandle.h
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/ModelHandle.h#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#pragma once
+
+#include "NeuralNet.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! A handle to a shared neural net that can be replaced while other threads are using it.
+//
+//! Threads that evaluate the net access it through a ModelHandle::Reader, which never locks or frees memory. A new net
+//! is installed with Publish(), or built on a background thread and installed with LoadAsync(). Readers that started
+//! before a net is replaced keep using the old net until they finish, and the old net is deleted by a background
+//! thread soon after the last of them finishes (epoch-based reclamation). A reader never sees a partially loaded net.
+//!
+//! Readers should evaluate the net with NeuralNet::Evaluate(), which does not change the net and so may be called
+//! concurrently.
+//!
+//! @note	At most MAX_READERS readers can be active at the same time. Additional readers wait for a free slot.
+
+class ModelHandle
+{
+public:
+
+	//! The maximum number of simultaneously active readers.
+	static int const	MAX_READERS	= 128;
+
+	//! A function that builds a net, returning 0 if it fails.
+	typedef std::function< std::unique_ptr< NeuralNet > () >	Builder;
+
+	//! Grants access to the current net for the lifetime of the reader.
+	class Reader
+	{
+	public:
+
+		//! Constructor
+		explicit Reader( ModelHandle & handle );
+
+		//! Destructor
+		~Reader();
+
+		//! Returns the net (or 0 if none has been published).
+		NeuralNet const * Get() const				{ return m_pModel; }
+
+		//! Returns the net.
+		NeuralNet const & operator*() const			{ return *m_pModel; }
+
+		//! Returns the net.
+		NeuralNet const * operator->() const		{ return m_pModel; }
+
+	private:
+
+		// Prevent copying
+		Reader( Reader const & );
+		Reader & operator=( Reader const & );
+
+		ModelHandle &		m_handle;		//!< The handle being read.
+		int					m_slot;			//!< Index of the slot announcing this reader.
+		NeuralNet const *	m_pModel;		//!< The net being read.
+	};
+
+	//! Constructor
+	ModelHandle();
+
+	//! Constructor
+	explicit ModelHandle( std::unique_ptr< NeuralNet > pModel );
+
+	//! Destructor
+	~ModelHandle();
+
+	//! Replaces the net.
+	void Publish( std::unique_ptr< NeuralNet > pModel );
+
+	//! Builds a new net on a background thread and then publishes it.
+	std::future< bool > LoadAsync( Builder const & build );
+
+	//! Extracts a new net from a file on a background thread and then publishes it.
+	template< class Net >
+	std::future< bool > LoadAsync( std::string const & path );
+
+private:
+
+	// Prevent copying
+	ModelHandle( ModelHandle const & );
+	ModelHandle & operator=( ModelHandle const & );
+
+	//! A reader's announcement of the epoch in which it started (or 0 if the slot is free).
+	struct alignas( 64 ) Slot
+	{
+		std::atomic< uint64_t >	epoch;		//!< The epoch, or 0 if the slot is free.
+	};
+
+	//! A replaced net waiting for the readers that might be using it to finish.
+	struct Retired
+	{
+		NeuralNet const *	pModel;		//!< The net.
+		uint64_t			epoch;		//!< The first epoch in which no new reader can see the net.
+	};
+
+	//! Deletes the retired nets that are no longer in use.
+	void Reclaim();
+
+	//! The main loop of the background thread. It deletes the retired nets once their readers have finished.
+	void RunReclaimer();
+
+	std::atomic< NeuralNet const * >	m_pModel;				//!< The current net.
+	std::atomic< uint64_t >				m_epoch;				//!< The current epoch.
+	Slot								m_aSlots[MAX_READERS];	//!< Announcements of the active readers.
+	std::mutex							m_publishMutex;			//!< Serializes publication and reclamation.
+	std::condition_variable				m_retiredChanged;		//!< Signals a retired net or m_bQuit.
+	std::vector< Retired >				m_aRetired;				//!< The replaced nets not yet deleted.
+	bool								m_bQuit;				//!< True if the background thread should exit.
+	std::thread							m_reclaimer;			//!< The background thread.
+};
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	path	Name of a file containing a net of type @a Net written with its stream insertion operator.
+//!
+//! @return		A future whose value is true if the net was loaded and published.
+
+template< class Net >
+std::future< bool > ModelHandle::LoadAsync( std::string const & path )
+{
+	return LoadAsync( [path] () -> std::unique_ptr< NeuralNet >
+	{
+		std::ifstream			in( path.c_str() );
+		std::unique_ptr< Net >	pNet( new Net );
+
+		in >> *pNet;
+
+		if ( !in )
+		{
+			return std::unique_ptr< NeuralNet >();
+		}
+
+		return std::unique_ptr< NeuralNet >( pNet.release() );
+	} );
+}
@@ -13,8 +13,15 @@
 
 #pragma once
 
+#include "Kernels.h"
 #include "NeuralNet.h"
 
+#include <cstdint>
+#include <functional>
+#include <string>
+
+class Autotuner;
+class ThreadPool;
 
 /********************************************************************************************************************/
 /*																													*/
@@ -29,9 +36,46 @@ class MultilayerFeedForward : public NeuralNet
 {
 	friend std::ostream & operator<<( std::ostream & out, MultilayerFeedForward const & mff );
 	friend std::istream & operator>>( std::istream & in, MultilayerFeedForward & mff );
+	friend class Validator;
 
 public:
 
+	//! A new value for one of the inputs.
+	struct InputChange
+	{
+		int		index;		//!< Index of the input.
+		float	value;		//!< The new value of the input.
+	};
+
+	//! A vector of input changes.
+	typedef std::vector< InputChange >	InputChangeVector;
+
+	//! The layers of the net.
+	enum Layer
+	{
+		HIDDEN_LAYER,		//!< The hidden units.
+		OUTPUT_LAYER		//!< The output units.
+	};
+
+	//! The changes to the weights computed for a batch of inputs.
+	//
+	//! The changes are the sums over the batch of the changes that Train() would make with a learning rate of 1
+	//! (that is, the negative gradient of the loss). They are computed by ComputeGradients() and applied by
+	//! ApplyGradients(). The changes to each layer are stored in one array, in the order of GetWeights(), so that they
+	//! can be combined with the changes computed by other processes.
+	struct Gradients
+	{
+		std::vector< float >	aHidden;				//!< The changes to the weights of the hidden units.
+		std::vector< float >	aOutput;				//!< The changes to the weights of the output units.
+		float					loss;					//!< The sum over the batch of half the squared errors.
+		OutputBatch				aHiddenOutputs;			//!< The outputs of the hidden units for each input.
+		OutputBatch				aHiddenDerivatives;		//!< The derivatives of the hidden units for each input.
+		OutputBatch				aOutputDeltas;			//!< The error terms of the output units for each input.
+	};
+
+	//! The default minimum number of weights in a layer for the layer to be processed in parallel.
+	static int const	DEFAULT_PARALLEL_THRESHOLD	= 64 * 1024;
+
 	//! Constructor
 	MultilayerFeedForward();
 
@@ -41,12 +85,103 @@ public:
 	//! Constructor
 	MultilayerFeedForward( int nInputs, int nHidden, int nOutputs, Neuron::WeightVector const & aWeights );
 
+	//! Copy constructor. The weights are shared until one of the nets is trained.
+	MultilayerFeedForward( MultilayerFeedForward const & ) = default;
+
+	//! Move constructor
+	MultilayerFeedForward( MultilayerFeedForward && ) = default;
+
 	//! Destructor
 	~MultilayerFeedForward();
 
+	//! Assignment operator. The weights are shared until one of the nets is trained.
+	MultilayerFeedForward & operator=( MultilayerFeedForward const & ) = default;
+
+	//! Move assignment operator
+	MultilayerFeedForward & operator=( MultilayerFeedForward && ) = default;
+
+	//! Returns the number of hidden units.
+	int GetHiddenCount() const							{ return (int)m_aHiddenUnits.size(); }
+
+	//! Returns a hidden unit.
+	Neuron const & GetHiddenUnit( int j ) const			{ return m_aHiddenUnits[j]; }
+
+	//! Returns an output unit.
+	Neuron const & GetOutputUnit( int i ) const			{ return m_aOutputUnits[i]; }
+
+	//! Enters or leaves inference-only mode.
+	void SetInferenceOnly( bool inferenceOnly );
+
+	//! Returns true if the net is in inference-only mode.
+	bool IsInferenceOnly() const						{ return m_bInferenceOnly; }
+
+	//! Freezes or unfreezes the weights of a layer.
+	void SetFrozen( Layer layer, bool frozen );
+
+	//! Returns true if the weights of a layer are frozen.
+	bool IsFrozen( Layer layer ) const
+	{
+		return ( layer == HIDDEN_LAYER ) ? m_bHiddenFrozen : m_bOutputFrozen;
+	}
+
+	//! Enters or leaves deterministic mode.
+	void SetDeterministic( bool deterministic );
+
+	//! Returns true if the net is in deterministic mode.
+	bool IsDeterministic() const						{ return m_bDeterministic; }
+
+	//! Enables or disables intra-layer parallelism.
+	void SetThreadPool( ThreadPool * pPool, int threshold = DEFAULT_PARALLEL_THRESHOLD );
+
+	//! Selects the kernel for each layer with an autotuner.
+	void SetAutotuner( Autotuner * pAutotuner );
+
+	//! Returns the weights of every unit.
+	Neuron::WeightVector GetWeights() const;
+
+	//! Computes the outputs of the hidden units for the given input without changing the net.
+	void EvaluateHidden( Neuron::InputVector const & aInputs, OutputVector & aHiddenOutputs ) const;
+
+	//! Computes the outputs for the given outputs of the hidden units without changing the net.
+	void EvaluateOutputs( float const * paHiddenOutputs, OutputVector & aOutputs ) const;
+
+	//! Computes the changes to the weights of the output units for a batch.
+	void ComputeOutputGradients( InputBatch const & aInputs, OutputBatch const & aTargets,
+								 Gradients & gradients ) const;
+
+	//! Computes the changes to the weights of the hidden units for a batch.
+	void ComputeHiddenGradients( InputBatch const & aInputs, Gradients & gradients ) const;
+
+	//! Computes the changes to all the weights for a batch.
+	void ComputeGradients( InputBatch const & aInputs, OutputBatch const & aTargets, Gradients & gradients ) const;
+
+	//! Applies changes to the weights.
+	void ApplyGradients( Gradients const & gradients, float rate );
+
+	//! Replaces the weights of every unit.
+	void SetWeights( Neuron::WeightVector const & aWeights );
+
+	//! Reads a net written by operator<<() from a text, in parallel.
+	bool ReadText( std::string const & text, ThreadPool * pPool = 0 );
+
+	//! Computes an output from the outputs of the hidden units.
+	OutputVector const & EvaluateFromHidden( float const * paHiddenOutputs );
+
+	//! Trains only the output layer by applying error values to the most recent evaluation.
+	void TrainOutputs( ErrorVector const & aErrors, float rate );
+
+	//! Computes an output for the most recent inputs with a few of them changed.
+	OutputVector const & operator()( InputChangeVector const & aChanges );
+
 	//! @name Overrides NeuralNet
 	//@{
 	virtual OutputVector const & operator()( Neuron::InputVector const & aInputs );
+	virtual void Evaluate( Neuron::InputVector const & aInputs, OutputVector & aOutputs ) const;
+	virtual void EvaluateBatch( InputBatch const & aInputs, OutputBatch & aOutputs ) const;
+	virtual void EvaluateSelected( Neuron::InputVector const & aInputs, IndexVector const & aIndexes,
+								   OutputVector & aOutputs ) const;
+	virtual void TopK( Neuron::InputVector const & aInputs, int k, RankedOutputVector & aBest ) const;
+	virtual void SetMemoryResource( std::pmr::memory_resource * pResource );
 	virtual void Train( Neuron::InputVector const & aInputs, ErrorVector const & aErrors, float rate );
 	//@}
 
@@ -58,11 +193,49 @@ private:
 	//! A vector of gradient values.
 	typedef std::vector< float >	GradientVector;
 
+	//! Calls a function for each tile of a layer's units, in parallel if the layer is large enough.
+	void ForEachUnit( int nUnits, int64_t nInputs, int tileSize,
+					  std::function< void ( int first, int last ) > const & f ) const;
+
+	//! Changes the shape of the net.
+	void Resize( int nInputs, int nHidden, int nOutputs );
+
+	//! Chooses the kernel for each layer.
+	void ConfigureKernels();
+
+	//! Stops using the thread pool, keeping the current kernels.
+	void ClearThreadPool()								{ m_pThreadPool = 0; }
+
+	//! Updates the outputs from the hidden outputs.
+	void UpdateOutputs();
+
+	//! Computes the combined inputs of a range of a layer's units for each sample of a batch.
+	static void ComputeBatchSums( KernelConfig const & kernel, Neuron const * paUnits, int first, int last, int size,
+								  InputBatch const & aInputs, OutputBatch & aSums );
+
+	//! Applies error values to the output layer.
+	void TrainOutputLayer( ErrorVector const & aErrors, float rate );
+
+	//! Publishes the statistics of the most recent training step.
+	void PublishMetrics( Neuron::InputVector const & aInputs, ErrorVector const & aErrors, float rate ) const;
+
+	Neuron::InputVector	m_aInputs;			//!< The most recent inputs.
 	UnitVector		m_aHiddenUnits;			//!< The array of hidden units.
+	OutputVector	m_aHiddenSums;			//!< The combined inputs to the hidden units for the most recent inputs.
+	bool			m_bHiddenSumsValid;		//!< True if m_aHiddenSums is consistent with the hidden weights.
 	OutputVector	m_aHiddenOutputs;		//!< The outputs from the hidden units (inputs to the output units).
 	GradientVector	m_aHiddenGradients;		//!< The gradients of the outputs from the hidden units.
 	UnitVector		m_aOutputUnits;			//!< The array of output units.
 	GradientVector	m_aOutputGradients;		//!< The gradients of the outputs from the output units.
+	bool			m_bInferenceOnly;		//!< If true, gradients are not computed (and the net cannot be trained).
+	bool			m_bHiddenFrozen;		//!< If true, the weights of the hidden units are not trained.
+	bool			m_bOutputFrozen;		//!< If true, the weights of the output units are not trained.
+	bool			m_bDeterministic;		//!< If true, the results do not depend on the thread pool or autotuner.
+	ThreadPool *	m_pThreadPool;			//!< The thread pool for processing large layers (or 0 if none).
+	int				m_parallelThreshold;	//!< The minimum number of weights in a layer to process it in parallel.
+	Autotuner *		m_pAutotuner;			//!< The autotuner choosing the kernels (or 0 if none).
+	KernelConfig	m_hiddenKernel;			//!< The kernel computing the combined inputs to the hidden units.
+	KernelConfig	m_outputKernel;			//!< The kernel computing the combined inputs to the output units.
 };
 
 
@@ -15,8 +15,11 @@
 
 #include "Neuron.h"
 
+#include <cstdint>
 #include <vector>
 
+class MetricsStream;
+
 
 /********************************************************************************************************************/
 /*																													*/
@@ -44,6 +47,25 @@ public:
 	//! A vector of error values.
 	typedef std::vector< float >	ErrorVector;
 
+	//! A batch of input vectors.
+	typedef std::vector< Neuron::InputVector >	InputBatch;
+
+	//! A batch of output vectors.
+	typedef std::vector< OutputVector >			OutputBatch;
+
+	//! A vector of output indexes.
+	typedef std::vector< int >					IndexVector;
+
+	//! An output value and its index.
+	struct RankedOutput
+	{
+		int		index;		//!< Index of the output.
+		float	value;		//!< Value of the output.
+	};
+
+	//! A vector of output values and their indexes.
+	typedef std::vector< RankedOutput >			RankedOutputVector;
+
 	//! Constructor
 	NeuralNet();
 
@@ -53,9 +75,27 @@ public:
 	//! @param	nOutputs	Number of outputs
 	NeuralNet( int nInputs, int nOutputs );
 
+	//! Copy constructor.
+	NeuralNet( NeuralNet const & ) = default;
+
+	//! Move constructor
+	NeuralNet( NeuralNet && ) = default;
+
 	//! Destructor
 	virtual ~NeuralNet();
 
+	//! Assignment operator.
+	NeuralNet & operator=( NeuralNet const & ) = default;
+
+	//! Move assignment operator
+	NeuralNet & operator=( NeuralNet && ) = default;
+
+	//! Returns the number of inputs.
+	int GetInputCount() const				{ return m_nInputs; }
+
+	//! Returns the number of outputs.
+	int GetOutputCount() const				{ return (int)m_aOutputs.size(); }
+
 	//! Computes an output for the given input.
 	//
 	//! @param	aInputs		The input values.
@@ -63,6 +103,83 @@ public:
 
 	virtual OutputVector const & operator()( Neuron::InputVector const & aInputs ) = 0;
 
+	//! Computes an output for the given input without changing the net.
+	//
+	//! Unlike operator(), this function does not save any state in the net, so it may be called concurrently by
+	//! several threads.
+	//!
+	//! @param	aInputs		The input values.
+	//! @param	aOutputs	Where to store the output values. The vector is resized to the number of outputs.
+
+	virtual void Evaluate( Neuron::InputVector const & aInputs, OutputVector & aOutputs ) const = 0;
+
+	//! Computes the outputs for a batch of inputs without changing the net.
+	//
+	//! The default implementation calls Evaluate() for each input. Nets override it to process the whole batch with
+	//! each unit before moving on to the next unit, so that each unit's weights are loaded only once per batch.
+	//!
+	//! @param	aInputs		The input vectors.
+	//! @param	aOutputs	Where to store the output vectors. The batch is resized to the number of inputs.
+
+	virtual void EvaluateBatch( InputBatch const & aInputs, OutputBatch & aOutputs ) const;
+
+	//! Computes only the selected outputs for the given input without changing the net.
+	//
+	//! Only the output units that are selected are evaluated, so this is much cheaper than Evaluate() when only a
+	//! few of many outputs are needed.
+	//!
+	//! @param	aInputs		The input values.
+	//! @param	aIndexes	Indexes of the outputs to compute.
+	//! @param	aOutputs	Where to store the selected outputs. aOutputs[k] is output aIndexes[k].
+
+	virtual void EvaluateSelected( Neuron::InputVector const & aInputs, IndexVector const & aIndexes,
+								   OutputVector & aOutputs ) const = 0;
+
+	//! Computes the largest outputs for the given input without changing the net.
+	//
+	//! The outputs are ranked by the combined inputs of the output units, which works because the activation
+	//! function is monotonic. The activation function is applied only to the @a k selected outputs, and the full set
+	//! of outputs is never stored.
+	//!
+	//! @param	aInputs		The input values.
+	//! @param	k			The number of outputs to return.
+	//! @param	aBest		Where to store the @a k largest outputs (or all of them, if there are fewer than @a k),
+	//!						largest first. Ties are ranked by index.
+
+	virtual void TopK( Neuron::InputVector const & aInputs, int k, RankedOutputVector & aBest ) const = 0;
+
+	//! Returns the index of the largest output for the given input without changing the net.
+	int ArgMax( Neuron::InputVector const & aInputs ) const;
+
+	//! Moves the weights to a different memory resource.
+	//
+	//! The weights of every unit are copied into memory allocated from @a pResource (see MemoryResources.h), so they
+	//! are no longer shared with copies of the net. Units added later (for example, by reading a net of a different
+	//! size from a stream) use the default memory resource.
+	//!
+	//! @param	pResource	The memory resource. It must outlive the net and its copies.
+
+	virtual void SetMemoryResource( std::pmr::memory_resource * pResource ) = 0;
+
+	//! Publishes statistics about each training step to a metrics stream.
+	//
+	//! The statistics are computed from values that Train() computes anyway, so publishing them costs much less than
+	//! the training itself. Copies of the net publish to the same stream, so only one of them may be trained while
+	//! the stream is set.
+	//!
+	//! @param	pMetrics	The stream, or 0 to stop publishing. It must outlive the training.
+
+	void SetMetrics( MetricsStream * pMetrics )	{ m_pMetrics = pMetrics; }
+
+	//! Returns the version of the weights.
+	//
+	//! The version changes whenever the weights change (for example, when the net is trained or extracted from a
+	//! stream), and versions are never reused, even by different nets. A copy of a net has the same version as the
+	//! original until one of them changes. So, a value computed from a net remains valid as long as the version of the
+	//! net is the same (see PredictionCache).
+
+	uint64_t GetVersion() const				{ return m_version; }
+
 	//! Trains the system by applying error values.
 	//
 	//!
@@ -75,10 +192,21 @@ public:
 
 protected:
 
+	//! Adds a candidate to the @a k best outputs found so far.
+	static void AddCandidate( RankedOutputVector & aBest, int k, int index, float x );
+
+	//! Sorts the @a k best outputs and converts their combined inputs to outputs.
+	static void FinishCandidates( RankedOutputVector & aBest, Neuron const & unit );
+
+	//! Gives the weights a new version.
+	void UpdateVersion();
+
 	int				m_nInputs;				//!< The number of inputs to the net.
 	OutputVector	m_aOutputs;				//!< The outputs from most recent set of inputs.
 											//!< @note The size of the vector is the number of outputs from the
 											//!< net.
+	MetricsStream *	m_pMetrics;				//!< Where the training statistics are published (or 0 if none).
+	uint64_t		m_version;				//!< The version of the weights (see GetVersion()).
 };
 
 
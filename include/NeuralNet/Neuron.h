@@ -13,6 +13,9 @@
 
 #pragma once
 
+#include <iosfwd>
+#include <memory>
+#include <memory_resource>
 #include <vector>
 
 /********************************************************************************************************************/
@@ -21,6 +24,12 @@
 
 //! A neural network neuron
 //
+//! The weights are shared by copies of a neuron until one of the copies changes them (copy-on-write), so copying a
+//! neuron, or a net made of neurons, does not copy any weights.
+//!
+//! The weights are allocated from a memory resource, which is the default memory resource unless another is set
+//! with SetMemoryResource(). The weights stay in the same memory resource when they are replaced or copied.
+//!
 //! Source: Russell S. and Norvig P. 1995. <em>Artificial Intelligence: A Modern Approach</em>. Prentice Hall,
 //!			Upper Saddle River, N.J. 567-570
 
@@ -34,6 +43,9 @@ public:
 	//! A vector of weights.
 	typedef std::vector< float >	WeightVector;
 
+	//! The weights of a neuron, as they are stored (in the neuron's memory resource).
+	typedef std::pmr::vector< float >	WeightStorage;
+
 	//! A vector of inputs.
 	typedef std::vector< float >	InputVector;
 
@@ -46,12 +58,30 @@ public:
 	//! Constructor
 	Neuron( WeightVector const & aWeights );
 
+	//! Copy constructor. The weights are shared until one of the neurons changes them.
+	Neuron( Neuron const & ) = default;
+
+	//! Move constructor
+	Neuron( Neuron && ) = default;
+
 	// Destructor
 	virtual ~Neuron();
 
+	//! Assignment operator. The weights are shared until one of the neurons changes them.
+	Neuron & operator=( Neuron const & ) = default;
+
+	//! Move assignment operator
+	Neuron & operator=( Neuron && ) = default;
+
 	//! Initializes the neuron.
 	void Initialize( WeightVector const & aWeights );
 
+	//! Moves the weights to a different memory resource.
+	void SetMemoryResource( std::pmr::memory_resource * pResource );
+
+	//! Returns the memory resource holding the weights.
+	std::pmr::memory_resource * GetMemoryResource() const	{ return m_pWeights->get_allocator().resource(); }
+
 	//! Converts inputs to an output.
 	float operator()( InputVector const & aInputs ) const;
 
@@ -61,10 +91,11 @@ public:
 	//! Adjusts the weights for each input.
 	void AdjustWeights( InputVector const & aInputs, float e, float rate );
 
-	//! Returns the input weights.
-	WeightVector const & GetWeights() const				{ return m_aWeights; };
+	//! Adds changes to the weights.
+	void AdjustWeights( float const * paChanges, float rate );
 
-private:
+	//! Returns the input weights.
+	WeightStorage const & GetWeights() const			{ return *m_pWeights; };
 
 	//! The activation function.
 	float Activation( float x ) const;
@@ -75,6 +106,11 @@ private:
 	//! The input function.
 	float Input( InputVector const & aInputs ) const;
 
+private:
+
+	//! Makes sure the weights are not shared so that they can be changed.
+	void Unshare();
+
 	//! The step function for use as an activation function.
 	static float Step( float x );
 
@@ -87,7 +123,7 @@ private:
 	//! The sigmoid function for use as an activation function (supporting back-propagation).
 	static float Sigmoid( float x, float * pd );
 
-	WeightVector	m_aWeights;		//!< Input weights.
+	std::shared_ptr< WeightStorage >	m_pWeights;		//!< Input weights (possibly shared with copies of this neuron).
 };
 
 
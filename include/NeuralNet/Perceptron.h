@@ -46,12 +46,36 @@ public:
 	//! Constructor
 	Perceptron( int nInputs, int nOutputs, Neuron::WeightVector const & aWeights );
 
+	//! Copy constructor. The weights are shared until one of the nets is trained.
+	Perceptron( Perceptron const & ) = default;
+
+	//! Move constructor
+	Perceptron( Perceptron && ) = default;
+
 	//! Destructor
 	~Perceptron();
 
+	//! Assignment operator. The weights are shared until one of the nets is trained.
+	Perceptron & operator=( Perceptron const & ) = default;
+
+	//! Move assignment operator
+	Perceptron & operator=( Perceptron && ) = default;
+
+	//! Returns the weights of every unit.
+	Neuron::WeightVector GetWeights() const;
+
+	//! Returns an output unit.
+	Neuron const & GetOutputUnit( int i ) const			{ return m_aOutputUnits[i]; }
+
 	//! @name Overrides NeuralNet
 	//@{
 	virtual OutputVector const & operator()( Neuron::InputVector const & aInputs );
+	virtual void Evaluate( Neuron::InputVector const & aInputs, OutputVector & aOutputs ) const;
+	virtual void EvaluateBatch( InputBatch const & aInputs, OutputBatch & aOutputs ) const;
+	virtual void EvaluateSelected( Neuron::InputVector const & aInputs, IndexVector const & aIndexes,
+								   OutputVector & aOutputs ) const;
+	virtual void TopK( Neuron::InputVector const & aInputs, int k, RankedOutputVector & aBest ) const;
+	virtual void SetMemoryResource( std::pmr::memory_resource * pResource );
 	virtual void Train( Neuron::InputVector const & aInputs, ErrorVector const & aErrors, float rate );
 	//@}
 
@@ -60,6 +84,9 @@ private:
 	//! A vector of units.
 	typedef std::vector< Neuron >	UnitVector;
 
+	//! Publishes the statistics of the most recent training step.
+	void PublishMetrics( Neuron::InputVector const & aInputs, ErrorVector const & aErrors, float rate ) const;
+
 	UnitVector	m_aOutputUnits;			//!< The array of neurons.
 };
 
@@ -0,0 +1,139 @@
+/** @file *//********************************************************************************************************
+
+                                                  PredictionCache.h
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/PredictionCache.h#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#pragma once
+
+#include "NeuralNet.h"
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Remembers the outputs of a net for recently evaluated inputs.
+//
+//! When the same inputs are evaluated again and again (for example, the states of a game, many of which recur),
+//! most evaluations can be skipped by looking up the outputs computed earlier. The cache holds a bounded number of
+//! inputs, and the least recently used input is forgotten to make room for a new one.
+//!
+//! Inputs are looked up by a hash of their values. If a quantum is given, each value is rounded to a multiple of the
+//! quantum first, so inputs that differ by less than the quantum usually share an entry (and get the outputs of the
+//! input that was evaluated first). Otherwise, only identical inputs share an entry.
+//!
+//! The cache is split into shards, each with its own lock, so that many threads can use it at once. The entries are
+//! forgotten automatically when the weights of the net change (see NeuralNet::GetVersion()), so the cache never
+//! returns outputs computed with old weights.
+//!
+//! For example:
+//!
+//! @code
+//!		PredictionCache	cache( net );
+//!
+//!		cache.Evaluate( aInputs, aOutputs );	// Evaluates the net
+//!		cache.Evaluate( aInputs, aOutputs );	// Returns the same outputs without evaluating the net
+//!
+//!		float const	hitRate	= cache.GetStatistics().GetHitRate();
+//! @endcode
+//!
+//! @note	The net must not be changed while another thread is using the cache.
+
+class PredictionCache
+{
+public:
+
+	//! The default maximum number of inputs in the cache.
+	static int const	DEFAULT_CAPACITY	= 4096;
+
+	//! The number of shards.
+	static int const	NUM_SHARDS			= 16;
+
+	//! Counts of the lookups.
+	struct Statistics
+	{
+		long long	nHits;			//!< The number of lookups that found the outputs in the cache.
+		long long	nMisses;		//!< The number of lookups that evaluated the net.
+		long long	nEvictions;		//!< The number of inputs forgotten to make room for new ones.
+		long long	nInvalidations;	//!< The number of times a shard was emptied because the net changed.
+
+		//! Returns the fraction of the lookups that found the outputs in the cache.
+		float GetHitRate() const
+		{
+			return ( nHits + nMisses > 0 ) ? (float)nHits / (float)( nHits + nMisses ) : 0.f;
+		}
+	};
+
+	//! Constructor
+	PredictionCache( NeuralNet const & net, int capacity = DEFAULT_CAPACITY, float quantum = 0.f );
+
+	//! Destructor
+	~PredictionCache();
+
+	//! Computes the outputs for the given inputs, or finds them in the cache.
+	void Evaluate( Neuron::InputVector const & aInputs, NeuralNet::OutputVector & aOutputs );
+
+	//! Forgets all the inputs.
+	void Clear();
+
+	//! Returns the counts of the lookups since the cache was constructed or the statistics were reset.
+	Statistics GetStatistics() const;
+
+	//! Resets the counts of the lookups.
+	void ResetStatistics();
+
+private:
+
+	// Prevent copying
+	PredictionCache( PredictionCache const & );
+	PredictionCache & operator=( PredictionCache const & );
+
+	//! The key of an input. Each value is the bit pattern of an input value or of its quantized value.
+	typedef std::vector< uint32_t >	Key;
+
+	//! An input and its outputs.
+	struct Entry
+	{
+		uint64_t				hash;		//!< The hash of the key.
+		Key						key;		//!< The key of the input.
+		NeuralNet::OutputVector	aOutputs;	//!< The outputs.
+	};
+
+	//! The entries of a shard, most recently used first.
+	typedef std::list< Entry >	EntryList;
+
+	//! The entries of a shard by the hashes of their keys.
+	typedef std::unordered_map< uint64_t, EntryList::iterator >	EntryIndex;
+
+	//! A part of the cache with its own lock.
+	struct alignas( 64 ) Shard
+	{
+		mutable std::mutex	mutex;			//!< Guards the shard.
+		EntryList			entries;		//!< The entries, most recently used first.
+		EntryIndex			index;			//!< The entries by the hashes of their keys.
+		uint64_t			version;		//!< The version of the net for the entries.
+		Statistics			statistics;		//!< The counts of the lookups in the shard.
+	};
+
+	//! Computes the key of an input and returns its hash.
+	uint64_t MakeKey( Neuron::InputVector const & aInputs, Key & key ) const;
+
+	NeuralNet const &	m_net;					//!< The net.
+	int					m_shardCapacity;		//!< The maximum number of entries in a shard.
+	float				m_quantum;				//!< The quantum, or 0 if the inputs are not quantized.
+	Shard				m_aShards[NUM_SHARDS];	//!< The shards.
+};
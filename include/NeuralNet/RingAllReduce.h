@@ -0,0 +1,115 @@
+/** @file *//********************************************************************************************************
+
+                                                   RingAllReduce.h
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/RingAllReduce.h#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Sums arrays across a group of processes connected in a ring.
+//
+//! Each process (a <em>rank</em>) connects to the next rank in the ring and accepts a connection from the previous
+//! one. An array is summed in two phases. In the reduce-scatter phase, the array is split into one chunk per rank,
+//! and each chunk travels once around the ring, with each rank adding its values to it, until every rank holds the
+//! complete sum of one chunk. In the all-gather phase, the complete chunks travel around the ring again. Each rank
+//! sends and receives about twice the size of the array in total, no matter how many ranks there are, so the time
+//! taken is limited by the bandwidth of a single link rather than by the number of ranks.
+//!
+//! Every rank ends up with exactly the same sums, so nets trained with them stay identical.
+//!
+//! An address is either <tt>host:port</tt> for a TCP socket or <tt>unix:path</tt> for a Unix domain socket. Several
+//! processes on one machine can be connected through the loopback interface or through Unix domain sockets.
+//!
+//! Sums are done in order by a background thread, so SumAsync() can overlap the communication with other work.
+//! Every rank must request the same sequence of sums, with the same sizes.
+//!
+//! @note	The ranks must use the same representation of @c float. Sockets are supported on POSIX systems only.
+
+class RingAllReduce
+{
+public:
+
+	//! The default time allowed for connecting to the other ranks, in milliseconds.
+	static int const	DEFAULT_TIMEOUT	= 30 * 1000;
+
+	//! Constructor
+	RingAllReduce( int rank, std::vector< std::string > const & aAddresses );
+
+	//! Destructor
+	~RingAllReduce();
+
+	//! Connects to the neighboring ranks.
+	bool Connect( int timeout = DEFAULT_TIMEOUT );
+
+	//! Returns the index of this process in the ring.
+	int GetRank() const								{ return m_rank; }
+
+	//! Returns the number of processes in the ring.
+	int GetSize() const								{ return (int)m_aAddresses.size(); }
+
+	//! Replaces the values in an array with their sums over all the ranks.
+	bool Sum( float * paValues, int n );
+
+	//! Starts replacing the values in an array with their sums over all the ranks.
+	std::future< bool > SumAsync( float * paValues, int n );
+
+private:
+
+	// Prevent copying
+	RingAllReduce( RingAllReduce const & );
+	RingAllReduce & operator=( RingAllReduce const & );
+
+	//! A requested sum.
+	struct Job
+	{
+		float *					paValues;	//!< The array.
+		int						n;			//!< The number of values in the array.
+		std::promise< bool >	result;		//!< Receives true if the sum succeeded.
+	};
+
+	//! Sums an array across the ranks.
+	bool Reduce( float * paValues, int n );
+
+	//! Sends data to the next rank while receiving data from the previous rank.
+	bool Exchange( void const * pSend, size_t sendSize, void * pReceive, size_t receiveSize );
+
+	//! Closes the sockets.
+	void Close();
+
+	//! The main loop of the background thread.
+	void Run();
+
+	int							m_rank;			//!< The index of this process in the ring.
+	std::vector< std::string >	m_aAddresses;	//!< The address of each rank.
+	int							m_listener;		//!< The socket accepting the connection from the previous rank.
+	int							m_next;			//!< The socket connected to the next rank.
+	int							m_previous;		//!< The socket connected to the previous rank.
+	bool						m_bConnected;	//!< True if the ring is connected.
+	bool						m_bFailed;		//!< True if a sum failed, leaving the ring out of step.
+	std::vector< float >		m_aReceived;	//!< The chunk being received in the reduce-scatter phase.
+	std::mutex					m_mutex;		//!< Guards the state below.
+	std::condition_variable		m_changed;		//!< Signals a change in the state below.
+	std::deque< Job >			m_jobs;			//!< The sums waiting to be done.
+	bool						m_bQuit;		//!< True if the background thread should exit.
+	std::thread					m_thread;		//!< The background thread.
+};
@@ -0,0 +1,146 @@
+/** @file *//********************************************************************************************************
+
+                                                     SpscRing.h
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/SpscRing.h#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! A bounded, lock-free queue with a single producer and a single consumer.
+//
+//! One thread pushes values into the ring and one other thread pops them. Neither ever waits for the other: Push()
+//! fails if the ring is full and Pop() fails if it is empty. The positions of the producer and the consumer are on
+//! separate cache lines, and each side keeps a copy of the other side's position that it refreshes only when the
+//! ring appears to be full (or empty), so the two threads rarely touch the same cache line.
+//!
+//! @param	T	The type of the values. It must be default-constructible and copyable.
+
+template< class T >
+class SpscRing
+{
+public:
+
+	//! Constructor
+	explicit SpscRing( int capacity );
+
+	//! Adds a value to the ring. Only the producer thread may call this.
+	bool Push( T const & value );
+
+	//! Removes the oldest value from the ring. Only the consumer thread may call this.
+	bool Pop( T & value );
+
+	//! Returns the maximum number of values in the ring.
+	int GetCapacity() const							{ return (int)m_aValues.size(); }
+
+private:
+
+	// Prevent copying
+	SpscRing( SpscRing const & );
+	SpscRing & operator=( SpscRing const & );
+
+	//! The size of a cache line.
+	static size_t const	CACHE_LINE_SIZE	= 64;
+
+	std::vector< T >	m_aValues;			//!< The values. The size is a power of 2.
+	size_t				m_mask;				//!< The size of m_aValues minus 1.
+
+	alignas( CACHE_LINE_SIZE ) std::atomic< size_t >	m_tail;			//!< The number of values pushed.
+	size_t												m_cachedHead;	//!< The producer's copy of m_head.
+
+	alignas( CACHE_LINE_SIZE ) std::atomic< size_t >	m_head;			//!< The number of values popped.
+	size_t												m_cachedTail;	//!< The consumer's copy of m_tail.
+};
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	capacity	The maximum number of values in the ring. It must be a power of 2.
+
+template< class T >
+SpscRing< T >::SpscRing( int capacity )
+	: m_aValues( capacity ),
+	m_mask( capacity - 1 ),
+	m_tail( 0 ),
+	m_cachedHead( 0 ),
+	m_head( 0 ),
+	m_cachedTail( 0 )
+{
+	assert( capacity > 0 && ( capacity & ( capacity - 1 ) ) == 0 );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	value	The value to add.
+//!
+//! @return		True if the value was added, or false if the ring is full.
+
+template< class T >
+bool SpscRing< T >::Push( T const & value )
+{
+	size_t const	tail	= m_tail.load( std::memory_order_relaxed );
+
+	if ( tail - m_cachedHead == m_aValues.size() )
+	{
+		m_cachedHead = m_head.load( std::memory_order_acquire );
+		if ( tail - m_cachedHead == m_aValues.size() )
+		{
+			return false;
+		}
+	}
+
+	m_aValues[tail & m_mask] = value;
+	m_tail.store( tail + 1, std::memory_order_release );
+
+	return true;
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	value	Where to store the value.
+//!
+//! @return		True if a value was removed, or false if the ring is empty.
+
+template< class T >
+bool SpscRing< T >::Pop( T & value )
+{
+	size_t const	head	= m_head.load( std::memory_order_relaxed );
+
+	if ( head == m_cachedTail )
+	{
+		m_cachedTail = m_tail.load( std::memory_order_acquire );
+		if ( head == m_cachedTail )
+		{
+			return false;
+		}
+	}
+
+	value = m_aValues[head & m_mask];
+	m_head.store( head + 1, std::memory_order_release );
+
+	return true;
+}
@@ -0,0 +1,53 @@
+/** @file *//********************************************************************************************************
+
+                                                    TextFormat.h
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/TextFormat.h#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Functions for reading and writing floats as text exactly and quickly.
+//
+//! A float is written as the shortest text that reads back as exactly the same float, so a net written as text and
+//! read back is identical to the original. The functions do not depend on the locale, and they read and write whole
+//! buffers instead of one formatted value at a time. A large text can be parsed by several threads.
+//!
+//! The text of a float is the same as printf's @c %g format when that is shortest (for example, "0.1", "-2.5e-07"
+//! or "inf"). The text written by the stream operators of earlier versions is read as before.
+//!
+//! @{
+
+//! The maximum number of characters written by FormatFloat().
+int const	MAX_FLOAT_TEXT_SIZE	= 16;
+
+//! Writes the shortest text that reads back as the same float.
+char * FormatFloat( float x, char * pText );
+
+//! Reads a float from a stream.
+std::istream & ReadFloat( std::istream & in, float & x );
+
+//! Reads whitespace-separated floats from a buffer.
+bool ParseFloats( char const * pBegin, char const * pEnd, std::vector< float > & aValues );
+
+//! Reads whitespace-separated floats from a text, in parallel.
+bool ParseFloats( std::string const & text, std::vector< float > & aValues, ThreadPool * pPool );
+
+//! @}
@@ -0,0 +1,96 @@
+/** @file *//********************************************************************************************************
+
+                                                    ThreadPool.h
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/ThreadPool.h#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! A work-stealing thread pool for splitting a loop across cores.
+//
+//! ParallelFor() splits a range of indexes into tiles and deals them out in contiguous runs to a queue for each
+//! thread. A thread takes tiles from the back of its own queue and, when its queue is empty, steals tiles from the
+//! front of the other queues. The calling thread processes tiles too, and ParallelFor() does not return until every
+//! tile has been processed.
+//!
+//! @note	Calls to ParallelFor() from different threads are serialized. A call from inside a function that the pool is
+//!			running is run serially on the calling thread.
+
+class ThreadPool
+{
+public:
+
+	//! A function that processes the indexes in the range [@a first, @a last).
+	typedef std::function< void ( int first, int last ) >	RangeFunction;
+
+	//! Constructor
+	explicit ThreadPool( int nThreads = 0 );
+
+	//! Destructor
+	~ThreadPool();
+
+	//! Returns the number of threads that process tiles (including the calling thread).
+	int GetThreadCount() const						{ return (int)m_aThreads.size() + 1; }
+
+	//! Calls a function for each tile of a range of indexes.
+	void ParallelFor( int n, int tileSize, RangeFunction const & f );
+
+private:
+
+	// Prevent copying
+	ThreadPool( ThreadPool const & );
+	ThreadPool & operator=( ThreadPool const & );
+
+	//! A range of indexes.
+	struct Tile
+	{
+		int		first;		//!< The first index.
+		int		last;		//!< One past the last index.
+	};
+
+	//! A queue of tiles owned by one thread.
+	struct Queue
+	{
+		std::mutex			mutex;		//!< Guards the queue.
+		std::vector< Tile >	aTiles;		//!< The tiles.
+		int					head;		//!< Index of the first unclaimed tile.
+		int					tail;		//!< One past the index of the last unclaimed tile.
+	};
+
+	//! The main loop of a worker thread.
+	void Run( int index );
+
+	//! Processes one tile, stealing it from another queue if necessary. Returns false if there are none left.
+	bool ProcessTile( int index );
+
+	std::vector< std::thread >					m_aThreads;			//!< The worker threads.
+	std::vector< std::unique_ptr< Queue > >		m_apQueues;			//!< A queue for each worker and one for the caller.
+	RangeFunction const *						m_pFunction;		//!< The function being applied.
+	std::atomic< int >							m_nRemaining;		//!< The number of tiles not yet processed.
+	std::mutex									m_callMutex;		//!< Serializes calls to ParallelFor().
+	std::mutex									m_mutex;			//!< Guards the state below.
+	std::condition_variable						m_start;			//!< Signals the workers that tiles are ready.
+	std::condition_variable						m_finished;			//!< Signals the caller that all tiles are done.
+	unsigned									m_generation;		//!< Incremented by each call to ParallelFor().
+	bool										m_bQuit;			//!< True if the workers should exit.
+};
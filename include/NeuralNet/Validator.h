@@ -0,0 +1,182 @@
+/** @file *//********************************************************************************************************
+
+                                                     Validator.h
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/Validator.h#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+#pragma once
+
+#include "Evaluator.h"
+#include "NeuralNet.h"
+
+#include <condition_variable>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class MultilayerFeedForward;
+class ThreadPool;
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! Validates a net while it is being trained, without stopping the training.
+//
+//! The training loop passes the net to Validate() after each step. At a fixed interval, Validate() makes a copy of
+//! the net, which is cheap because the copy shares the weights with the original until the original is trained (see
+//! Neuron). The copy is then evaluated over the validation set by a background thread (and the threads of a thread
+//! pool, if one is given) while the training continues. The copy with the best score so far is kept, and training
+//! should stop once the score has not improved for a number of validations (early stopping).
+//!
+//! If a snapshot is still waiting to be validated when the next one is made, the waiting snapshot is skipped, so the
+//! validation never holds back the training or holds more than two snapshots.
+//!
+//! For example:
+//!
+//! @code
+//!		Validator	validator( aValidationInputs, aValidationTargets, Validator::CLASSIFICATION_ERROR, 1000 );
+//!
+//!		for ( long long step = 1; !validator.Validate( net, step ); step++ )
+//!		{
+//!			... train the net ...
+//!		}
+//!
+//!		validator.Wait();
+//!		std::shared_ptr< NeuralNet const >	pBest	= validator.GetBest();
+//! @endcode
+
+class Validator
+{
+public:
+
+	//! How a net is scored. A lower score is better.
+	enum Criterion
+	{
+		MEAN_SQUARED_ERROR,		//!< The mean of the squared errors of all the outputs.
+		CLASSIFICATION_ERROR	//!< The fraction of samples whose largest output is not the largest target.
+	};
+
+	//! The score of a validated snapshot.
+	struct Result
+	{
+		long long	step;		//!< The training step at which the snapshot was made, or -1 if there is none.
+		float		score;		//!< The score.
+
+		//! Constructor
+		Result( long long step_ = -1, float score_ = std::numeric_limits< float >::max() )
+			: step( step_ ), score( score_ ) {}
+	};
+
+	//! The default number of validations without improvement after which training should stop.
+	static int const	DEFAULT_PATIENCE	= 10;
+
+	//! Constructor
+	Validator( NeuralNet::InputBatch const & aInputs, NeuralNet::OutputBatch const & aTargets,
+			   Criterion criterion = MEAN_SQUARED_ERROR, int interval = 1, int patience = DEFAULT_PATIENCE,
+			   ThreadPool * pPool = 0 );
+
+	//! Destructor
+	~Validator();
+
+	//! Validates a snapshot of the net in the background if the step is at the interval.
+	template< class Net >
+	bool Validate( Net const & net, long long step );
+
+	//! Waits until every snapshot made so far has been validated.
+	void Wait();
+
+	//! Returns true if the score has not improved for the number of validations given by the patience.
+	bool ShouldStop() const;
+
+	//! Returns the best result so far.
+	Result GetBestResult() const;
+
+	//! Returns the snapshot with the best score so far (or 0 if none has been validated).
+	std::shared_ptr< NeuralNet const > GetBest() const;
+
+	//! Returns the latest result.
+	Result GetLatestResult() const;
+
+	//! Returns the number of snapshots that were skipped because the validation fell behind.
+	int GetSkippedCount() const;
+
+	//! Computes the score of a net over the validation set.
+	float Score( NeuralNet const & net ) const;
+
+private:
+
+	// Prevent copying
+	Validator( Validator const & );
+	Validator & operator=( Validator const & );
+
+	//! A snapshot of a net.
+	typedef std::shared_ptr< NeuralNet const >	Snapshot;
+
+	//! Prepares a snapshot for evaluation by the validator.
+	static void Detach( NeuralNet & /* net */ )		{}
+
+	//! Prepares a snapshot for evaluation by the validator.
+	static void Detach( MultilayerFeedForward & net );
+
+	//! Queues a snapshot to be validated.
+	void Enqueue( Snapshot const & pSnapshot, long long step );
+
+	//! The main loop of the background thread.
+	void Run();
+
+	NeuralNet::InputBatch					m_aInputs;			//!< The validation inputs.
+	NeuralNet::OutputBatch					m_aTargets;			//!< The validation targets.
+	Criterion								m_criterion;		//!< How a net is scored.
+	int										m_interval;			//!< The number of steps between snapshots.
+	int										m_patience;			//!< Validations without improvement before stopping.
+	Evaluator								m_evaluator;		//!< Evaluates the validation set.
+	mutable std::mutex						m_mutex;			//!< Guards the state below.
+	std::condition_variable					m_changed;			//!< Signals a change in the state below.
+	Snapshot								m_pPending;			//!< The snapshot waiting to be validated.
+	long long								m_pendingStep;		//!< The step at which m_pPending was made.
+	bool									m_bValidating;		//!< True if a snapshot is being validated.
+	bool									m_bQuit;			//!< True if the background thread should exit.
+	Snapshot								m_pBest;			//!< The snapshot with the best score.
+	Result									m_best;				//!< The result of m_pBest.
+	Result									m_latest;			//!< The result of the latest validation.
+	int										m_nSinceBest;		//!< The number of validations since the best.
+	int										m_nSkipped;			//!< The number of snapshots skipped.
+	std::thread								m_thread;			//!< The background thread.
+};
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! The training is not held up: only a copy of the net is made on the calling thread.
+//!
+//! @param	net		The net. @a Net must be derived from NeuralNet and be copyable.
+//! @param	step	The number of training steps done. A snapshot is made when it is a multiple of the interval.
+//!
+//! @return		True if training should stop (see ShouldStop()).
+
+template< class Net >
+bool Validator::Validate( Net const & net, long long step )
+{
+	if ( step % m_interval == 0 )
+	{
+		std::shared_ptr< Net > const	pSnapshot	= std::make_shared< Net >( net );
+
+		Detach( *pSnapshot );
+		Enqueue( pSnapshot, step );
+	}
+
+	return ShouldStop();
+}
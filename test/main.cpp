@@ -11,19 +11,80 @@
 
  ********************************************************************************************************************/
 
+#include "../ActivationCache.h"
+#include "../Autotuner.h"
+#include "../BinaryNet.h"
+#include "../Checkpointer.h"
+#include "../CodeGenerator.h"
+#include "../Distiller.h"
+#include "../DistributedTrainer.h"
+#include "../Ensemble.h"
+#include "../Evaluator.h"
+#include "../InferencePipeline.h"
+#include "../InferenceScheduler.h"
+#include "../LowRankNet.h"
+#include "../MemoryResources.h"
+#include "../MetricsStream.h"
+#include "../ModelHandle.h"
+#include "../MultilayerFeedForward.h"
 #include "../Perceptron.h"
+#include "../PredictionCache.h"
+#include "../RingAllReduce.h"
+#include "../SpscRing.h"
+#include "../ThreadPool.h"
+#include "../Validator.h"
 
 #include "Misc/Random.h"
 #include "Misc/Etc.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <cassert>
 #include <iostream>
+#include <limits>
+#include <sstream>
 #include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if !defined( _WIN32 )
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 static void TestPerceptron();
 static void TestMFF();
+static void TestIncrementalMFF();
+static void TestBinaryNet();
+static void TestDistributedTraining();
+static void TestLowRankNet();
+static void TestDeterministicMFF();
+static void TestTextSerialization();
+static void TestDistiller();
+static void TestPredictionCache();
+static void TestEvaluator();
+static void TestThreadPool();
+static void TestEnsemble();
+static void TestModelHandle();
+static void TestInferenceScheduler();
+static void TestInferenceOnly();
+static void TestSelectedOutputs();
+static void TestCodeGenerator();
+static void TestMemoryResources();
+static void TestCheckpointer();
+static void TestSpscRing();
+static void TestMetricsStream();
+static void TestValidator();
+static void TestActivationCache();
+static void TestInferencePipeline();
+static void TestAutotuner();
+static void TestCopyOnWrite();
 
 Random	rnd( 1 );
 
@@ -38,6 +99,56 @@ void main( int argc, char ** argv )
 	TestPerceptron();
 
 	TestMFF();
+
+	TestIncrementalMFF();
+
+	TestBinaryNet();
+
+	TestDistributedTraining();
+
+	TestLowRankNet();
+
+	TestDeterministicMFF();
+
+	TestTextSerialization();
+
+	TestDistiller();
+
+	TestPredictionCache();
+
+	TestEvaluator();
+
+	TestThreadPool();
+
+	TestEnsemble();
+
+	TestModelHandle();
+
+	TestInferenceScheduler();
+
+	TestInferenceOnly();
+
+	TestSelectedOutputs();
+
+	TestCodeGenerator();
+
+	TestMemoryResources();
+
+	TestCheckpointer();
+
+	TestSpscRing();
+
+	TestMetricsStream();
+
+	TestValidator();
+
+	TestActivationCache();
+
+	TestInferencePipeline();
+
+	TestAutotuner();
+
+	TestCopyOnWrite();
 }
 
 
@@ -126,3 +237,2300 @@ static void TestMFF()
 	Neuron::InputVector	Conditions( NUM_CONDITIONS );
 
 }
+
+
+/********************************************************************************************************************/
+/*																													*/
+/*																													*/
+/********************************************************************************************************************/
+
+static void TestIncrementalMFF()
+{
+	int const	NUM_INPUTS	= 64;
+	int const	NUM_HIDDEN	= 16;
+	int const	NUM_OUTPUTS	= 4;
+
+	Neuron::WeightVector	aWeights( ( NUM_INPUTS + NUM_OUTPUTS ) * NUM_HIDDEN );
+
+	for ( int i = 0; i < (int)aWeights.size(); i++ )
+	{
+		aWeights[i] = float( int( rnd.Get() & 0xff ) - 128 ) / 1024.f;
+	}
+
+	MultilayerFeedForward	full( NUM_INPUTS, NUM_HIDDEN, NUM_OUTPUTS, aWeights );
+	MultilayerFeedForward	incremental( NUM_INPUTS, NUM_HIDDEN, NUM_OUTPUTS, aWeights );
+
+	Neuron::InputVector	aInputs( NUM_INPUTS, 0.f );
+
+	full( aInputs );
+	incremental( aInputs );
+
+	for ( int i = 0; i < 1000; i++ )
+	{
+		MultilayerFeedForward::InputChangeVector	aChanges;
+
+		for ( int j = 0; j < 3; j++ )
+		{
+			MultilayerFeedForward::InputChange	change;
+
+			change.index	= ( i * 3 + j ) % NUM_INPUTS;
+			change.value	= float( ( rnd.Get() & 0x00008000 ) != 0 );
+
+			aChanges.push_back( change );
+			aInputs[change.index] = change.value;
+		}
+
+		MultilayerFeedForward::OutputVector const	o0	= full( aInputs );
+		MultilayerFeedForward::OutputVector const	o1	= incremental( aChanges );
+
+		for ( int j = 0; j < NUM_OUTPUTS; j++ )
+		{
+			assert( fabs( o0[j] - o1[j] ) < 1.e-5f );
+		}
+
+		if ( i % 100 == 0 )
+		{
+			MultilayerFeedForward::ErrorVector	aErrors( NUM_OUTPUTS, 0.1f );
+
+			full.Train( aInputs, aErrors, 0.5f );
+			incremental.Train( aInputs, aErrors, 0.5f );
+		}
+	}
+
+#if !defined( NDEBUG ) && !defined( _WIN32 )
+
+	// A change to the same input twice fails an assertion. It is tried in a child process.
+
+	pid_t const	child	= fork();
+
+	if ( child == 0 )
+	{
+		freopen( "/dev/null", "w", stderr );	// Hide the assertion message
+
+		MultilayerFeedForward::InputChange			change;
+		MultilayerFeedForward::InputChangeVector	aChanges;
+
+		change.index	= 1;
+		change.value	= 0.5f;
+		aChanges.push_back( change );
+		aChanges.push_back( change );
+
+		incremental( aInputs );
+		incremental( aChanges );
+		_exit( 0 );
+	}
+
+	int	status	= 0;
+
+	assert( child > 0 );
+	waitpid( child, &status, 0 );
+	assert( WIFSIGNALED( status ) && WTERMSIG( status ) == SIGABRT );
+
+#endif // !defined( NDEBUG ) && !defined( _WIN32 )
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/*																													*/
+/********************************************************************************************************************/
+
+static void TestBinaryNet()
+{
+	int const	NUM_INPUTS	= 100;
+	int const	NUM_OUTPUTS	= 8;
+
+	// With weights of -1 and 1 and inputs of 0 and 1, the binarized net's outputs are exactly the perceptron's
+	// outputs rounded to 0 or 1.
+
+	Neuron::WeightVector	aWeights( NUM_INPUTS * NUM_OUTPUTS );
+
+	for ( int i = 0; i < (int)aWeights.size(); i++ )
+	{
+		aWeights[i] = ( ( rnd.Get() & 0x00008000 ) != 0 ) ? 1.f : -1.f;
+	}
+
+	Perceptron	p( NUM_INPUTS, NUM_OUTPUTS, aWeights );
+	BinaryNet	b( p );
+
+	assert( b.GetInputCount() == NUM_INPUTS );
+	assert( b.GetOutputCount() == NUM_OUTPUTS );
+
+	Neuron::InputVector		aInputs( NUM_INPUTS );
+	NeuralNet::OutputVector	aOutputs;
+
+	for ( int i = 0; i < 1000; i++ )
+	{
+		for ( int j = 0; j < NUM_INPUTS; j++ )
+		{
+			aInputs[j] = float( ( rnd.Get() & 0x00008000 ) != 0 );
+		}
+
+		Perceptron::OutputVector const	o	= p( aInputs );
+
+		b.Evaluate( aInputs, aOutputs );
+
+		for ( int j = 0; j < NUM_OUTPUTS; j++ )
+		{
+			assert( aOutputs[j] == float( o[j] >= .5f ) );
+		}
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/*																													*/
+/********************************************************************************************************************/
+
+static void TestDistributedTraining()
+{
+#if !defined( _WIN32 )
+
+	int const	NUM_WORKERS	= 3;
+	int const	NUM_INPUTS	= 8;
+	int const	NUM_HIDDEN	= 6;
+	int const	NUM_OUTPUTS	= 2;
+	int const	BATCH_SIZE	= 12;
+	int const	NUM_EPOCHS	= 20;
+
+	std::vector< std::string >	aAddresses;
+
+	for ( int r = 0; r < NUM_WORKERS; r++ )
+	{
+		aAddresses.push_back( "unix:nn-test-ring-" + std::to_string( r ) );
+	}
+
+	NeuralNet::InputBatch	aInputs( BATCH_SIZE * 10, Neuron::InputVector( NUM_INPUTS ) );
+	NeuralNet::OutputBatch	aTargets( aInputs.size(), NeuralNet::OutputVector( NUM_OUTPUTS ) );
+
+	for ( int b = 0; b < (int)aInputs.size(); b++ )
+	{
+		for ( int k = 0; k < NUM_INPUTS; k++ )
+		{
+			aInputs[b][k] = float( ( rnd.Get() & 0x00008000 ) != 0 );
+		}
+		aTargets[b][0] = aInputs[b][0];
+		aTargets[b][1] = float( aInputs[b][1] != aInputs[b][2] );
+	}
+
+	Neuron::WeightVector	aInitialWeights( ( NUM_INPUTS + NUM_OUTPUTS ) * NUM_HIDDEN );
+
+	for ( int i = 0; i < (int)aInitialWeights.size(); i++ )
+	{
+		aInitialWeights[i] = float( int( rnd.Get() & 0xff ) - 128 ) / 256.f;
+	}
+
+	size_t const	weightsSize	= aInitialWeights.size() * sizeof( float );
+
+	// Each worker runs in its own process, with its own shard of each batch, and sends its final weights back
+	// through a pipe.
+
+	std::vector< pid_t >	aWorkers( NUM_WORKERS );
+	std::vector< int >		aPipes( NUM_WORKERS );
+
+	for ( int r = 0; r < NUM_WORKERS; r++ )
+	{
+		int			fds[2];
+		int const	piped	= pipe( fds );
+
+		assert( piped == 0 );
+
+		aWorkers[r] = fork();
+		assert( aWorkers[r] >= 0 );
+
+		if ( aWorkers[r] == 0 )
+		{
+			close( fds[0] );
+
+			// Only the first worker has the initial weights. Synchronize() copies them to the others.
+
+			Neuron::WeightVector const	aWeights	=
+				( r == 0 ) ? aInitialWeights : Neuron::WeightVector( aInitialWeights.size(), 0.f );
+			MultilayerFeedForward		net( NUM_INPUTS, NUM_HIDDEN, NUM_OUTPUTS, aWeights );
+			RingAllReduce				ring( r, aAddresses );
+			DistributedTrainer			trainer( net, ring );
+
+			bool	ok	= ring.Connect() && trainer.Synchronize();
+
+			for ( int epoch = 0; ok && epoch < NUM_EPOCHS; epoch++ )
+			{
+				for ( int first = 0; ok && first < (int)aInputs.size(); first += BATCH_SIZE )
+				{
+					NeuralNet::InputBatch	aShardInputs;
+					NeuralNet::OutputBatch	aShardTargets;
+
+					for ( int b = first + r; b < first + BATCH_SIZE; b += NUM_WORKERS )
+					{
+						aShardInputs.push_back( aInputs[b] );
+						aShardTargets.push_back( aTargets[b] );
+					}
+
+					ok = trainer.Train( aShardInputs, aShardTargets, 1.f );
+				}
+			}
+
+			Neuron::WeightVector const	aFinalWeights	= net.GetWeights();
+
+			ok = ok && write( fds[1], aFinalWeights.data(), weightsSize ) == (ssize_t)weightsSize;
+			_exit( ok ? 0 : 1 );
+		}
+
+		close( fds[1] );
+		aPipes[r] = fds[0];
+	}
+
+	std::vector< Neuron::WeightVector >	aFinalWeights( NUM_WORKERS, Neuron::WeightVector( aInitialWeights.size() ) );
+
+	for ( int r = 0; r < NUM_WORKERS; r++ )
+	{
+		char *	pData	= reinterpret_cast< char * >( aFinalWeights[r].data() );
+		size_t	nRead	= 0;
+		ssize_t	n;
+
+		while ( nRead < weightsSize && ( n = read( aPipes[r], pData + nRead, weightsSize - nRead ) ) > 0 )
+		{
+			nRead += n;
+		}
+		close( aPipes[r] );
+
+		int	status	= 0;
+
+		waitpid( aWorkers[r], &status, 0 );
+		assert( WIFEXITED( status ) && WEXITSTATUS( status ) == 0 );
+		assert( nRead == weightsSize );
+	}
+
+	// The copies must have stayed identical.
+
+	for ( int r = 1; r < NUM_WORKERS; r++ )
+	{
+		assert( aFinalWeights[r] == aFinalWeights[0] );
+	}
+
+	// They must also match one net trained on the whole of each batch. The changes are summed in a different order,
+	// so the weights differ only by rounding.
+
+	MultilayerFeedForward				net( NUM_INPUTS, NUM_HIDDEN, NUM_OUTPUTS, aInitialWeights );
+	MultilayerFeedForward::Gradients	gradients;
+
+	for ( int epoch = 0; epoch < NUM_EPOCHS; epoch++ )
+	{
+		for ( int first = 0; first < (int)aInputs.size(); first += BATCH_SIZE )
+		{
+			NeuralNet::InputBatch const		aBatchInputs( aInputs.begin() + first,
+														  aInputs.begin() + first + BATCH_SIZE );
+			NeuralNet::OutputBatch const	aBatchTargets( aTargets.begin() + first,
+														   aTargets.begin() + first + BATCH_SIZE );
+
+			net.ComputeGradients( aBatchInputs, aBatchTargets, gradients );
+			net.ApplyGradients( gradients, 1.f / float( BATCH_SIZE ) );
+		}
+	}
+
+	Neuron::WeightVector const	aWeights	= net.GetWeights();
+
+	for ( size_t i = 0; i < aWeights.size(); i++ )
+	{
+		assert( fabs( aWeights[i] - aFinalWeights[0][i] ) < 1.e-4f );
+	}
+
+#endif // !defined( _WIN32 )
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/*																													*/
+/********************************************************************************************************************/
+
+static void TestLowRankNet()
+{
+	int const	NUM_INPUTS	= 64;
+	int const	NUM_HIDDEN	= 32;
+	int const	NUM_OUTPUTS	= 4;
+	int const	RANK		= 2;
+
+	// The hidden weights are a sum of RANK outer products, so the hidden layer can be factorized exactly.
+
+	Neuron::WeightVector	aWeights( ( NUM_INPUTS + NUM_OUTPUTS ) * NUM_HIDDEN );
+	std::vector< float >	aFactors( ( NUM_INPUTS + NUM_HIDDEN ) * RANK );
+
+	for ( int i = 0; i < (int)aFactors.size(); i++ )
+	{
+		aFactors[i] = float( int( rnd.Get() & 0xff ) - 128 ) / 512.f;
+	}
+
+	for ( int i = 0; i < NUM_HIDDEN; i++ )
+	{
+		for ( int j = 0; j < NUM_INPUTS; j++ )
+		{
+			for ( int c = 0; c < RANK; c++ )
+			{
+				aWeights[i * NUM_INPUTS + j] += aFactors[i * RANK + c] * aFactors[( NUM_HIDDEN + j ) * RANK + c];
+			}
+		}
+	}
+
+	for ( int i = NUM_INPUTS * NUM_HIDDEN; i < (int)aWeights.size(); i++ )
+	{
+		aWeights[i] = float( int( rnd.Get() & 0xff ) - 128 ) / 256.f;
+	}
+
+	MultilayerFeedForward	mff( NUM_INPUTS, NUM_HIDDEN, NUM_OUTPUTS, aWeights );
+	LowRankNet				net( mff, LowRankNet::MAX_ERROR, .001f );
+
+	assert( net.GetRank( MultilayerFeedForward::HIDDEN_LAYER ) == RANK );
+	assert( net.GetRank( MultilayerFeedForward::OUTPUT_LAYER ) == 0 );
+	assert( net.GetWeightCount() < (int)aWeights.size() / 2 );
+
+	Neuron::InputVector		aInputs( NUM_INPUTS );
+	NeuralNet::OutputVector	o0;
+	NeuralNet::OutputVector	o1;
+
+	for ( int i = 0; i < 100; i++ )
+	{
+		for ( int j = 0; j < NUM_INPUTS; j++ )
+		{
+			aInputs[j] = float( ( rnd.Get() & 0x00008000 ) != 0 );
+		}
+
+		mff.Evaluate( aInputs, o0 );
+		net.Evaluate( aInputs, o1 );
+
+		for ( int j = 0; j < NUM_OUTPUTS; j++ )
+		{
+			assert( fabs( o0[j] - o1[j] ) < 1.e-4f );
+		}
+	}
+
+	// Fine-tuning a heavily compressed net reduces its error.
+
+	LowRankNet	compressed( mff, LowRankNet::MIN_SPEEDUP, 16.f );
+	float		first		= 0.f;
+	float		last		= 0.f;
+
+	for ( int i = 0; i < 200; i++ )
+	{
+		mff.Evaluate( aInputs, o0 );
+
+		NeuralNet::OutputVector const &	aOutputs	= compressed( aInputs );
+		NeuralNet::ErrorVector			aErrors( NUM_OUTPUTS );
+		float							error		= 0.f;
+
+		for ( int j = 0; j < NUM_OUTPUTS; j++ )
+		{
+			aErrors[j] = o0[j] - aOutputs[j];
+			error += aErrors[j] * aErrors[j];
+		}
+
+		compressed.Train( aInputs, aErrors, 0.5f );
+
+		if ( i == 0 )
+		{
+			first = error;
+		}
+		last = error;
+	}
+
+	assert( last < first );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/*																													*/
+/********************************************************************************************************************/
+
+static void TestDeterministicMFF()
+{
+	int const	NUM_INPUTS	= 64;
+	int const	NUM_HIDDEN	= 32;
+	int const	NUM_OUTPUTS	= 8;
+
+	Neuron::WeightVector	aWeights( ( NUM_INPUTS + NUM_OUTPUTS ) * NUM_HIDDEN );
+
+	for ( int i = 0; i < (int)aWeights.size(); i++ )
+	{
+		aWeights[i] = float( int( rnd.Get() & 0xff ) - 128 ) / 1024.f;
+	}
+
+	// One net is split across threads with tuned kernels, and the other is not, but in deterministic mode they must
+	// be trained to exactly the same weights.
+
+	ThreadPool				pool( 3 );
+	Autotuner				autotuner;
+	MultilayerFeedForward	parallel( NUM_INPUTS, NUM_HIDDEN, NUM_OUTPUTS, aWeights );
+	MultilayerFeedForward	serial( NUM_INPUTS, NUM_HIDDEN, NUM_OUTPUTS, aWeights );
+
+	parallel.SetThreadPool( &pool, 1 );
+	parallel.SetAutotuner( &autotuner );
+	parallel.SetDeterministic( true );
+	serial.SetDeterministic( true );
+
+	Neuron::InputVector				aInputs( NUM_INPUTS );
+	MultilayerFeedForward::ErrorVector	aErrors( NUM_OUTPUTS );
+
+	for ( int i = 0; i < 100; i++ )
+	{
+		for ( int j = 0; j < NUM_INPUTS; j++ )
+		{
+			aInputs[j] = float( int( rnd.Get() & 0xff ) ) / 256.f;
+		}
+
+		MultilayerFeedForward::OutputVector const	o0	= parallel( aInputs );
+		MultilayerFeedForward::OutputVector const	o1	= serial( aInputs );
+
+		assert( o0 == o1 );
+
+		for ( int j = 0; j < NUM_OUTPUTS; j++ )
+		{
+			aErrors[j] = ( ( i + j ) % 2 ) - o0[j];
+		}
+
+		parallel.Train( aInputs, aErrors, 0.2f );
+		serial.Train( aInputs, aErrors, 0.2f );
+	}
+
+	assert( parallel.GetWeights() == serial.GetWeights() );
+
+	// The batched paths use the same kernels as Evaluate(), so they give exactly the same outputs. The autotuner does
+	// not tune, so both layers get a kernel that adds the inputs in a different order from Neuron::Input().
+
+	Autotuner				untuned;
+	MultilayerFeedForward	tuned( NUM_INPUTS, NUM_HIDDEN, NUM_OUTPUTS, aWeights );
+	NeuralNet::InputBatch	aBatch( 10, Neuron::InputVector( NUM_INPUTS ) );
+	NeuralNet::OutputBatch	aTargets( aBatch.size(), NeuralNet::OutputVector( NUM_OUTPUTS, 0.5f ) );
+	NeuralNet::OutputBatch	aBatchOutputs;
+
+	untuned.SetTuning( false );
+	tuned.SetAutotuner( &untuned );
+
+	for ( size_t b = 0; b < aBatch.size(); b++ )
+	{
+		for ( int j = 0; j < NUM_INPUTS; j++ )
+		{
+			aBatch[b][j] = float( int( rnd.Get() & 0xff ) ) / 256.f;
+		}
+	}
+
+	tuned.EvaluateBatch( aBatch, aBatchOutputs );
+
+	MultilayerFeedForward::Gradients	gradients;
+
+	tuned.ComputeOutputGradients( aBatch, aTargets, gradients );
+
+	for ( size_t b = 0; b < aBatch.size(); b++ )
+	{
+		NeuralNet::OutputVector	aOutputs;
+		NeuralNet::OutputVector	aHiddenOutputs;
+
+		tuned.Evaluate( aBatch[b], aOutputs );
+		tuned.EvaluateHidden( aBatch[b], aHiddenOutputs );
+
+		assert( aBatchOutputs[b] == aOutputs );
+		assert( gradients.aHiddenOutputs[b] == aHiddenOutputs );
+		assert( tuned( aBatch[b] ) == aOutputs );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/*																													*/
+/********************************************************************************************************************/
+
+static void TestTextSerialization()
+{
+	int const	NUM_INPUTS	= 600;
+	int const	NUM_HIDDEN	= 200;
+	int const	NUM_OUTPUTS	= 10;
+
+	// Weights that need all 9 significant digits, and a few special values
+
+	Neuron::WeightVector	aWeights( ( NUM_INPUTS + NUM_OUTPUTS ) * NUM_HIDDEN );
+
+	for ( int i = 0; i < (int)aWeights.size(); i++ )
+	{
+		aWeights[i] = float( int( rnd.Get() & 0xffffff ) - 0x800000 ) / 3.f / float( 1 << ( rnd.Get() & 0x1f ) );
+	}
+
+	aWeights[0] = 1.e-40f;
+	aWeights[1] = -0.f;
+	aWeights[2] = 3.4028235e38f;
+
+	MultilayerFeedForward	original( NUM_INPUTS, NUM_HIDDEN, NUM_OUTPUTS, aWeights );
+	std::stringstream		text;
+
+	text << original;
+
+	// Read with the stream operator
+
+	MultilayerFeedForward	streamed;
+
+	text >> streamed;
+	assert( !text.fail() );
+	assert( streamed.GetWeights() == aWeights );
+
+	// Read in parallel (the text is large enough to be split across the threads)
+
+	ThreadPool				pool( 3 );
+	MultilayerFeedForward	parsed( 1, 1, 1 );
+
+	parsed( Neuron::InputVector( 1, 1.f ) );
+
+	bool	ok	= parsed.ReadText( text.str(), &pool );
+
+	assert( ok );
+	assert( parsed.GetInputCount() == NUM_INPUTS );
+	assert( parsed.GetHiddenCount() == NUM_HIDDEN );
+	assert( parsed.GetOutputCount() == NUM_OUTPUTS );
+	assert( parsed.GetWeights() == aWeights );
+
+	// The most recent inputs of a net that has been read are zeros, whatever its shape was before, so an incremental
+	// evaluation can follow.
+
+	MultilayerFeedForward::InputChangeVector	aChanges( 1 );
+	Neuron::InputVector							aInputs( NUM_INPUTS, 0.f );
+
+	aChanges[0].index		= NUM_INPUTS - 1;
+	aChanges[0].value		= 0.5f;
+	aInputs[NUM_INPUTS - 1]	= 0.5f;
+
+	assert( parsed( aChanges ) == original( aInputs ) );
+	assert( streamed( aChanges ) == original( aInputs ) );
+
+	// A malformed text is rejected without changing the net.
+
+	ok = parsed.ReadText( "1 1 1 1\n1 0.5\n1 0.5x\n", &pool );
+
+	assert( !ok );
+	assert( parsed.GetWeights() == aWeights );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/*																													*/
+/********************************************************************************************************************/
+
+static void TestDistiller()
+{
+	int const	NUM_INPUTS	= 10;
+	int const	NUM_HIDDEN	= 40;
+	int const	NUM_OUTPUTS	= 3;
+	int const	NUM_SAMPLES	= 1000;
+
+	MultilayerFeedForward	teacher( NUM_INPUTS, NUM_HIDDEN, NUM_OUTPUTS );
+	MultilayerFeedForward	student( NUM_INPUTS, 4, NUM_OUTPUTS );
+	MultilayerFeedForward	cachedStudent( student );
+	NeuralNet::InputBatch	aInputs( NUM_SAMPLES, Neuron::InputVector( NUM_INPUTS ) );
+
+	for ( int i = 0; i < NUM_SAMPLES; i++ )
+	{
+		for ( int j = 0; j < NUM_INPUTS; j++ )
+		{
+			aInputs[i][j] = float( rnd.Get() & 0xffff ) / 65536.f - 0.5f;
+		}
+	}
+
+	std::string const	path	= "distiller_test.bin";
+
+	std::remove( path.c_str() );
+
+	// The first run writes the soft targets to the cache, and the student learns to imitate the teacher.
+
+	{
+		Distiller	distiller( teacher, student, aInputs, 64 );
+		bool		cached;
+
+		cached = distiller.SetCache( path );
+		assert( !cached );
+
+		float const	firstLoss	= distiller.Train( 0.5f );
+		float		loss		= firstLoss;
+
+		for ( int epoch = 1; epoch < 5; epoch++ )
+		{
+			loss = distiller.Train( 0.5f );
+		}
+
+		assert( loss < firstLoss );
+	}
+
+	// A second run reads the soft targets from the cache and trains the same student.
+
+	{
+		Distiller	distiller( teacher, cachedStudent, aInputs, 64 );
+		bool		cached;
+
+		cached = distiller.SetCache( path );
+		assert( cached );
+
+		for ( int epoch = 0; epoch < 5; epoch++ )
+		{
+			distiller.Train( 0.5f );
+		}
+	}
+
+	assert( cachedStudent.GetWeights() == student.GetWeights() );
+
+	std::remove( path.c_str() );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/*																													*/
+/********************************************************************************************************************/
+
+static void TestPredictionCache()
+{
+	int const	NUM_INPUTS	= 8;
+	int const	NUM_HIDDEN	= 16;
+	int const	NUM_OUTPUTS	= 4;
+
+	MultilayerFeedForward	net( NUM_INPUTS, NUM_HIDDEN, NUM_OUTPUTS );
+	PredictionCache			cache( net );
+	Neuron::InputVector		aInputs( NUM_INPUTS );
+	NeuralNet::OutputVector	aCached;
+	NeuralNet::OutputVector	aExpected;
+
+	for ( int j = 0; j < NUM_INPUTS; j++ )
+	{
+		aInputs[j] = float( rnd.Get() & 0xffff ) / 65536.f;
+	}
+
+	// The second lookup is a hit.
+
+	cache.Evaluate( aInputs, aCached );
+	cache.Evaluate( aInputs, aCached );
+	net.Evaluate( aInputs, aExpected );
+	assert( aCached == aExpected );
+	assert( cache.GetStatistics().nHits == 1 );
+	assert( cache.GetStatistics().nMisses == 1 );
+
+	// Training the net invalidates the cached outputs.
+
+	MultilayerFeedForward::ErrorVector	aErrors( NUM_OUTPUTS, 0.5f );
+
+	net( aInputs );
+	net.Train( aInputs, aErrors, 1.f );
+
+	cache.Evaluate( aInputs, aCached );
+	net.Evaluate( aInputs, aExpected );
+	assert( aCached == aExpected );
+	assert( cache.GetStatistics().nMisses == 2 );
+
+	// With quantization, a nearby input shares the entry.
+
+	PredictionCache			quantized( net, PredictionCache::DEFAULT_CAPACITY, 1.f / 16.f );
+	Neuron::InputVector		aNearby( aInputs );
+
+	aNearby[0] = std::floor( aNearby[0] * 16.f ) / 16.f + 1.f / 64.f;
+	aInputs[0] = aNearby[0] + 1.f / 256.f;
+
+	quantized.Evaluate( aInputs, aExpected );
+	quantized.Evaluate( aNearby, aCached );
+	assert( aCached == aExpected );
+	assert( quantized.GetStatistics().nHits == 1 );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/*																													*/
+/********************************************************************************************************************/
+
+static void TestEvaluator()
+{
+	int const	NUM_INPUTS	= 10;
+	int const	NUM_HIDDEN	= 20;
+	int const	NUM_OUTPUTS	= 4;
+	int const	NUM_SAMPLES	= 3000;
+
+	MultilayerFeedForward	net( NUM_INPUTS, NUM_HIDDEN, NUM_OUTPUTS );
+	NeuralNet::InputBatch	aInputs( NUM_SAMPLES, Neuron::InputVector( NUM_INPUTS ) );
+	NeuralNet::OutputBatch	aTargets( NUM_SAMPLES, NeuralNet::OutputVector( NUM_OUTPUTS, 0.f ) );
+
+	for ( int i = 0; i < NUM_SAMPLES; i++ )
+	{
+		for ( int j = 0; j < NUM_INPUTS; j++ )
+		{
+			aInputs[i][j] = float( rnd.Get() & 0xffff ) / 65536.f - 0.5f;
+		}
+
+		aTargets[i][rnd.Get() % NUM_OUTPUTS] = 1.f;
+	}
+
+	// The results do not depend on the number of threads.
+
+	ThreadPool					pool( 3 );
+	Evaluator					serial( 0, 100 );
+	Evaluator					parallel( &pool, 100 );
+	Evaluator::Metrics const	expected	= serial.Evaluate( net, aInputs, aTargets );
+	Evaluator::Metrics const	metrics		= parallel.Evaluate( net, aInputs, aTargets );
+
+	assert( metrics.nSamples == NUM_SAMPLES );
+	assert( metrics.nCorrect == expected.nCorrect );
+	assert( metrics.squaredError == expected.squaredError );
+	assert( metrics.aConfusion == expected.aConfusion );
+	assert( metrics.GetCalibrationError() == expected.GetCalibrationError() );
+
+	// The accuracy and the confusion matrix agree with the net's own predictions.
+
+	NeuralNet::OutputVector	aOutputs;
+	long long				nCorrect	= 0;
+	long long				nTotal		= 0;
+
+	for ( int i = 0; i < NUM_SAMPLES; i++ )
+	{
+		net.Evaluate( aInputs[i], aOutputs );
+
+		NeuralNet::OutputVector const &	aTarget	= aTargets[i];
+
+		int const	actual		= int( std::max_element( aTarget.begin(), aTarget.end() ) - aTarget.begin() );
+		int const	predicted	= int( std::max_element( aOutputs.begin(), aOutputs.end() ) - aOutputs.begin() );
+
+		nCorrect += ( predicted == actual ) ? 1 : 0;
+	}
+
+	for ( int actual = 0; actual < NUM_OUTPUTS; actual++ )
+	{
+		nTotal += metrics.GetConfusion( actual, actual );
+	}
+
+	assert( metrics.nCorrect == nCorrect );
+	assert( nTotal == nCorrect );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/*																													*/
+/********************************************************************************************************************/
+
+static void TestThreadPool()
+{
+	int const	N	= 10000;
+
+	ThreadPool				pool( 4 );
+	std::vector< int >		aCounts( N, 0 );
+
+	// Every index is processed exactly once, and neighboring indexes are in the same tile.
+
+	pool.ParallelFor( N, 64, [&aCounts] ( int first, int last )
+	{
+		assert( last - first <= 64 );
+
+		for ( int i = first; i < last; i++ )
+		{
+			++aCounts[i];
+		}
+	} );
+
+	for ( int i = 0; i < N; i++ )
+	{
+		assert( aCounts[i] == 1 );
+	}
+
+	// A nested call runs serially instead of waiting forever for the outer call.
+
+	std::vector< int >	aNested( 16 * N, 0 );
+
+	pool.ParallelFor( 16, 1, [&pool, &aNested] ( int first, int last )
+	{
+		for ( int t = first; t < last; t++ )
+		{
+			pool.ParallelFor( N, 64, [&aNested, t] ( int begin, int end )
+			{
+				assert( begin == 0 && end == N );
+
+				for ( int i = begin; i < end; i++ )
+				{
+					++aNested[t * N + i];
+				}
+			} );
+		}
+	} );
+
+	for ( int i = 0; i < 16 * N; i++ )
+	{
+		assert( aNested[i] == 1 );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/*																													*/
+/********************************************************************************************************************/
+
+static void TestEnsemble()
+{
+	int const	NUM_MODELS	= 5;
+	int const	NUM_INPUTS	= 6;
+	int const	NUM_HIDDEN	= 4;
+	int const	NUM_OUTPUTS	= 3;
+
+	std::vector< MultilayerFeedForward >	aNets;
+	std::vector< Perceptron >				aPerceptrons;
+	Ensemble								mffs( NUM_MODELS, NUM_INPUTS, NUM_HIDDEN, NUM_OUTPUTS );
+	Ensemble								perceptrons( NUM_MODELS, NUM_INPUTS, 0, NUM_OUTPUTS );
+
+	for ( int m = 0; m < NUM_MODELS; m++ )
+	{
+		aNets.push_back( MultilayerFeedForward( NUM_INPUTS, NUM_HIDDEN, NUM_OUTPUTS ) );
+		aPerceptrons.push_back( Perceptron( NUM_INPUTS, NUM_OUTPUTS ) );
+		mffs.Set( m, aNets[m] );
+		perceptrons.Set( m, aPerceptrons[m] );
+	}
+
+	// Each net gets its own inputs. Value k of net m is at index k * NUM_MODELS + m.
+
+	Ensemble::ValueVector	aInputs( NUM_INPUTS * NUM_MODELS );
+
+	for ( int i = 0; i < (int)aInputs.size(); i++ )
+	{
+		aInputs[i] = float( rnd.Get() & 0xffff ) / 65536.f - 0.5f;
+	}
+
+	Ensemble::ValueVector const	aMFFOutputs			= mffs( aInputs );
+	Ensemble::ValueVector const	aPerceptronOutputs	= perceptrons( aInputs );
+
+	for ( int m = 0; m < NUM_MODELS; m++ )
+	{
+		Neuron::InputVector	aNetInputs( NUM_INPUTS );
+
+		for ( int k = 0; k < NUM_INPUTS; k++ )
+		{
+			aNetInputs[k] = aInputs[k * NUM_MODELS + m];
+		}
+
+		NeuralNet::OutputVector const	aOwnMFFOutputs			= aNets[m]( aNetInputs );
+		NeuralNet::OutputVector const	aOwnPerceptronOutputs	= aPerceptrons[m]( aNetInputs );
+
+		for ( int i = 0; i < NUM_OUTPUTS; i++ )
+		{
+			assert( fabs( aMFFOutputs[i * NUM_MODELS + m] - aOwnMFFOutputs[i] ) < 1.e-5f );
+			assert( fabs( aPerceptronOutputs[i * NUM_MODELS + m] - aOwnPerceptronOutputs[i] ) < 1.e-5f );
+		}
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/*																													*/
+/********************************************************************************************************************/
+
+static void TestModelHandle()
+{
+	// A net that counts its deletions and checks that it is not deleted by a reader's thread.
+
+	static thread_local bool	bReader	= false;
+
+	struct CountedNet : public Perceptron
+	{
+		std::atomic< int > &	nDeleted;
+
+		explicit CountedNet( std::atomic< int > & nDeleted_ ) : Perceptron( 2, 1 ), nDeleted( nDeleted_ ) {}
+		~CountedNet() { assert( !bReader ); ++nDeleted; }
+	};
+
+	std::atomic< int >	nDeleted( 0 );
+	ModelHandle			handle( std::unique_ptr< NeuralNet >( new CountedNet( nDeleted ) ) );
+
+	// Replaced nets are deleted by the handle's background thread shortly after their readers finish.
+
+	auto const	waitForDeletions	= [&nDeleted] ( int n )
+	{
+		for ( int i = 0; i < 10000 && nDeleted < n; i++ )
+		{
+			std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+		}
+
+		return nDeleted == n;
+	};
+
+	// A reader keeps the net it started with, and the net is deleted after the reader finishes.
+
+	{
+		bReader = true;
+
+		ModelHandle::Reader	old( handle );
+		NeuralNet const *	pOld	= old.Get();
+
+		handle.Publish( std::unique_ptr< NeuralNet >( new CountedNet( nDeleted ) ) );
+		assert( old.Get() == pOld );
+		assert( nDeleted == 0 );
+
+		ModelHandle::Reader	current( handle );
+
+		assert( current.Get() != pOld );
+	}
+
+	bReader = false;
+
+	bool	deleted;
+
+	deleted = waitForDeletions( 1 );
+	assert( deleted );
+
+	// Readers on several threads while the net is replaced repeatedly. Every replaced net is deleted once its readers
+	// have finished.
+
+	int const					NUM_PUBLISHES	= 200;
+	std::atomic< bool >			bDone( false );
+	std::vector< std::thread >	aReaders;
+
+	for ( int t = 0; t < 3; t++ )
+	{
+		aReaders.push_back( std::thread( [&handle, &bDone] ()
+		{
+			Neuron::InputVector		aInputs( 2, 0.5f );
+			NeuralNet::OutputVector	aOutputs;
+
+			bReader = true;
+
+			while ( !bDone )
+			{
+				ModelHandle::Reader	reader( handle );
+
+				reader->Evaluate( aInputs, aOutputs );
+				assert( aOutputs.size() == 1 );
+			}
+		} ) );
+	}
+
+	for ( int i = 0; i < NUM_PUBLISHES; i++ )
+	{
+		handle.Publish( std::unique_ptr< NeuralNet >( new CountedNet( nDeleted ) ) );
+	}
+
+	bDone = true;
+
+	for ( size_t t = 0; t < aReaders.size(); t++ )
+	{
+		aReaders[t].join();
+	}
+
+	deleted = waitForDeletions( 1 + NUM_PUBLISHES );
+	assert( deleted );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/*																													*/
+/********************************************************************************************************************/
+
+static void TestInferenceScheduler()
+{
+	int const	NUM_INPUTS		= 8;
+	int const	NUM_REQUESTS	= 100;
+
+	MultilayerFeedForward	net( NUM_INPUTS, 16, 4 );
+	NeuralNet::InputBatch	aInputs( NUM_REQUESTS, Neuron::InputVector( NUM_INPUTS ) );
+
+	for ( int i = 0; i < NUM_REQUESTS; i++ )
+	{
+		for ( int j = 0; j < NUM_INPUTS; j++ )
+		{
+			aInputs[i][j] = float( rnd.Get() & 0xffff ) / 65536.f - 0.5f;
+		}
+	}
+
+	std::vector< std::future< NeuralNet::OutputVector > >	aFutures;
+	NeuralNet::OutputBatch									aCallbackOutputs( NUM_REQUESTS );
+	std::atomic< int >										nCallbacks( 0 );
+
+	{
+		InferenceScheduler	scheduler( net, 16, std::chrono::microseconds( 1000 ), 2 );
+
+		for ( int i = 0; i < NUM_REQUESTS; i++ )
+		{
+			auto const	callback	= [&aCallbackOutputs, &nCallbacks, i] ( NeuralNet::OutputVector const & aOutputs )
+			{
+				aCallbackOutputs[i] = aOutputs;
+				++nCallbacks;
+			};
+
+			aFutures.push_back( scheduler.Submit( aInputs[i] ) );
+			scheduler.Submit( aInputs[i], callback );
+		}
+
+		// Every request is resolved with the outputs of Evaluate().
+
+		for ( int i = 0; i < NUM_REQUESTS; i++ )
+		{
+			NeuralNet::OutputVector	aExpected;
+
+			net.Evaluate( aInputs[i], aExpected );
+			assert( aFutures[i].get() == aExpected );
+		}
+
+		while ( nCallbacks < NUM_REQUESTS )
+		{
+			std::this_thread::yield();
+		}
+
+		InferenceScheduler::Statistics const	statistics	= scheduler.GetStatistics();
+
+		assert( statistics.queueDelays.count == 2 * NUM_REQUESTS );
+		assert( statistics.batchSizes.sum == 2 * NUM_REQUESTS );
+	}
+
+	for ( int i = 0; i < NUM_REQUESTS; i++ )
+	{
+		NeuralNet::OutputVector	aExpected;
+
+		net.Evaluate( aInputs[i], aExpected );
+		assert( aCallbackOutputs[i] == aExpected );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/*																													*/
+/********************************************************************************************************************/
+
+static void TestInferenceOnly()
+{
+	int const	NUM_INPUTS	= 12;
+	int const	NUM_OUTPUTS	= 5;
+
+	MultilayerFeedForward	trainable( NUM_INPUTS, 20, NUM_OUTPUTS );
+	MultilayerFeedForward	inferenceOnly( trainable );
+	Neuron::InputVector		aInputs( NUM_INPUTS );
+
+	inferenceOnly.SetInferenceOnly( true );
+	assert( inferenceOnly.IsInferenceOnly() );
+
+	// The outputs are the same with and without the gradients.
+
+	for ( int i = 0; i < 100; i++ )
+	{
+		for ( int j = 0; j < NUM_INPUTS; j++ )
+		{
+			aInputs[j] = float( rnd.Get() & 0xffff ) / 65536.f - 0.5f;
+		}
+
+		assert( inferenceOnly( aInputs ) == trainable( aInputs ) );
+	}
+
+#if !defined( NDEBUG ) && !defined( _WIN32 )
+
+	// Training in inference-only mode fails an assertion. It is tried in a child process.
+
+	pid_t const	child	= fork();
+
+	if ( child == 0 )
+	{
+		freopen( "/dev/null", "w", stderr );	// Hide the assertion message
+
+		inferenceOnly.Train( aInputs, NeuralNet::ErrorVector( NUM_OUTPUTS, 0.1f ), 0.5f );
+		_exit( 0 );
+	}
+
+	int	status	= 0;
+
+	assert( child > 0 );
+	waitpid( child, &status, 0 );
+	assert( WIFSIGNALED( status ) && WTERMSIG( status ) == SIGABRT );
+
+#endif // !defined( NDEBUG ) && !defined( _WIN32 )
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/*																													*/
+/********************************************************************************************************************/
+
+static void TestSelectedOutputs()
+{
+	int const	NUM_INPUTS	= 16;
+	int const	NUM_OUTPUTS	= 50;
+	int const	K			= 5;
+
+	MultilayerFeedForward	mff( NUM_INPUTS, 24, NUM_OUTPUTS );
+	Perceptron				perceptron( NUM_INPUTS, NUM_OUTPUTS );
+	NeuralNet const * const	apNets[]	= { &mff, &perceptron };
+	Neuron::InputVector		aInputs( NUM_INPUTS );
+	NeuralNet::IndexVector	aIndexes;
+
+	for ( int j = 0; j < NUM_INPUTS; j++ )
+	{
+		aInputs[j] = float( rnd.Get() & 0xffff ) / 65536.f - 0.5f;
+	}
+
+	for ( int i = NUM_OUTPUTS - 1; i >= 0; i -= 7 )
+	{
+		aIndexes.push_back( i );
+	}
+
+	for ( int n = 0; n < elementsof( apNets ); n++ )
+	{
+		NeuralNet const &			net		= *apNets[n];
+		NeuralNet::OutputVector		aOutputs;
+
+		net.Evaluate( aInputs, aOutputs );
+
+		// The selected outputs are the outputs at the given indexes, in the given order.
+
+		NeuralNet::OutputVector		aSelected;
+
+		net.EvaluateSelected( aInputs, aIndexes, aSelected );
+		assert( aSelected.size() == aIndexes.size() );
+
+		for ( size_t k = 0; k < aIndexes.size(); k++ )
+		{
+			assert( fabs( aSelected[k] - aOutputs[aIndexes[k]] ) < 1.e-6f );
+		}
+
+		// The best outputs are the largest, largest first, with their values.
+
+		NeuralNet::RankedOutputVector	aBest;
+
+		net.TopK( aInputs, K, aBest );
+		assert( aBest.size() == K );
+
+		for ( int r = 0; r < K; r++ )
+		{
+			assert( fabs( aBest[r].value - aOutputs[aBest[r].index] ) < 1.e-6f );
+			assert( r == 0 || aBest[r].value <= aBest[r - 1].value );
+		}
+
+		for ( int i = 0; i < NUM_OUTPUTS; i++ )
+		{
+			bool	bRanked	= false;
+
+			for ( int r = 0; r < K; r++ )
+			{
+				bRanked = bRanked || ( aBest[r].index == i );
+			}
+
+			assert( bRanked || aOutputs[i] <= aBest[K - 1].value + 1.e-6f );
+		}
+
+		assert( net.ArgMax( aInputs ) == aBest[0].index );
+
+		// Asking for more outputs than there are returns all of them.
+
+		net.TopK( aInputs, NUM_OUTPUTS + 10, aBest );
+		assert( aBest.size() == NUM_OUTPUTS );
+	}
+
+	// With a kernel that adds the inputs in a different order from Neuron::Input(), the selected outputs and the best
+	// outputs are still exactly the outputs of Evaluate().
+
+	Autotuner						untuned;
+	MultilayerFeedForward			tuned( NUM_INPUTS, 200, NUM_OUTPUTS );
+	Neuron::WeightVector			aWeights	= tuned.GetWeights();
+	NeuralNet::OutputVector			aOutputs;
+	NeuralNet::OutputVector			aSelected;
+	NeuralNet::RankedOutputVector	aBest;
+
+	for ( size_t i = 0; i < aWeights.size(); i++ )
+	{
+		aWeights[i] = float( int( rnd.Get() & 0xff ) - 128 ) / 256.f;
+	}
+
+	tuned.SetWeights( aWeights );
+	untuned.SetTuning( false );
+	tuned.SetAutotuner( &untuned );
+
+	tuned.Evaluate( aInputs, aOutputs );
+	tuned.EvaluateSelected( aInputs, aIndexes, aSelected );
+	tuned.TopK( aInputs, K, aBest );
+
+	for ( size_t k = 0; k < aIndexes.size(); k++ )
+	{
+		assert( aSelected[k] == aOutputs[aIndexes[k]] );
+	}
+
+	for ( int r = 0; r < K; r++ )
+	{
+		assert( aBest[r].value == aOutputs[aBest[r].index] );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/*																													*/
+/********************************************************************************************************************/
+
+static void TestCodeGenerator()
+{
+	// Names
+
+	assert( IsValidName( "Model" ) );
+	assert( IsValidName( "model_2" ) );
+	assert( !IsValidName( "" ) );
+	assert( !IsValidName( "2model" ) );
+	assert( !IsValidName( "my-model" ) );
+	assert( !IsValidName( "namespace" ) );
+	assert( !IsValidName( "float" ) );
+	assert( !IsValidName( "my__model" ) );
+	assert( !IsValidName( "_Model" ) );
+
+	// The weights are written as literals that read back exactly, whatever the locale, and have one definition.
+
+	Neuron::WeightVector	aWeights( 3 * 2 );
+
+	aWeights[0] = 0.1f;
+	aWeights[1] = -3.f;
+	aWeights[2] = 1.e-40f;
+	aWeights[3] = 123456.79f;
+	aWeights[4] = -0.f;
+	aWeights[5] = 2.5e-7f;
+
+	Perceptron			p( 3, 2, aWeights );
+	std::ostringstream	header;
+
+	bool const	generated	= GenerateHeader( header, p, "Model" );
+
+	assert( generated );
+
+	std::string const	text	= header.str();
+
+	assert( text.find( "namespace Model" ) != std::string::npos );
+	assert( text.find( "inline constexpr int\tNUM_INPUTS\t= 3;" ) != std::string::npos );
+	assert( text.find( "alignas( 64 ) inline constexpr float\tOUTPUT_WEIGHTS[NUM_OUTPUTS][NUM_INPUTS]" ) !=
+			std::string::npos );
+
+	size_t const	first		= text.find( '{', text.find( "OUTPUT_WEIGHTS" ) );
+	size_t const	last		= text.find( "};", first );
+	std::string		literals	= text.substr( first, last - first );
+
+	std::replace( literals.begin(), literals.end(), '{', ' ' );
+	std::replace( literals.begin(), literals.end(), '}', ' ' );
+	std::replace( literals.begin(), literals.end(), ',', ' ' );
+
+	std::istringstream	in( literals );
+	std::string			literal;
+
+	for ( size_t i = 0; i < aWeights.size(); i++ )
+	{
+		in >> literal;
+		assert( literal.size() > 1 && literal.back() == 'f' && literal.find_first_of( ".e" ) != std::string::npos );
+		assert( std::strtof( literal.c_str(), 0 ) == aWeights[i] );
+		assert( std::signbit( std::strtof( literal.c_str(), 0 ) ) == std::signbit( aWeights[i] ) );
+	}
+
+	assert( !( in >> literal ) );
+
+	// A weight that is not finite cannot be written.
+
+	aWeights[3] = std::numeric_limits< float >::quiet_NaN();
+
+	Perceptron			invalid( 3, 2, aWeights );
+	std::ostringstream	rejected;
+
+	bool const	rejectedGenerated	= GenerateHeader( rejected, invalid, "Model" );
+
+	assert( !rejectedGenerated );
+	assert( rejected.str().empty() );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/*																													*/
+/********************************************************************************************************************/
+
+static void TestMemoryResources()
+{
+	// A resource that counts the memory it has given out.
+
+	struct CountingResource : public std::pmr::memory_resource
+	{
+		CountingResource() : nAllocations( 0 ), nBytes( 0 ) {}
+
+		virtual void * do_allocate( size_t bytes, size_t alignment )
+		{
+			++nAllocations;
+			nBytes += bytes;
+			return std::pmr::new_delete_resource()->allocate( bytes, alignment );
+		}
+
+		virtual void do_deallocate( void * p, size_t bytes, size_t alignment )
+		{
+			--nAllocations;
+			nBytes -= bytes;
+			std::pmr::new_delete_resource()->deallocate( p, bytes, alignment );
+		}
+
+		virtual bool do_is_equal( std::pmr::memory_resource const & other ) const noexcept
+		{
+			return &other == this;
+		}
+
+		int		nAllocations;
+		size_t	nBytes;
+	};
+
+	// Every allocation from an AlignedResource has at least its alignment, and all of it can be written.
+
+	{
+		CountingResource	upstream;
+		AlignedResource		aligned( 256, &upstream );
+
+		for ( size_t bytes = 1; bytes <= 4096; bytes *= 3 )
+		{
+			void *	p	= aligned.allocate( bytes, alignof( float ) );
+
+			assert( reinterpret_cast< uintptr_t >( p ) % 256 == 0 );
+			memset( p, 0xa5, bytes );
+			aligned.deallocate( p, bytes, alignof( float ) );
+		}
+
+		void *	p	= aligned.allocate( 100, 1024 );		// A larger alignment is honored too
+
+		assert( reinterpret_cast< uintptr_t >( p ) % 1024 == 0 );
+		aligned.deallocate( p, 100, 1024 );
+
+		assert( upstream.nAllocations == 0 && upstream.nBytes == 0 );
+	}
+
+	// A PageResource returns whole pages, whatever huge pages are asked for.
+
+	{
+		PageResource::HugePages const	aHugePages[]	=
+		{
+			PageResource::NO_HUGE_PAGES, PageResource::TRANSPARENT_HUGE_PAGES, PageResource::EXPLICIT_HUGE_PAGES
+		};
+
+		for ( int h = 0; h < elementsof( aHugePages ); h++ )
+		{
+			PageResource	pages( aHugePages[h], PageResource::GetCurrentNode() );
+
+			for ( size_t bytes = 1; bytes <= 3 * 1024 * 1024; bytes *= 37 )
+			{
+				void *	p	= pages.allocate( bytes, 64 );
+
+				assert( reinterpret_cast< uintptr_t >( p ) % 4096 == 0 );
+				memset( p, 0xa5, bytes );
+				pages.deallocate( p, bytes, 64 );
+			}
+		}
+	}
+
+	// An ArenaResource takes its memory from the upstream resource in chunks and returns it all when it is
+	// destroyed. Its allocations are aligned and do not overlap, and an allocation larger than a chunk gets a chunk
+	// of its own.
+
+	{
+		CountingResource	upstream;
+
+		{
+			ArenaResource				arena( &upstream, 4096, 64 );
+			std::vector< char * >		apBlocks;
+
+			for ( int i = 0; i < 100; i++ )
+			{
+				char *	p	= static_cast< char * >( arena.allocate( 100, alignof( float ) ) );
+
+				assert( reinterpret_cast< uintptr_t >( p ) % 64 == 0 );
+				memset( p, i, 100 );
+				apBlocks.push_back( p );
+			}
+
+			char *	pLarge	= static_cast< char * >( arena.allocate( 10000, alignof( float ) ) );
+
+			memset( pLarge, 0xff, 10000 );
+
+			for ( int i = 0; i < 100; i++ )
+			{
+				assert( std::count( apBlocks[i], apBlocks[i] + 100, char( i ) ) == 100 );
+				arena.deallocate( apBlocks[i], 100, alignof( float ) );
+			}
+
+			assert( upstream.nAllocations > 1 && upstream.nBytes >= 100 * 100 + 10000 );
+			assert( upstream.nAllocations < 100 );
+		}
+
+		assert( upstream.nAllocations == 0 && upstream.nBytes == 0 );
+	}
+
+	// A net whose weights are moved into an arena of huge pages works the same as before.
+
+	{
+		MultilayerFeedForward	net( 16, 8, 4 );
+		MultilayerFeedForward	replica( net );
+		PageResource			pages( PageResource::TRANSPARENT_HUGE_PAGES );
+		ArenaResource			arena( &pages );
+		Neuron::InputVector		aInputs( 16 );
+
+		for ( int i = 0; i < 16; i++ )
+		{
+			aInputs[i] = float( rnd.Get() & 0xffff ) / 65536.f - 0.5f;
+		}
+
+		replica.SetMemoryResource( &arena );
+
+		assert( replica.GetWeights() == net.GetWeights() );
+		assert( replica( aInputs ) == net( aInputs ) );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/*																													*/
+/********************************************************************************************************************/
+
+static void TestCheckpointer()
+{
+	int const	NUM_INPUTS	= 6;
+	int const	NUM_HIDDEN	= 5;
+	int const	NUM_OUTPUTS	= 3;
+	int const	NUM_STEPS	= 5;
+	int const	NUM_KEPT	= 2;
+
+	std::string const	prefix	= "checkpointer_test";
+
+	// Returns the name of the checkpoint file for a step.
+
+	auto const	CheckpointPath	= [&prefix] ( long long step ) -> std::string
+	{
+		char	name[32];
+		snprintf( name, sizeof( name ), "-%012lld.ckpt", step );
+		return prefix + name;
+	};
+
+	for ( int step = 1; step <= NUM_STEPS; step++ )
+	{
+		std::remove( CheckpointPath( step ).c_str() );
+	}
+
+	MultilayerFeedForward					net( NUM_INPUTS, NUM_HIDDEN, NUM_OUTPUTS );
+	std::vector< MultilayerFeedForward >	aSnapshots;
+	Neuron::InputVector						aInputs( NUM_INPUTS );
+	NeuralNet::ErrorVector					aErrors( NUM_OUTPUTS );
+
+	// Train the net, saving a checkpoint after each step. Each one is written before the next is saved, so none is
+	// replaced while waiting.
+
+	{
+		Checkpointer	checkpointer( prefix, NUM_KEPT );
+
+		for ( int step = 1; step <= NUM_STEPS; step++ )
+		{
+			for ( int i = 0; i < NUM_INPUTS; i++ )
+			{
+				aInputs[i] = float( rnd.Get() & 0xffff ) / 65536.f - 0.5f;
+			}
+
+			NeuralNet::OutputVector const	aOutputs	= net( aInputs );
+
+			for ( int i = 0; i < NUM_OUTPUTS; i++ )
+			{
+				aErrors[i] = float( i & 1 ) - aOutputs[i];
+			}
+
+			net.Train( aInputs, aErrors, 0.5f );
+			aSnapshots.push_back( net );
+
+			checkpointer.Save( net, Checkpointer::TrainingState( step, 0.5f / float( step ) ) );
+			checkpointer.Wait();
+		}
+
+		assert( checkpointer.GetFailureCount() == 0 );
+	}
+
+	// Only the newest checkpoints are kept, and no temporary files are left behind.
+
+	for ( int step = 1; step <= NUM_STEPS; step++ )
+	{
+		std::ifstream	file( CheckpointPath( step ).c_str() );
+		std::ifstream	tempFile( ( CheckpointPath( step ) + ".tmp" ).c_str() );
+
+		assert( file.is_open() == ( step > NUM_STEPS - NUM_KEPT ) );
+		assert( !tempFile.is_open() );
+	}
+
+	// The newest checkpoint reads back as it was saved.
+
+	Checkpointer				reader( prefix, NUM_KEPT );
+	MultilayerFeedForward		restored( NUM_INPUTS, NUM_HIDDEN, NUM_OUTPUTS );
+	Checkpointer::TrainingState	state;
+
+	bool	restoredOk	= reader.Restore( restored, state );
+
+	assert( restoredOk );
+	assert( state.step == NUM_STEPS && state.rate == 0.5f / float( NUM_STEPS ) );
+	assert( restored.GetWeights() == aSnapshots[NUM_STEPS - 1].GetWeights() );
+
+	// A checkpoint whose contents have changed fails its checksum, so the one before it is restored instead.
+
+	std::string	contents;
+
+	{
+		std::ifstream		in( CheckpointPath( NUM_STEPS ).c_str(), std::ios::binary );
+		std::ostringstream	buffer;
+
+		buffer << in.rdbuf();
+		contents = buffer.str();
+	}
+
+	size_t const	lastDigit	= contents.find_last_of( "0123456789" );
+
+	contents[lastDigit] = ( contents[lastDigit] == '1' ) ? '2' : '1';
+
+	{
+		std::ofstream	out( CheckpointPath( NUM_STEPS ).c_str(), std::ios::binary );
+
+		out << contents;
+	}
+
+	restoredOk = reader.Restore( restored, state );
+
+	assert( restoredOk );
+	assert( state.step == NUM_STEPS - 1 && state.rate == 0.5f / float( NUM_STEPS - 1 ) );
+	assert( restored.GetWeights() == aSnapshots[NUM_STEPS - 2].GetWeights() );
+
+	// Nothing is restored if no checkpoint is intact.
+
+	{
+		std::ofstream	out( CheckpointPath( NUM_STEPS - 1 ).c_str(), std::ios::binary );
+
+		out << contents.substr( 0, contents.size() / 2 );
+	}
+
+	restoredOk = reader.Restore( restored, state );
+
+	assert( !restoredOk );
+
+	for ( int step = 1; step <= NUM_STEPS; step++ )
+	{
+		std::remove( CheckpointPath( step ).c_str() );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/*																													*/
+/********************************************************************************************************************/
+
+static void TestSpscRing()
+{
+	int const	N	= 100000;
+
+	// Values come out in the order they went in. Push() fails when the ring is full and Pop() fails when it is
+	// empty.
+
+	SpscRing< int >	ring( 4 );
+	int				value;
+	bool			ok;
+
+	assert( ring.GetCapacity() == 4 );
+
+	ok = ring.Pop( value );
+	assert( !ok );
+
+	for ( int i = 0; i < 4; i++ )
+	{
+		ok = ring.Push( i );
+		assert( ok );
+	}
+
+	ok = ring.Push( 4 );
+	assert( !ok );
+
+	for ( int i = 0; i < 4; i++ )
+	{
+		ok = ring.Pop( value );
+		assert( ok && value == i );
+	}
+
+	ok = ring.Pop( value );
+	assert( !ok );
+
+	// The order is kept when a producer and a consumer run concurrently and keep wrapping around the ring.
+
+	SpscRing< int >	shared( 64 );
+
+	std::thread	producer( [&shared] ()
+	{
+		for ( int i = 0; i < N; i++ )
+		{
+			while ( !shared.Push( i ) )
+			{
+				std::this_thread::yield();
+			}
+		}
+	} );
+
+	for ( int i = 0; i < N; i++ )
+	{
+		while ( !shared.Pop( value ) )
+		{
+			std::this_thread::yield();
+		}
+		assert( value == i );
+	}
+
+	producer.join();
+
+	ok = shared.Pop( value );
+	assert( !ok );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/*																													*/
+/********************************************************************************************************************/
+
+static void TestMetricsStream()
+{
+	int const	STEPS_PER_SUMMARY	= 10;
+
+	// Every step is summarized when none are dropped, including a final partial summary.
+
+	{
+		std::vector< MetricsStream::Summary >	aSummaries;
+
+		{
+			MetricsStream	stream( [&aSummaries] ( MetricsStream::Summary const & summary )
+			{
+				aSummaries.push_back( summary );
+			}, STEPS_PER_SUMMARY );
+
+			for ( int step = 0; step < 25; step++ )
+			{
+				MetricsStream::Stats	stats;
+				stats.loss				= float( step );
+				stats.gradientNorm		= float( 2 * step );
+				stats.updateMagnitude	= 1.f;
+				stats.saturation		= 0.5f;
+
+				stream.Publish( stats );
+			}
+		}
+
+		assert( aSummaries.size() == 3 );
+
+		for ( int s = 0; s < 3; s++ )
+		{
+			MetricsStream::Summary const &	summary		= aSummaries[s];
+			int const						firstStep	= s * STEPS_PER_SUMMARY;
+			int const						lastStep	= std::min( firstStep + STEPS_PER_SUMMARY, 25 ) - 1;
+
+			assert( summary.firstStep == firstStep && summary.lastStep == lastStep );
+			assert( summary.nSteps == lastStep - firstStep + 1 && summary.nDropped == 0 );
+			assert( summary.meanLoss == float( firstStep + lastStep ) / 2.f );
+			assert( summary.maxLoss == float( lastStep ) );
+			assert( summary.meanGradientNorm == float( firstStep + lastStep ) );
+			assert( summary.maxGradientNorm == float( 2 * lastStep ) );
+			assert( summary.meanUpdateMagnitude == 1.f && summary.meanSaturation == 0.5f );
+		}
+	}
+
+	// When the statistics are published faster than they are taken from a small ring, some are dropped, but every
+	// step is accounted for exactly once.
+
+	{
+		int const	NUM_STEPS	= 100000;
+
+		std::vector< MetricsStream::Summary >	aSummaries;
+
+		{
+			MetricsStream	stream( [&aSummaries] ( MetricsStream::Summary const & summary )
+			{
+				aSummaries.push_back( summary );
+			}, 1000, 2 );
+
+			for ( int step = 0; step < NUM_STEPS; step++ )
+			{
+				stream.Publish( MetricsStream::Stats() );
+			}
+		}
+
+		long long	nextStep	= 0;
+
+		for ( size_t s = 0; s < aSummaries.size(); s++ )
+		{
+			MetricsStream::Summary const &	summary	= aSummaries[s];
+
+			assert( summary.firstStep == nextStep );
+			assert( summary.lastStep - summary.firstStep + 1 == summary.nSteps + summary.nDropped );
+			nextStep = summary.lastStep + 1;
+		}
+
+		assert( nextStep == NUM_STEPS );
+	}
+
+	assert( MetricsStream::IsSaturated( 0.001f ) && MetricsStream::IsSaturated( 0.999f ) );
+	assert( !MetricsStream::IsSaturated( 0.5f ) );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/*																													*/
+/********************************************************************************************************************/
+
+static void TestValidator()
+{
+	int const	NUM_INPUTS	= 10;
+	int const	NUM_HIDDEN	= 40;
+	int const	NUM_OUTPUTS	= 3;
+	int const	NUM_SAMPLES	= 2000;
+	int const	NUM_STEPS	= 10;
+
+	// Returns the contents of a file.
+
+	auto const	ReadFile	= [] ( std::string const & path ) -> std::string
+	{
+		std::ifstream		in( path.c_str() );
+		std::ostringstream	buffer;
+
+		buffer << in.rdbuf();
+		return buffer.str();
+	};
+
+	NeuralNet::InputBatch	aInputs( NUM_SAMPLES, Neuron::InputVector( NUM_INPUTS ) );
+	NeuralNet::OutputBatch	aTargets( NUM_SAMPLES, NeuralNet::OutputVector( NUM_OUTPUTS, 0.f ) );
+
+	for ( int i = 0; i < NUM_SAMPLES; i++ )
+	{
+		for ( int j = 0; j < NUM_INPUTS; j++ )
+		{
+			aInputs[i][j] = float( rnd.Get() & 0xffff ) / 65536.f - 0.5f;
+		}
+		aTargets[i][( aInputs[i][0] > 0.f ) ? 1 : 0] = 1.f;
+	}
+
+	// Each snapshot gets the score of the net at the step it was made, and the best snapshot is kept.
+
+	{
+		MultilayerFeedForward	net( NUM_INPUTS, NUM_HIDDEN, NUM_OUTPUTS );
+		ThreadPool				pool( 4 );
+		Validator				validator( aInputs, aTargets, Validator::MEAN_SQUARED_ERROR, 2, 0, &pool );
+		float					bestScore	= std::numeric_limits< float >::max();
+		long long				bestStep	= -1;
+
+		assert( validator.GetBest() == 0 && validator.GetBestResult().step == -1 );
+
+		for ( long long step = 1; step <= NUM_STEPS; step++ )
+		{
+			net.Train( aInputs[step], NeuralNet::ErrorVector( aTargets[step].begin(), aTargets[step].end() ), 0.5f );
+
+			bool const	stop	= validator.Validate( net, step );
+
+			assert( !stop );
+			validator.Wait();
+
+			if ( step % 2 == 0 )
+			{
+				float const	score	= validator.Score( net );
+
+				assert( validator.GetLatestResult().step == step && validator.GetLatestResult().score == score );
+
+				if ( score < bestScore )
+				{
+					bestScore	= score;
+					bestStep	= step;
+				}
+			}
+		}
+
+		assert( validator.GetBestResult().step == bestStep && validator.GetBestResult().score == bestScore );
+		assert( validator.Score( *validator.GetBest() ) == bestScore );
+		assert( validator.GetSkippedCount() == 0 );
+	}
+
+	// Training should stop once the score has not improved for the number of validations given by the patience.
+
+	{
+		int const	PATIENCE	= 3;
+
+		MultilayerFeedForward	net( NUM_INPUTS, NUM_HIDDEN, NUM_OUTPUTS );
+		Validator				validator( aInputs, aTargets, Validator::CLASSIFICATION_ERROR, 1, PATIENCE );
+
+		for ( int step = 1; step <= PATIENCE; step++ )
+		{
+			validator.Validate( net, step );
+			validator.Wait();
+			assert( !validator.ShouldStop() );
+		}
+
+		validator.Validate( net, PATIENCE + 1 );
+		validator.Wait();
+
+		bool const	stop	= validator.Validate( net, PATIENCE + 2 );
+
+		assert( validator.ShouldStop() && stop );
+		assert( validator.GetBestResult().step == 1 );
+	}
+
+	// A snapshot waiting to be validated is skipped when a newer one is made, but the newest is always validated.
+
+	{
+		MultilayerFeedForward	net( NUM_INPUTS, NUM_HIDDEN, NUM_OUTPUTS );
+		Validator				validator( aInputs, aTargets );
+
+		for ( int step = 1; step <= 100; step++ )
+		{
+			validator.Validate( net, step );
+		}
+
+		validator.Wait();
+
+		assert( validator.GetSkippedCount() > 0 && validator.GetSkippedCount() < 100 );
+		assert( validator.GetLatestResult().step == 100 );
+	}
+
+	// A snapshot stops using the net's thread pool without choosing new kernels, so nothing is tuned on the training
+	// thread.
+
+	{
+		std::string const	path	= "validator_test.tune";
+
+		std::remove( path.c_str() );
+
+		ThreadPool				pool( 4 );
+		Autotuner				autotuner( path );
+		MultilayerFeedForward	net( NUM_INPUTS, NUM_HIDDEN, NUM_OUTPUTS );
+		Validator				validator( aInputs, aTargets );
+
+		net.SetThreadPool( &pool, 0 );
+		net.SetAutotuner( &autotuner );
+
+		bool				saved	= autotuner.Save();
+		std::string const	tuned	= ReadFile( path );
+
+		assert( saved );
+
+		validator.Validate( net, 1 );
+		validator.Wait();
+
+		saved = autotuner.Save();
+
+		assert( saved && ReadFile( path ) == tuned );
+
+		std::remove( path.c_str() );
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/*																													*/
+/********************************************************************************************************************/
+
+static void TestActivationCache()
+{
+	int const	NUM_INPUTS	= 12;
+	int const	NUM_HIDDEN	= 20;
+	int const	NUM_OUTPUTS	= 4;
+	int const	NUM_SAMPLES	= 300;
+	int const	NUM_EPOCHS	= 3;
+
+	NeuralNet::InputBatch	aInputs( NUM_SAMPLES, Neuron::InputVector( NUM_INPUTS ) );
+	NeuralNet::OutputBatch	aTargets( NUM_SAMPLES, NeuralNet::OutputVector( NUM_OUTPUTS ) );
+
+	for ( int i = 0; i < NUM_SAMPLES; i++ )
+	{
+		for ( int j = 0; j < NUM_INPUTS; j++ )
+		{
+			aInputs[i][j] = float( rnd.Get() & 0xffff ) / 65536.f - 0.5f;
+		}
+		for ( int k = 0; k < NUM_OUTPUTS; k++ )
+		{
+			aTargets[i][k] = float( aInputs[i][k] > 0.f );
+		}
+	}
+
+	MultilayerFeedForward	trained( NUM_INPUTS, NUM_HIDDEN, NUM_OUTPUTS );
+	MultilayerFeedForward	cached( trained );
+	Neuron::WeightVector	aInitialWeights	= trained.GetWeights();
+	size_t const			nHiddenWeights	= (size_t)NUM_INPUTS * NUM_HIDDEN;
+	NeuralNet::ErrorVector	aErrors( NUM_OUTPUTS );
+
+	trained.SetFrozen( MultilayerFeedForward::HIDDEN_LAYER, true );
+	cached.SetFrozen( MultilayerFeedForward::HIDDEN_LAYER, true );
+	assert( trained.IsFrozen( MultilayerFeedForward::HIDDEN_LAYER ) );
+	assert( !trained.IsFrozen( MultilayerFeedForward::OUTPUT_LAYER ) );
+
+	// The cached outputs are the outputs of the hidden units, whether they are held in memory or in a file.
+
+	std::string const	path	= "activation_cache_test.bin";
+
+	std::remove( path.c_str() );
+
+	ActivationCache	cache;
+	ThreadPool		pool( 4 );
+	bool			ok;
+
+	ok = cache.Open( cached, aInputs, path );
+	assert( !ok );
+
+	ok = cache.Build( cached, aInputs );
+	assert( ok && cache.GetCount() == NUM_SAMPLES && cache.GetWidth() == NUM_HIDDEN );
+
+	std::vector< float > const	aInMemory( cache.Get( 0 ), cache.Get( 0 ) + NUM_SAMPLES * NUM_HIDDEN );
+
+	ok = cache.Build( cached, aInputs, path, &pool );
+	assert( ok && cache.GetCount() == NUM_SAMPLES && cache.GetWidth() == NUM_HIDDEN );
+	assert( std::equal( aInMemory.begin(), aInMemory.end(), cache.Get( 0 ) ) );
+
+	for ( int i = 0; i < NUM_SAMPLES; i++ )
+	{
+		NeuralNet::OutputVector	aHiddenOutputs;
+
+		cached.EvaluateHidden( aInputs[i], aHiddenOutputs );
+		assert( std::equal( aHiddenOutputs.begin(), aHiddenOutputs.end(), cache.Get( i ) ) );
+	}
+
+	// Training the output layer from the cache gives exactly the same weights as training the net with its hidden
+	// layer frozen, and the hidden weights do not change.
+
+	for ( int epoch = 0; epoch < NUM_EPOCHS; epoch++ )
+	{
+		for ( int i = 0; i < NUM_SAMPLES; i++ )
+		{
+			NeuralNet::OutputVector const	aOutputs	= trained( aInputs[i] );
+
+			for ( int k = 0; k < NUM_OUTPUTS; k++ )
+			{
+				aErrors[k] = aTargets[i][k] - aOutputs[k];
+			}
+			trained.Train( aInputs[i], aErrors, 0.5f );
+		}
+
+		for ( int i = 0; i < NUM_SAMPLES; i++ )
+		{
+			NeuralNet::OutputVector const	aOutputs	= cached.EvaluateFromHidden( cache.Get( i ) );
+
+			for ( int k = 0; k < NUM_OUTPUTS; k++ )
+			{
+				aErrors[k] = aTargets[i][k] - aOutputs[k];
+			}
+			cached.TrainOutputs( aErrors, 0.5f );
+		}
+	}
+
+	Neuron::WeightVector const	aTrainedWeights	= trained.GetWeights();
+
+	assert( cached.GetWeights() == aTrainedWeights );
+	assert( std::equal( aInitialWeights.begin(), aInitialWeights.begin() + nHiddenWeights, aTrainedWeights.begin() ) );
+	assert( !std::equal( aInitialWeights.begin() + nHiddenWeights, aInitialWeights.end(),
+						 aTrainedWeights.begin() + nHiddenWeights ) );
+
+	// The file is reused for the same hidden layer and data set, but not if either has changed.
+
+	cache.Close();
+
+	ok = cache.Open( cached, aInputs, path );
+	assert( ok && std::equal( aInMemory.begin(), aInMemory.end(), cache.Get( 0 ) ) );
+
+	NeuralNet::InputBatch	aOtherInputs( aInputs );
+
+	aOtherInputs[NUM_SAMPLES / 2][0] += 1.f;
+	ok = cache.Open( cached, aOtherInputs, path );
+	assert( !ok && cache.GetCount() == 0 );
+
+	ok = cache.Open( cached, NeuralNet::InputBatch( aInputs.begin(), aInputs.end() - 1 ), path );
+	assert( !ok );
+
+	MultilayerFeedForward	other( cached );
+	Neuron::WeightVector	aOtherWeights	= cached.GetWeights();
+
+	aOtherWeights[0] += 1.f;
+	other.SetWeights( aOtherWeights );
+	ok = cache.Open( other, aInputs, path );
+	assert( !ok );
+
+	// A frozen output layer is not trained either.
+
+	trained.SetFrozen( MultilayerFeedForward::HIDDEN_LAYER, false );
+	trained.SetFrozen( MultilayerFeedForward::OUTPUT_LAYER, true );
+
+	NeuralNet::OutputVector const	aOutputs	= trained( aInputs[0] );
+
+	for ( int k = 0; k < NUM_OUTPUTS; k++ )
+	{
+		aErrors[k] = aTargets[0][k] - aOutputs[k];
+	}
+	trained.Train( aInputs[0], aErrors, 0.5f );
+
+	Neuron::WeightVector const	aFinalWeights	= trained.GetWeights();
+
+	assert( !std::equal( aTrainedWeights.begin(), aTrainedWeights.begin() + nHiddenWeights, aFinalWeights.begin() ) );
+	assert( std::equal( aTrainedWeights.begin() + nHiddenWeights, aTrainedWeights.end(),
+						aFinalWeights.begin() + nHiddenWeights ) );
+
+	std::remove( path.c_str() );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/*																													*/
+/********************************************************************************************************************/
+
+static void TestInferencePipeline()
+{
+	int const	NUM_INPUTS	= 32;
+	int const	NUM_HIDDEN	= 24;
+	int const	NUM_OUTPUTS	= 8;
+	int const	CAPACITY	= 8;
+	int const	NUM_SAMPLES	= 5000;
+
+	MultilayerFeedForward	net( NUM_INPUTS, NUM_HIDDEN, NUM_OUTPUTS );
+	NeuralNet::InputBatch	aInputs( NUM_SAMPLES, Neuron::InputVector( NUM_INPUTS ) );
+	NeuralNet::OutputBatch	aExpected( NUM_SAMPLES );
+	Neuron::WeightVector	aWeights	= net.GetWeights();
+
+	for ( int i = 0; i < (int)aWeights.size(); i++ )
+	{
+		aWeights[i] = float( rnd.Get() & 0xffff ) / 65536.f - 0.5f;
+	}
+	net.SetWeights( aWeights );
+
+	for ( int i = 0; i < NUM_SAMPLES; i++ )
+	{
+		for ( int j = 0; j < NUM_INPUTS; j++ )
+		{
+			aInputs[i][j] = float( rnd.Get() & 0xffff ) / 65536.f - 0.5f;
+		}
+		net.Evaluate( aInputs[i], aExpected[i] );
+	}
+
+	InferencePipeline		pipeline( net, CAPACITY );
+	NeuralNet::OutputVector	aOutputs;
+	bool					ok;
+
+	assert( pipeline.GetCapacity() == CAPACITY );
+
+	// Pop() fails when there are no outputs, and Push() fails when every slot is in use.
+
+	ok = pipeline.Pop( aOutputs );
+	assert( !ok );
+
+	for ( int i = 0; i < CAPACITY; i++ )
+	{
+		ok = pipeline.Push( aInputs[i] );
+		assert( ok );
+	}
+
+	ok = pipeline.Push( aInputs[CAPACITY] );
+	assert( !ok );
+
+	// The outputs come out in the order the inputs went in, and they are the outputs of Evaluate().
+
+	for ( int i = 0; i < CAPACITY; i++ )
+	{
+		while ( !pipeline.Pop( aOutputs ) )
+		{
+			std::this_thread::yield();
+		}
+		assert( aOutputs == aExpected[i] );
+	}
+
+	ok = pipeline.Pop( aOutputs );
+	assert( !ok );
+
+	// The same holds for a stream of inputs from another thread, which keeps the pipeline full.
+
+	std::thread	producer( [&pipeline, &aInputs] ()
+	{
+		for ( int i = 0; i < NUM_SAMPLES; i++ )
+		{
+			while ( !pipeline.Push( aInputs[i] ) )
+			{
+				std::this_thread::yield();
+			}
+		}
+	} );
+
+	for ( int i = 0; i < NUM_SAMPLES; i++ )
+	{
+		while ( !pipeline.Pop( aOutputs ) )
+		{
+			std::this_thread::yield();
+		}
+		assert( aOutputs == aExpected[i] );
+	}
+
+	producer.join();
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/*																													*/
+/********************************************************************************************************************/
+
+static void TestAutotuner()
+{
+	std::string const	path	= "autotuner_test.tune";
+
+	std::remove( path.c_str() );
+
+	auto const	same	= [] ( KernelConfig const & a, KernelConfig const & b )
+	{
+		return a.unroll == b.unroll && a.unitBlock == b.unitBlock && a.tileSize == b.tileSize;
+	};
+
+	// The tuned configurations are saved and reloaded by another autotuner using the same file.
+
+	ThreadPool		pool( 3 );
+	KernelConfig	serial;
+	KernelConfig	parallel;
+
+	{
+		Autotuner	autotuner( path );
+
+		serial		= autotuner.Get( 16, 64 );
+		parallel	= autotuner.Get( 64, 128, &pool );
+
+		assert( serial.IsValid() && parallel.IsValid() );
+
+		bool const	saved	= autotuner.Save();
+
+		assert( saved );
+	}
+
+	{
+		Autotuner	autotuner( path );
+
+		autotuner.SetTuning( false );
+		assert( same( autotuner.Get( 16, 64 ), serial ) );
+		assert( same( autotuner.Get( 64, 128, &pool ), parallel ) );
+	}
+
+	std::remove( path.c_str() );
+
+	// A shape that has not been tuned gets the default configuration when tuning is disabled.
+
+	{
+		Autotuner	autotuner;
+
+		autotuner.SetTuning( false );
+		assert( !autotuner.IsTuning() );
+		assert( same( autotuner.Get( 24, 48 ), Autotuner::GetDefault( 24, 48 ) ) );
+	}
+
+	// The sums computed with a tuned configuration match Neuron::Input(), apart from the order of the additions.
+
+	{
+		int const	NUM_UNITS	= 12;
+		int const	NUM_INPUTS	= 100;
+
+		Autotuner				autotuner;
+		KernelConfig const		config	= autotuner.Get( NUM_UNITS, NUM_INPUTS );
+		std::vector< Neuron >	aUnits;
+		Neuron::InputVector		aInputs( NUM_INPUTS );
+		std::vector< float >	aSums( NUM_UNITS );
+
+		for ( int j = 0; j < NUM_UNITS; j++ )
+		{
+			Neuron::WeightVector	aWeights( NUM_INPUTS );
+
+			for ( int i = 0; i < NUM_INPUTS; i++ )
+			{
+				aWeights[i] = float( int( rnd.Get() & 0xff ) - 128 ) / 256.f;
+			}
+			aUnits.push_back( Neuron( aWeights ) );
+		}
+
+		for ( int i = 0; i < NUM_INPUTS; i++ )
+		{
+			aInputs[i] = float( rnd.Get() & 0xff ) / 256.f;
+		}
+
+		ComputeSums( config, aUnits.data(), NUM_UNITS, aInputs.data(), aSums.data() );
+
+		for ( int j = 0; j < NUM_UNITS; j++ )
+		{
+			assert( std::fabs( aSums[j] - aUnits[j].Input( aInputs ) ) < 1.e-4f );
+		}
+	}
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/*																													*/
+/********************************************************************************************************************/
+
+static void TestCopyOnWrite()
+{
+	int const	NUM_INPUTS	= 4;
+	int const	NUM_HIDDEN	= 3;
+	int const	NUM_OUTPUTS	= 2;
+
+	Neuron::WeightVector	aWeights( ( NUM_INPUTS + NUM_OUTPUTS ) * NUM_HIDDEN );
+	Neuron::InputVector		aInputs( NUM_INPUTS );
+	NeuralNet::ErrorVector	aErrors( NUM_OUTPUTS, 0.25f );
+
+	for ( size_t i = 0; i < aWeights.size(); i++ )
+	{
+		aWeights[i] = float( int( rnd.Get() & 0xff ) - 128 ) / 256.f;
+	}
+
+	for ( int j = 0; j < NUM_INPUTS; j++ )
+	{
+		aInputs[j] = float( rnd.Get() & 0xff ) / 256.f;
+	}
+
+	// A copy of a MultilayerFeedForward shares the weights of each unit until it is trained.
+
+	{
+		MultilayerFeedForward		original( NUM_INPUTS, NUM_HIDDEN, NUM_OUTPUTS, aWeights );
+		Neuron::WeightVector const	aOriginalWeights	= original.GetWeights();
+		MultilayerFeedForward		copy( original );
+
+		assert( copy.GetHiddenUnit( 0 ).GetWeights().data() == original.GetHiddenUnit( 0 ).GetWeights().data() );
+		assert( copy.GetOutputUnit( 0 ).GetWeights().data() == original.GetOutputUnit( 0 ).GetWeights().data() );
+
+		copy( aInputs );
+		copy.Train( aInputs, aErrors, 0.5f );
+
+		assert( original.GetWeights() == aOriginalWeights );
+		assert( copy.GetWeights() != aOriginalWeights );
+		assert( copy.GetHiddenUnit( 0 ).GetWeights().data() != original.GetHiddenUnit( 0 ).GetWeights().data() );
+		assert( copy.GetOutputUnit( 0 ).GetWeights().data() != original.GetOutputUnit( 0 ).GetWeights().data() );
+
+		// A moved-from net can be assigned again.
+
+		MultilayerFeedForward	moved( std::move( copy ) );
+
+		copy = original;
+		assert( copy.GetWeights() == aOriginalWeights );
+		assert( copy( aInputs ) == original( aInputs ) );
+	}
+
+	// The same goes for a Perceptron.
+
+	{
+		int const					nWeights			= ( NUM_INPUTS + 1 ) * NUM_OUTPUTS;
+		Perceptron					original( NUM_INPUTS, NUM_OUTPUTS,
+											  Neuron::WeightVector( aWeights.begin(), aWeights.begin() + nWeights ) );
+		Neuron::WeightVector const	aOriginalWeights	= original.GetWeights();
+		Perceptron					copy( original );
+
+		assert( copy.GetOutputUnit( 0 ).GetWeights().data() == original.GetOutputUnit( 0 ).GetWeights().data() );
+
+		copy( aInputs );
+		copy.Train( aInputs, aErrors, 0.5f );
+
+		assert( original.GetWeights() == aOriginalWeights );
+		assert( copy.GetWeights() != aOriginalWeights );
+		assert( copy.GetOutputUnit( 0 ).GetWeights().data() != original.GetOutputUnit( 0 ).GetWeights().data() );
+
+		Perceptron	moved( std::move( copy ) );
+
+		copy = original;
+		assert( copy.GetWeights() == aOriginalWeights );
+		assert( copy( aInputs ) == original( aInputs ) );
+	}
+}
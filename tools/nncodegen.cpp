@@ -0,0 +1,119 @@
+/** @file *//********************************************************************************************************
+
+                                                    nncodegen.cpp
+
+						                    Copyright 2026, John J. Bolton
+	--------------------------------------------------------------------------------------------------------------
+
+	$Header: //depot/Libraries/NeuralNet/Tools/nncodegen.cpp#1 $
+
+	$NoKeywords: $
+
+ ********************************************************************************************************************/
+
+//! Converts a serialized net into a C++ header that evaluates it.
+//
+//! Usage: nncodegen perceptron|mff <model file> <name> [<output file>]
+//!
+//! The header is written to the output file, or to standard output if no output file is given. See
+//! GenerateHeader() for a description of the generated code.
+
+#include "NeuralNet/CodeGenerator.h"
+#include "NeuralNet/MultilayerFeedForward.h"
+#include "NeuralNet/Perceptron.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+//! @param	in		The stream containing the serialized net.
+//! @param	out		The stream to write the header to.
+//! @param	name	The name of the namespace containing the generated code.
+//!
+//! @return		True if the net was read and its header was written.
+
+template< class Net >
+static bool Generate( std::istream & in, std::ostream & out, std::string const & name )
+{
+	Net	net;
+
+	in >> net;
+	if ( !in )
+	{
+		return false;
+	}
+
+	return GenerateHeader( out, net, name );
+}
+
+
+/********************************************************************************************************************/
+/*																													*/
+/********************************************************************************************************************/
+
+int main( int argc, char ** argv )
+{
+	if ( argc < 4 || argc > 5 )
+	{
+		std::cerr << "usage: nncodegen perceptron|mff <model file> <name> [<output file>]" << std::endl;
+		return 2;
+	}
+
+	std::string const	type	= argv[1];
+	std::string const	name	= argv[3];
+
+	if ( type != "perceptron" && type != "mff" )
+	{
+		std::cerr << "nncodegen: unknown type \"" << type << "\"" << std::endl;
+		return 2;
+	}
+
+	if ( !IsValidName( name ) )
+	{
+		std::cerr << "nncodegen: \"" << name << "\" is not a valid C++ identifier" << std::endl;
+		return 2;
+	}
+
+	std::ifstream	in( argv[2] );
+	if ( !in )
+	{
+		std::cerr << "nncodegen: cannot open \"" << argv[2] << "\"" << std::endl;
+		return 1;
+	}
+
+	// Generate into memory first so that a failure doesn't leave a partial output file.
+
+	std::ostringstream	header;
+	bool const			ok		= ( type == "perceptron" ) ? Generate< Perceptron >( in, header, name )
+														   : Generate< MultilayerFeedForward >( in, header, name );
+	if ( !ok )
+	{
+		std::cerr << "nncodegen: cannot read a " << type << " with finite weights from \"" << argv[2] << "\""
+				  << std::endl;
+		return 1;
+	}
+
+	if ( argc == 5 )
+	{
+		std::ofstream	out( argv[4] );
+
+		out << header.str();
+		if ( !out.flush() )
+		{
+			std::cerr << "nncodegen: cannot write \"" << argv[4] << "\"" << std::endl;
+			return 1;
+		}
+	}
+	else
+	{
+		std::cout << header.str();
+	}
+
+	return 0;
+}